@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <imgui.h>
+#include <string>
+#include <vector>
+#include "GUI/Scene.h"
+#include "GUI/gui.h"
+#include "Simulation/Conjunction.h"
+#include "core/thread_pool.h"
+
+namespace gui {
+
+namespace {
+
+struct ConjunctionState {
+  sim::ConjunctionSpec spec;
+
+  std::future<sim::ConjunctionReport> pending;
+  sim::ConjunctionReport report;
+  // Names of the mesh objects at the time of the run; later indices are bulk bodies.
+  std::vector<std::string> objectNames;
+  std::size_t bodyCount = 0;
+  double lastRunSeconds = 0.0;
+};
+
+ConjunctionState conjunctionState;
+
+std::string BodyLabel(const ConjunctionState &state, std::uint32_t index) {
+  if (index < state.objectNames.size()) {
+    return state.objectNames[index];
+  }
+  return "Body " + std::to_string(index - state.objectNames.size());
+}
+
+void StartScreening(ConjunctionState &state, const Scene &scene) {
+  state.spec.mu = scene.getCentralMu();
+  state.objectNames = scene.getObjectNames();
+  sim::BodyStorage bodies = scene.collectBodies();
+  state.bodyCount = bodies.size();
+
+  state.pending = std::async(std::launch::async, [&state, bodies = std::move(bodies),
+                                                  spec = state.spec] {
+    const auto start = std::chrono::steady_clock::now();
+    sim::ConjunctionReport report = sim::screenConjunctions(bodies, spec, getThreadPool());
+    state.lastRunSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+  });
+}
+
+} // namespace
+
+void ConjunctionWindow(bool *open) {
+  auto &state = conjunctionState;
+  Scene &scene = getScene();
+
+  if (state.pending.valid() &&
+      state.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+    state.report = state.pending.get();
+  }
+  const bool running = state.pending.valid();
+  if (running) {
+    RequestRedraw();
+  }
+
+  ImGui::Begin("Conjunction Screening", open);
+
+  ImGui::BeginDisabled(running);
+  CentralMassControl(scene);
+  auto &spec = state.spec;
+  ImGui::InputDouble("Start Time", &spec.startTime, 0.0, 0.0, "%.3f");
+  ImGui::InputDouble("End Time", &spec.endTime, 0.0, 0.0, "%.3f");
+  ImGui::InputDouble("Sample Step", &spec.sampleStep, 0.0, 0.0, "%.4f");
+  ImGui::SameLine();
+  HelpMarker("Trajectories are sampled at this interval for the broad phase. Shorter steps "
+             "give tighter bounds and fewer false candidates.");
+  ImGui::InputDouble("Threshold", &spec.threshold, 0.0, 0.0, "%.5f");
+  ImGui::SameLine();
+  HelpMarker("Report every pass closer than this distance");
+  spec.sampleStep = std::max(spec.sampleStep, 1.0e-6);
+  spec.threshold = std::max(spec.threshold, 0.0);
+
+  if (ImGui::Button("Screen", ImVec2(ImGui::GetContentRegionAvail().x, 0))) {
+    StartScreening(state, scene);
+  }
+  ImGui::EndDisabled();
+
+  if (running) {
+    ImGui::Text("Screening %zu bodies...", state.bodyCount);
+    ImGui::End();
+    return;
+  }
+
+  const auto &conjunctions = state.report.conjunctions;
+  if (state.report.samples > 0) {
+    ImGui::Text("%zu bodies, %zu samples, %zu candidates refined in %.2f s", state.bodyCount,
+                state.report.samples, state.report.candidatePairs, state.lastRunSeconds);
+    ImGui::Text("%zu conjunctions", conjunctions.size());
+  }
+
+  constexpr ImGuiTableFlags flags =
+      ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY;
+  if (!conjunctions.empty() && ImGui::BeginTable("Conjunctions", 5, flags)) {
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Body A");
+    ImGui::TableSetupColumn("Body B");
+    ImGui::TableSetupColumn("Time");
+    ImGui::TableSetupColumn("Distance");
+    ImGui::TableSetupColumn("Rel. Speed");
+    ImGui::TableHeadersRow();
+
+    // Debris runs can report many thousands of passes; only lay out the visible rows.
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(conjunctions.size()));
+    while (clipper.Step()) {
+      for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+        const auto &conjunction = conjunctions[row];
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(BodyLabel(state, conjunction.first).c_str());
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(BodyLabel(state, conjunction.second).c_str());
+        ImGui::TableNextColumn();
+        ImGui::Text("%.4f", conjunction.time);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.5f", conjunction.distance);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.4f", conjunction.relativeSpeed);
+      }
+    }
+    ImGui::EndTable();
+  }
+
+  ImGui::End();
+}
+
+void WaitConjunctionJob() {
+  if (conjunctionState.pending.valid()) {
+    conjunctionState.pending.wait();
+  }
+}
+
+} // namespace gui
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <future>
+#include <imgui.h>
+#include <memory>
+#include <random>
+#include "GUI/gui.h"
+#include "Simulation/Ensemble.h"
+#include "core/thread_pool.h"
+
+namespace gui {
+
+namespace {
+
+// Realizations are capped so a run's initial conditions and results fit in this much memory
+constexpr double ENSEMBLE_MEMORY_BUDGET = 1024.0 * 1024.0 * 1024.0;
+
+struct EnsembleState {
+  int bodyCount = 3;
+  int memberCount = 10000;
+  int seed = 1;
+  float clusterRadius = 1.0F;
+  float bodyRadius = 0.01F;
+  float positionSigma = 1.0e-3F;
+  float velocitySigma = 1.0e-3F;
+  sim::EnsembleSettings settings;
+
+  std::future<void> pending;
+  std::unique_ptr<sim::Ensemble> ensemble;
+  double lastRunSeconds = 0.0;
+  int stableCount = 0;
+  int ejectionCount = 0;
+  int collisionCount = 0;
+  double meanStabilityTime = 0.0;
+  std::vector<float> stabilityHistogram;
+};
+
+EnsembleState ensembleState;
+
+// Equal-mass bodies scattered at rest inside a sphere, the usual cold-collapse setup.
+sim::EnsembleSystem MakeColdCluster(int bodyCount, double radius, double bodyRadius,
+                                    std::uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> coordinate(-radius, radius);
+
+  sim::EnsembleSystem system;
+  for (int i = 0; i < bodyCount; ++i) {
+    glm::dvec3 position;
+    do {
+      position = glm::dvec3(coordinate(rng), coordinate(rng), coordinate(rng));
+    } while (glm::dot(position, position) > radius * radius);
+    system.positions.push_back(position);
+    system.velocities.emplace_back(0.0);
+    system.masses.push_back(1.0 / bodyCount);
+    system.radii.push_back(bodyRadius);
+  }
+  return system;
+}
+
+int MaxEnsembleMembers(int bodyCount) {
+  const auto bytes = static_cast<double>(
+      sim::Ensemble::getMemberBytes(static_cast<std::size_t>(bodyCount)));
+  return static_cast<int>(std::min(ENSEMBLE_MEMORY_BUDGET / bytes, 1.0e7));
+}
+
+// Members are generated on the background thread too; the window only reads the ensemble
+// once the run is done.
+void StartEnsembleRun() {
+  auto &state = ensembleState;
+  state.ensemble.reset();
+  state.pending = std::async(
+      std::launch::async, [&state, bodyCount = state.bodyCount, memberCount = state.memberCount,
+                           seed = state.seed, clusterRadius = state.clusterRadius,
+                           bodyRadius = state.bodyRadius, positionSigma = state.positionSigma,
+                           velocitySigma = state.velocitySigma, settings = state.settings] {
+        const auto start = std::chrono::steady_clock::now();
+        const sim::EnsembleSystem base =
+            MakeColdCluster(bodyCount, clusterRadius, bodyRadius, seed);
+        auto ensemble = std::make_unique<sim::Ensemble>(base.getBodyCount());
+        for (int m = 0; m < memberCount; ++m) {
+          ensemble->addMember(
+              sim::Ensemble::perturb(base, positionSigma, velocitySigma, seed, m));
+        }
+        ensemble->run(settings, getThreadPool());
+        state.ensemble = std::move(ensemble);
+        state.lastRunSeconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      });
+}
+
+void CollectEnsembleResults() {
+  auto &state = ensembleState;
+  state.stableCount = state.ejectionCount = state.collisionCount = 0;
+  state.stabilityHistogram.assign(32, 0.0F);
+
+  double totalTime = 0.0;
+  const auto &results = state.ensemble->getResults();
+  for (const auto &result : results) {
+    switch (result.outcome) {
+    case sim::EnsembleOutcome::Stable:
+      ++state.stableCount;
+      break;
+    case sim::EnsembleOutcome::Ejection:
+      ++state.ejectionCount;
+      break;
+    case sim::EnsembleOutcome::Collision:
+      ++state.collisionCount;
+      break;
+    }
+    totalTime += result.stabilityTime;
+
+    const double fraction = result.stabilityTime / state.settings.endTime;
+    const auto bin = std::clamp(static_cast<int>(fraction * 32.0), 0, 31);
+    state.stabilityHistogram[bin] += 1.0F;
+  }
+  state.meanStabilityTime = results.empty() ? 0.0 : totalTime / results.size();
+}
+
+} // namespace
+
+void EnsembleWindow(bool *open) {
+  auto &state = ensembleState;
+
+  if (state.pending.valid() &&
+      state.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+    state.pending.get();
+    CollectEnsembleResults();
+  }
+  const bool running = state.pending.valid();
+  if (running) {
+    RequestRedraw();
+  }
+
+  ImGui::Begin("Ensemble Runs", open);
+
+  ImGui::BeginDisabled(running);
+  ImGui::SliderInt("Bodies", &state.bodyCount, 2, static_cast<int>(sim::ENSEMBLE_MAX_BODIES));
+  const int maxMembers = MaxEnsembleMembers(state.bodyCount);
+  ImGui::DragInt("Realizations", &state.memberCount, 100.0F, 1, maxMembers);
+  state.memberCount = std::clamp(state.memberCount, 1, maxMembers);
+  ImGui::InputInt("Seed", &state.seed);
+  ImGui::SliderFloat("Cluster Radius", &state.clusterRadius, 0.1F, 10.0F);
+  ImGui::SliderFloat("Body Radius", &state.bodyRadius, 0.0F, 0.1F, "%.4f");
+  ImGui::SameLine();
+  HelpMarker("Bodies closer than the sum of their radii count as a collision");
+  ImGui::DragFloat("Position Noise", &state.positionSigma, 1.0e-4F, 0.0F, 1.0F, "%.5f");
+  ImGui::DragFloat("Velocity Noise", &state.velocitySigma, 1.0e-4F, 0.0F, 1.0F, "%.5f");
+
+  ImGui::Separator();
+  auto &settings = state.settings;
+  ImGui::InputDouble("Time Step", &settings.timeStep, 0.0, 0.0, "%.2e");
+  ImGui::InputDouble("End Time", &settings.endTime, 0.0, 0.0, "%.1f");
+  ImGui::InputDouble("Ejection Radius", &settings.ejectionRadius, 0.0, 0.0, "%.1f");
+  ImGui::InputDouble("Softening", &settings.softening, 0.0, 0.0, "%.2e");
+  settings.timeStep = std::max(settings.timeStep, 1.0e-9);
+  settings.endTime = std::max(settings.endTime, settings.timeStep);
+
+  if (ImGui::Button("Run Ensemble", ImVec2(ImGui::GetContentRegionAvail().x, 0))) {
+    StartEnsembleRun();
+  }
+  ImGui::EndDisabled();
+
+  if (running) {
+    ImGui::Text("Integrating %d realizations on %u threads...", state.memberCount,
+                getThreadPool().getThreadCount());
+  } else if (state.ensemble && !state.ensemble->getResults().empty()) {
+    const auto total = static_cast<float>(state.ensemble->getResults().size());
+    ImGui::Separator();
+    ImGui::Text("Finished in %.2f s", state.lastRunSeconds);
+    ImGui::Text("Stable:     %d (%.1f%%)", state.stableCount, 100.0F * state.stableCount / total);
+    ImGui::Text("Ejection:   %d (%.1f%%)", state.ejectionCount,
+                100.0F * state.ejectionCount / total);
+    ImGui::Text("Collision:  %d (%.1f%%)", state.collisionCount,
+                100.0F * state.collisionCount / total);
+    ImGui::Text("Mean stability time: %.3f", state.meanStabilityTime);
+    ImGui::PlotHistogram("##Stability", state.stabilityHistogram.data(),
+                         static_cast<int>(state.stabilityHistogram.size()), 0,
+                         "Stability time distribution", 0.0F, FLT_MAX, ImVec2(0, 80.0F));
+  }
+
+  ImGui::End();
+}
+
+void WaitEnsembleJob() {
+  if (ensembleState.pending.valid()) {
+    ensembleState.pending.wait();
+  }
+}
+
+} // namespace gui
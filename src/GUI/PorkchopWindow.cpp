@@ -0,0 +1,290 @@
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <imgui.h>
+#include <string>
+#include <vector>
+#include "GUI/Scene.h"
+#include "GUI/gui.h"
+#include "Simulation/Porkchop.h"
+#include "core/thread_pool.h"
+
+namespace gui {
+
+namespace {
+
+constexpr int CONTOUR_LEVELS = 10;
+
+struct ContourSegment {
+  ImVec2 a;
+  ImVec2 b;
+};
+
+struct PorkchopState {
+  int originIndex = 0;
+  int targetIndex = 1;
+  float maxDeltaVFactor = 3.0F;
+  sim::PorkchopSpec spec;
+
+  // Spec the pending or current grid was computed with.
+  sim::PorkchopSpec computedSpec;
+  std::future<sim::PorkchopGrid> pending;
+  sim::PorkchopGrid grid;
+  double lastRunSeconds = 0.0;
+  std::vector<ContourSegment> contours;
+  unsigned int texture = 0;
+};
+
+PorkchopState porkchopState;
+
+ImVec4 ColorMap(float t) {
+  // Dark blue -> cyan -> yellow -> red, a cheap stand-in for a perceptual map.
+  t = std::clamp(t, 0.0F, 1.0F);
+  if (t < 0.33F) {
+    const float u = t / 0.33F;
+    return {0.05F, 0.1F + (0.6F * u), 0.4F + (0.5F * u), 1.0F};
+  }
+  if (t < 0.66F) {
+    const float u = (t - 0.33F) / 0.33F;
+    return {0.05F + (0.9F * u), 0.7F + (0.2F * u), 0.9F - (0.8F * u), 1.0F};
+  }
+  const float u = (t - 0.66F) / 0.34F;
+  return {0.95F, 0.9F - (0.8F * u), 0.1F, 1.0F};
+}
+
+float NormalizedDeltaV(const PorkchopState &state, float deltaV) {
+  const float low = state.grid.minTotalDeltaV;
+  const float high = low * state.maxDeltaVFactor;
+  return high > low ? (deltaV - low) / (high - low) : 0.0F;
+}
+
+// Uploads the delta-v map as an RGBA texture, one texel per grid cell.
+void UploadPorkchopTexture(PorkchopState &state) {
+  const auto &grid = state.grid;
+  std::vector<unsigned char> pixels(static_cast<std::size_t>(grid.departureSteps) *
+                                    grid.flightTimeSteps * 4);
+  for (std::size_t cell = 0; cell < grid.totalDeltaV.size(); ++cell) {
+    const float deltaV = grid.totalDeltaV[cell];
+    const ImVec4 color = std::isfinite(deltaV) ? ColorMap(NormalizedDeltaV(state, deltaV))
+                                               : ImVec4(0.0F, 0.0F, 0.0F, 1.0F);
+    pixels[(cell * 4) + 0] = static_cast<unsigned char>(color.x * 255.0F);
+    pixels[(cell * 4) + 1] = static_cast<unsigned char>(color.y * 255.0F);
+    pixels[(cell * 4) + 2] = static_cast<unsigned char>(color.z * 255.0F);
+    pixels[(cell * 4) + 3] = 255;
+  }
+
+  if (state.texture == 0) {
+    glGenTextures(1, &state.texture);
+  }
+  glBindTexture(GL_TEXTURE_2D, state.texture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, grid.departureSteps, grid.flightTimeSteps, 0, GL_RGBA,
+               GL_UNSIGNED_BYTE, pixels.data());
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// Marching squares over the total delta-v field. Segment endpoints are in [0, 1] grid space
+// with y growing with time of flight.
+void BuildContours(PorkchopState &state) {
+  state.contours.clear();
+  const auto &grid = state.grid;
+  if (grid.departureSteps < 2 || grid.flightTimeSteps < 2 || grid.bestDeparture < 0) {
+    return;
+  }
+
+  const float low = grid.minTotalDeltaV;
+  const float high = low * state.maxDeltaVFactor;
+  const float sx = 1.0F / static_cast<float>(grid.departureSteps - 1);
+  const float sy = 1.0F / static_cast<float>(grid.flightTimeSteps - 1);
+
+  for (int level = 1; level <= CONTOUR_LEVELS; ++level) {
+    const float iso = low + ((high - low) * static_cast<float>(level) / (CONTOUR_LEVELS + 1));
+    for (int f = 0; f + 1 < grid.flightTimeSteps; ++f) {
+      for (int d = 0; d + 1 < grid.departureSteps; ++d) {
+        const float v[4] = {grid.totalDeltaV[grid.index(d, f)],
+                            grid.totalDeltaV[grid.index(d + 1, f)],
+                            grid.totalDeltaV[grid.index(d + 1, f + 1)],
+                            grid.totalDeltaV[grid.index(d, f + 1)]};
+        if (!std::isfinite(v[0]) || !std::isfinite(v[1]) || !std::isfinite(v[2]) ||
+            !std::isfinite(v[3])) {
+          continue;
+        }
+        const ImVec2 corner[4] = {{d * sx, f * sy},
+                                  {(d + 1) * sx, f * sy},
+                                  {(d + 1) * sx, (f + 1) * sy},
+                                  {d * sx, (f + 1) * sy}};
+
+        ImVec2 crossings[4];
+        int count = 0;
+        for (int edge = 0; edge < 4; ++edge) {
+          const int next = (edge + 1) % 4;
+          if ((v[edge] < iso) != (v[next] < iso)) {
+            const float t = (iso - v[edge]) / (v[next] - v[edge]);
+            crossings[count++] = {corner[edge].x + (t * (corner[next].x - corner[edge].x)),
+                                  corner[edge].y + (t * (corner[next].y - corner[edge].y))};
+          }
+        }
+        for (int i = 0; i + 1 < count; i += 2) {
+          state.contours.push_back({crossings[i], crossings[i + 1]});
+        }
+      }
+    }
+  }
+}
+
+void StartPorkchop(PorkchopState &state, const Scene &scene) {
+  const sim::BodyStorage bodies = scene.collectBodies();
+  const sim::OrbitState origin{bodies.position(state.originIndex),
+                               bodies.velocity(state.originIndex)};
+  const sim::OrbitState target{bodies.position(state.targetIndex),
+                               bodies.velocity(state.targetIndex)};
+
+  state.spec.mu = scene.getCentralMu();
+  state.computedSpec = state.spec;
+  state.pending = std::async(std::launch::async, [&state, origin, target, spec = state.spec] {
+    const auto start = std::chrono::steady_clock::now();
+    sim::PorkchopGrid grid = sim::computePorkchop(origin, target, spec, getThreadPool());
+    state.lastRunSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return grid;
+  });
+}
+
+bool SceneObjectCombo(const char *label, int &selected, const Scene &scene) {
+  const auto &objects = scene.getObjects();
+  selected = std::clamp(selected, 0, std::max(static_cast<int>(objects.size()) - 1, 0));
+  bool changed = false;
+  if (ImGui::BeginCombo(label, objects.empty() ? "" : objects[selected].name.c_str())) {
+    for (int i = 0; i < static_cast<int>(objects.size()); ++i) {
+      if (ImGui::Selectable(objects[i].name.c_str(), i == selected)) {
+        selected = i;
+        changed = true;
+      }
+    }
+    ImGui::EndCombo();
+  }
+  return changed;
+}
+
+void DrawPorkchopPlot(PorkchopState &state) {
+  const auto &grid = state.grid;
+  const auto &spec = state.computedSpec;
+  const float width = ImGui::GetContentRegionAvail().x;
+  const ImVec2 size(width, width * 0.75F);
+
+  // Row 0 is the shortest time of flight, so flip the texture to put it at the bottom.
+  ImGui::Image((ImTextureID)(intptr_t)state.texture, size, ImVec2(0.0F, 1.0F), ImVec2(1.0F, 0.0F));
+  const ImVec2 min = ImGui::GetItemRectMin();
+  const ImVec2 max = ImGui::GetItemRectMax();
+  const auto toScreen = [&min, &max](const ImVec2 &p) {
+    return ImVec2(min.x + (p.x * (max.x - min.x)), max.y - (p.y * (max.y - min.y)));
+  };
+
+  ImDrawList *drawList = ImGui::GetWindowDrawList();
+  for (const auto &segment : state.contours) {
+    drawList->AddLine(toScreen(segment.a), toScreen(segment.b), IM_COL32(255, 255, 255, 140));
+  }
+
+  if (grid.bestDeparture >= 0) {
+    const ImVec2 best = toScreen(
+        {static_cast<float>(grid.bestDeparture) / std::max(grid.departureSteps - 1, 1),
+         static_cast<float>(grid.bestFlightTime) / std::max(grid.flightTimeSteps - 1, 1)});
+    drawList->AddCircleFilled(best, 4.0F, IM_COL32(255, 0, 255, 255));
+  }
+
+  if (ImGui::IsItemHovered()) {
+    const ImVec2 mouse = ImGui::GetMousePos();
+    const float u = (mouse.x - min.x) / (max.x - min.x);
+    const float v = (max.y - mouse.y) / (max.y - min.y);
+    const int d = std::clamp(static_cast<int>(std::lround(u * (grid.departureSteps - 1))), 0,
+                             grid.departureSteps - 1);
+    const int f = std::clamp(static_cast<int>(std::lround(v * (grid.flightTimeSteps - 1))), 0,
+                             grid.flightTimeSteps - 1);
+    const std::size_t cell = grid.index(d, f);
+    ImGui::SetTooltip("Departure: %.3f\nTime of flight: %.3f\nDeparture dv: %.4f\n"
+                      "Arrival dv: %.4f\nTotal dv: %.4f",
+                      sim::porkchopDepartureTime(spec, d), sim::porkchopFlightTime(spec, f),
+                      grid.departureDeltaV[cell], grid.arrivalDeltaV[cell],
+                      grid.totalDeltaV[cell]);
+  }
+}
+
+} // namespace
+
+void PorkchopWindow(bool *open) {
+  auto &state = porkchopState;
+  Scene &scene = getScene();
+
+  if (state.pending.valid() &&
+      state.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+    state.grid = state.pending.get();
+    UploadPorkchopTexture(state);
+    BuildContours(state);
+  }
+  const bool running = state.pending.valid();
+  if (running) {
+    RequestRedraw();
+  }
+
+  ImGui::Begin("Porkchop Plot", open);
+
+  if (scene.getObjects().size() < 2) {
+    ImGui::TextWrapped("Add at least two objects to the scene to plan a transfer.");
+    ImGui::End();
+    return;
+  }
+
+  ImGui::BeginDisabled(running);
+  SceneObjectCombo("Departure Body", state.originIndex, scene);
+  SceneObjectCombo("Arrival Body", state.targetIndex, scene);
+  CentralMassControl(scene);
+
+  auto &spec = state.spec;
+  ImGui::InputDouble("Departure Start", &spec.departureStart, 0.0, 0.0, "%.3f");
+  ImGui::InputDouble("Departure End", &spec.departureEnd, 0.0, 0.0, "%.3f");
+  ImGui::InputDouble("Min Flight Time", &spec.flightTimeMin, 0.0, 0.0, "%.3f");
+  ImGui::InputDouble("Max Flight Time", &spec.flightTimeMax, 0.0, 0.0, "%.3f");
+  ImGui::SliderInt("Departure Steps", &spec.departureSteps, 16, 2048);
+  ImGui::SliderInt("Flight Time Steps", &spec.flightTimeSteps, 16, 2048);
+  ImGui::Checkbox("Prograde", &spec.prograde);
+  spec.flightTimeMin = std::max(spec.flightTimeMin, 1.0e-6);
+
+  const bool distinct = state.originIndex != state.targetIndex;
+  ImGui::BeginDisabled(!distinct);
+  if (ImGui::Button("Compute", ImVec2(ImGui::GetContentRegionAvail().x, 0))) {
+    StartPorkchop(state, scene);
+  }
+  ImGui::EndDisabled();
+  ImGui::EndDisabled();
+
+  if (running) {
+    ImGui::Text("Solving %d Lambert problems...",
+                state.computedSpec.departureSteps * state.computedSpec.flightTimeSteps);
+  } else if (state.texture != 0) {
+    if (ImGui::SliderFloat("Color Range", &state.maxDeltaVFactor, 1.1F, 20.0F, "x%.1f")) {
+      UploadPorkchopTexture(state);
+      BuildContours(state);
+    }
+    ImGui::Text("%d solves in %.2f s, best total dv %.4f",
+                state.grid.departureSteps * state.grid.flightTimeSteps, state.lastRunSeconds,
+                state.grid.minTotalDeltaV);
+    DrawPorkchopPlot(state);
+  }
+
+  ImGui::End();
+}
+
+void WaitPorkchopJob() {
+  if (porkchopState.pending.valid()) {
+    porkchopState.pending.wait();
+  }
+}
+
+} // namespace gui
@@ -1,4 +1,6 @@
 #include "GUI/Scene.h"
+#include "Simulation/Kepler.h"
+#include <glm/gtc/quaternion.hpp>
 
 namespace gui {
 
@@ -11,20 +13,131 @@ void Scene::addObject(const std::shared_ptr<Object3D>& obj, const std::string& n
         uniqueName = name + " " + std::to_string(suffix++);
     }
 
-    objects.push_back({uniqueName, obj, false});
+    const glm::vec3 position = obj ? obj->getPosition() : glm::vec3(0.0f);
+    const glm::vec3 rotation = obj ? obj->getRotation() : glm::vec3(0.0f);
+    const auto frame = frames.add(glm::dvec3(position), glm::dquat(glm::radians(rotation)));
+    objects.push_back({uniqueName, obj, false, frame});
+    synced.resize(frame + 1);
+    synced[frame] = {position, rotation};
+    indexFrames();
+    ++revision;
 }
 
 void Scene::removeObject(size_t index) {
     if (index < objects.size()) {
+        frames.remove(objects[index].frame);
         objects.erase(objects.begin() + index);
+        indexFrames();
+        ++revision;
     }
 }
 
 void Scene::removeObject(const std::string& name) {
+    for (const auto& obj : objects) {
+        if (obj.name == name) {
+            frames.remove(obj.frame);
+        }
+    }
     objects.erase(
         std::remove_if(objects.begin(), objects.end(),
                       [&name](const SceneObject& obj) { return obj.name == name; }),
         objects.end());
+    indexFrames();
+    ++revision;
+}
+
+void Scene::indexFrames() {
+    objectOfFrame.assign(synced.size(), objects.size());
+    for (size_t i = 0; i < objects.size(); ++i) {
+        objectOfFrame[objects[i].frame] = i;
+    }
+}
+
+bool Scene::setParent(size_t index, int parentIndex, sim::FrameType type) {
+    const auto parent = parentIndex < 0 ? sim::FrameTree::NO_PARENT
+                                        : objects[parentIndex].frame;
+    if (!frames.setParent(objects[index].frame, parent, type)) {
+        return false;
+    }
+    ++revision;
+    return true;
+}
+
+int Scene::getParentIndex(size_t index) const {
+    const auto parent = frames.getParent(objects[index].frame);
+    return parent == sim::FrameTree::NO_PARENT ? -1 : static_cast<int>(objectOfFrame[parent]);
+}
+
+sim::FrameType Scene::getFrameType(size_t index) const {
+    return frames.getFrameType(objects[index].frame);
+}
+
+glm::dvec3 Scene::getLocalPosition(size_t index) const {
+    return frames.getLocalPosition(objects[index].frame);
+}
+
+void Scene::setLocalPosition(size_t index, const glm::dvec3& position) {
+    frames.setLocalPosition(objects[index].frame, position);
+}
+
+void Scene::updateFrames() {
+    // Positions and rotations typed into the object controls are world space
+    for (const auto& obj : objects) {
+        const auto& object = obj.object;
+        if (!object) {
+            continue;
+        }
+        FrameSync& sync = synced[obj.frame];
+        if (object->getPosition() != sync.position) {
+            frames.setWorldPosition(obj.frame, glm::dvec3(object->getPosition()));
+            sync.position = object->getPosition();
+        }
+        if (object->getRotation() != sync.rotation) {
+            frames.setWorldOrientation(obj.frame, glm::dquat(object->getOrientation()));
+            sync.rotation = object->getRotation();
+        }
+    }
+
+    const auto& updated = frames.update();
+    for (const auto frame : updated) {
+        const auto& object = objects[objectOfFrame[frame]].object;
+        if (!object) {
+            continue;
+        }
+        FrameSync& sync = synced[frame];
+        sync.position = glm::vec3(frames.getWorldPosition(frame));
+        object->setPosition(sync.position);
+        // A root's orientation is exactly what was typed in, so leave its angles untouched
+        if (frames.getParent(frame) != sim::FrameTree::NO_PARENT) {
+            sync.rotation =
+                glm::degrees(glm::vec3(glm::eulerAngles(frames.getWorldOrientation(frame))));
+            object->setRotation(sync.rotation);
+        }
+    }
+    if (!updated.empty()) {
+        ++revision;
+    }
+}
+
+sim::BodyStorage Scene::collectBodies() const {
+    sim::BodyStorage state;
+    state.reserve(objects.size() + bodies.size());
+    for (const auto& obj : objects) {
+        const glm::dvec3 position(obj.object->getPosition());
+        state.add(position, sim::circularVelocity(position, centralMu), 0.0,
+                  obj.object->getBoundingRadius());
+    }
+    state.append(bodies);
+    return state;
+}
+
+std::vector<std::string> Scene::getObjectNames() const {
+    std::vector<std::string> names;
+    names.reserve(objects.size());
+    for (const auto& obj : objects) {
+        names.push_back(obj.name);
+    }
+    return names;
 }
 
 } // namespace gui
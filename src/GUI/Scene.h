@@ -1,6 +1,9 @@
 #pragma once
 
 #include "GUI/gui.h"
+#include "Simulation/BodyStorage.h"
+#include "Simulation/FrameTree.h"
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <string>
@@ -17,8 +20,52 @@ public:
     const std::vector<SceneObject>& getObjects() const { return objects; }
     std::vector<SceneObject>& getObjects() { return objects; }
 
+    // Bulk bodies that have no mesh of their own (particles, debris, generated populations).
+    sim::BodyStorage& getBodies() { return bodies; }
+    const sim::BodyStorage& getBodies() const { return bodies; }
+
+    // Gravitational parameter of the central mass at the origin.
+    double getCentralMu() const { return centralMu; }
+    void setCentralMu(double mu) { centralMu = mu; ++revision; }
+
+    // Bumped whenever bodies are added, removed or edited, so derived data such as predicted
+    // trajectories knows when to recompute. Call markChanged() after editing through a getter.
+    std::uint64_t getRevision() const { return revision; }
+    void markChanged() { ++revision; }
+
+    // Reference frames. Each object is a node that may be parented to another object; its
+    // Object3D position stays in world space and is kept in sync by updateFrames().
+    bool setParent(size_t index, int parentIndex, sim::FrameType type);
+    int getParentIndex(size_t index) const;
+    sim::FrameType getFrameType(size_t index) const;
+    glm::dvec3 getLocalPosition(size_t index) const;
+    void setLocalPosition(size_t index, const glm::dvec3& position);
+
+    // Picks up world-space edits made directly on the objects, propagates changed subtrees and
+    // writes the new world transforms back. Call once per frame before rendering.
+    void updateFrames();
+
+    // State of every body for analysis passes: mesh objects first, each on a circular orbit
+    // about the origin, followed by the bulk bodies.
+    sim::BodyStorage collectBodies() const;
+    std::vector<std::string> getObjectNames() const;
+
 private:
+    // Last transform written to or read from each object, by frame id
+    struct FrameSync {
+        glm::vec3 position{0.0f};
+        glm::vec3 rotation{0.0f};
+    };
+
+    void indexFrames();
+
     std::vector<SceneObject> objects;
+    sim::FrameTree frames;
+    std::vector<FrameSync> synced;
+    std::vector<size_t> objectOfFrame;
+    sim::BodyStorage bodies;
+    double centralMu = 1.0;
+    std::uint64_t revision = 0;
 };
 
 } // namespace gui
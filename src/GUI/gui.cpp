@@ -1,16 +1,31 @@
 #include "GUI/gui.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <future>
 #include <glm/gtc/type_ptr.hpp>
 #include <imgui.h>
 #include <imgui_internal.h>
 #include <iostream>
+#include <optional>
+#include <random>
 #include <string>
+#include <utility>
 #include <vector>
 #include "Graphics/bodies/cubeSphere.h"
 #include "Graphics/bodies/sphere.h"
+#include "Graphics/core/MeshLibrary.h"
 #include "Graphics/core/RenderVisitor.h"
+#include "Graphics/core/SurfaceMap.h"
 #include "Graphics/renderer.h"
+#include "Graphics/uniformBuffer.h"
 #include "Scene.h"
+#include "Simulation/Generators.h"
+#include "Simulation/OrbitalElements.h"
 #include "core/fps_counter.h"
+#include "core/thread_pool.h"
 
 namespace gui {
 
@@ -28,6 +43,9 @@ struct GuiState {
   int currentTab = 0;
   bool showPerformance = true;
   bool showControlPanel = true;
+  bool showEnsemble = false;
+  bool showPorkchop = false;
+  bool showConjunctions = false;
   float mainPanelWidth = 350.0F;
   bool showHelpTooltips = true;
   std::vector<std::string> presets;
@@ -35,6 +53,7 @@ struct GuiState {
   glm::vec3 lastSavedCameraPos = glm::vec3(0.0F);
   glm::vec3 lastSavedCameraTarget = glm::vec3(0.0F);
   float splitRatio = 0.5F;
+  bool redrawRequested = false;
 };
 
 // Initialize static GUI state
@@ -62,10 +81,198 @@ void CreateNewObject(const std::string &name, const std::string &type, const glm
     instance.addObject(newObject, name);
   }
 }
+
+// Surface map of the CubeSphere tab. Baking writes the file in the background, like the runs of
+// the analysis windows, and attaches it once done.
+struct SurfaceMapState {
+  char path[256] = "surface.orbsurf";
+  int bakeLevels = 4;
+  std::string status;
+  std::string bakingPath;
+  std::future<void> pending;
+};
+
+SurfaceMapState surfaceMapState;
+
+void LoadSurfaceMap(CubeSphere &cubeSphere, const std::string &path) {
+  auto &state = surfaceMapState;
+  try {
+    auto map = std::make_shared<const SurfaceMap>(path);
+    state.status = "Loaded " + std::to_string(map->getLevels()) + " levels";
+    cubeSphere.setSurfaceMap(std::move(map));
+  } catch (const std::exception &error) {
+    state.status = error.what();
+  }
+}
+
+void SurfaceMapControls(CubeSphere &cubeSphere) {
+  auto &state = surfaceMapState;
+  if (state.pending.valid() &&
+      state.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+    try {
+      state.pending.get();
+      LoadSurfaceMap(cubeSphere, state.bakingPath);
+    } catch (const std::exception &error) {
+      state.status = error.what();
+    }
+  }
+  const bool baking = state.pending.valid();
+  if (baking) {
+    RequestRedraw();
+  }
+
+  ImGui::Text("Surface Map");
+  ImGui::SameLine();
+  HelpMarker("Color tiles streamed from a file into a fixed texture atlas as the terrain chunks "
+             "come close enough to need them");
+  ImGui::BeginDisabled(baking);
+  ImGui::InputText("File", state.path, IM_ARRAYSIZE(state.path));
+  if (ImGui::Button("Load")) {
+    LoadSurfaceMap(cubeSphere, state.path);
+  }
+  ImGui::SameLine();
+  if (ImGui::Button("Unload")) {
+    cubeSphere.setSurfaceMap(nullptr);
+    state.status.clear();
+  }
+
+  ImGui::SliderInt("Bake Levels", &state.bakeLevels, 1, 6);
+  const double tiles = 6.0 * (std::pow(4.0, state.bakeLevels) - 1.0) / 3.0;
+  ImGui::SameLine();
+  ImGui::TextDisabled("%.0f MB", tiles * static_cast<double>(SURFACE_TILE_BYTES) / 1.0e6);
+  if (ImGui::Button("Bake From Terrain")) {
+    state.bakingPath = state.path;
+    state.status = "Baking...";
+    const TerrainSettings terrain = cubeSphere.getTerrain();
+    state.pending = std::async(std::launch::async, [path = state.bakingPath,
+                                                    levels = state.bakeLevels, terrain] {
+      writeSurfaceMap(path, levels,
+                      [&terrain](const std::vector<glm::vec3> &directions,
+                                 std::vector<glm::u8vec4> &texels) {
+                        shadeTerrainSurface(terrain, directions, texels);
+                      });
+    });
+  }
+  ImGui::SameLine();
+  HelpMarker("Writes the landscape of the terrain settings above to the file, colored by height, "
+             "and loads it");
+  ImGui::EndDisabled();
+
+  if (!state.status.empty()) {
+    ImGui::TextWrapped("%s", state.status.c_str());
+  }
+}
+
+// Star catalog of the Scene Options. Generating writes a synthetic catalog in the background and
+// loads it once done.
+struct StarFieldState {
+  char path[256] = "stars.orbstar";
+  float generateMillions = 2.0F;
+  std::string status;
+  std::string generatingPath;
+  std::future<void> pending;
+};
+
+StarFieldState starFieldState;
+
+// Stars down to magnitude 14 with roughly the sky's counts, about three times as many per
+// magnitude, the faint ones crowding toward a galactic plane tilted against the scene's.
+std::vector<StarRecord> MakeSyntheticSky(std::size_t count, std::uint64_t seed) {
+  constexpr double brightest = -1.5;
+  constexpr double faintest = 14.0;
+  constexpr double slope = 0.48; // log10 of the growth in count per magnitude
+  const glm::dvec3 pole = glm::normalize(glm::dvec3(0.0, 0.5, 0.87));
+
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  std::normal_distribution<double> gaussian(0.0, 1.0);
+  std::normal_distribution<float> colorIndex(0.65F, 0.35F);
+  const double low = std::pow(10.0, slope * brightest);
+  const double high = std::pow(10.0, slope * faintest);
+
+  std::vector<StarRecord> stars(count);
+  for (StarRecord &star : stars) {
+    star.magnitude = static_cast<float>(std::log10(low + (unit(rng) * (high - low))) / slope);
+    const double crowding = 4.0 * std::clamp((star.magnitude - 2.0) / 10.0, 0.0, 1.0);
+    glm::dvec3 direction;
+    do {
+      direction = glm::normalize(glm::dvec3(gaussian(rng), gaussian(rng), gaussian(rng)));
+    } while (unit(rng) * (1.0 + crowding) >
+             1.0 + (crowding * std::exp(-std::abs(glm::dot(direction, pole)) / 0.15)));
+    star.direction = glm::vec3(direction);
+    star.colorIndex = std::clamp(colorIndex(rng), -0.4F, 2.0F);
+  }
+  return stars;
+}
+
+void LoadStarCatalog(StarRenderer &stars, const std::string &path) {
+  auto &state = starFieldState;
+  try {
+    auto catalog = std::make_shared<const StarCatalog>(path);
+    state.status = "Loaded " + std::to_string(catalog->getStarCount()) + " stars";
+    stars.setCatalog(std::move(catalog));
+  } catch (const std::exception &error) {
+    state.status = error.what();
+  }
+}
+
+void StarFieldControls(StarRenderer &stars) {
+  auto &state = starFieldState;
+  if (state.pending.valid() &&
+      state.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+    try {
+      state.pending.get();
+      LoadStarCatalog(stars, state.generatingPath);
+    } catch (const std::exception &error) {
+      state.status = error.what();
+    }
+  }
+  const bool generating = state.pending.valid();
+  if (generating) {
+    RequestRedraw();
+  }
+
+  ImGui::BeginDisabled(generating);
+  ImGui::InputText("Catalog", state.path, IM_ARRAYSIZE(state.path));
+  if (ImGui::Button("Load Catalog")) {
+    LoadStarCatalog(stars, state.path);
+  }
+  ImGui::SliderFloat("Synthetic Stars (M)", &state.generateMillions, 0.1F, 10.0F, "%.1f");
+  if (ImGui::Button("Generate Synthetic Catalog")) {
+    state.generatingPath = state.path;
+    state.status = "Generating...";
+    const auto count = static_cast<std::size_t>(state.generateMillions * 1.0e6F);
+    state.pending = std::async(std::launch::async, [path = state.generatingPath, count] {
+      writeStarCatalog(path, MakeSyntheticSky(count, 1));
+    });
+  }
+  ImGui::SameLine();
+  HelpMarker("Writes a random sky with realistic star counts to the catalog file and loads it");
+  ImGui::EndDisabled();
+
+  if (!state.status.empty()) {
+    ImGui::TextWrapped("%s", state.status.c_str());
+  }
+}
 } // namespace
 
 Scene &getScene() { return instance; }
 
+void RequestRedraw() { guiState.redrawRequested = true; }
+
+bool TakeRedrawRequest() { return std::exchange(guiState.redrawRequested, false); }
+
+void Shutdown() {
+  WaitEnsembleJob();
+  WaitPorkchopJob();
+  WaitConjunctionJob();
+  for (auto *pending : {&surfaceMapState.pending, &starFieldState.pending}) {
+    if (pending->valid()) {
+      pending->wait();
+    }
+  }
+}
+
 // Helper functions
 void SetupStyle() {
   ImGuiStyle &style = ImGui::GetStyle();
@@ -96,6 +303,18 @@ void HelpMarker(const char *desc) {
   }
 }
 
+bool CentralMassControl(Scene &scene) {
+  auto mu = static_cast<float>(scene.getCentralMu());
+  const bool changed = ImGui::DragFloat("Central GM", &mu, 0.01F, 1.0e-4F, 1.0e4F, "%.4f",
+                                        ImGuiSliderFlags_Logarithmic);
+  if (changed) {
+    scene.setCentralMu(mu);
+  }
+  ImGui::SameLine();
+  HelpMarker("Gravitational parameter of the central mass at the origin");
+  return changed;
+}
+
 bool TabButton(const char *label, bool selected) {
   ImGuiStyle &style = ImGui::GetStyle();
   // Fix operator precedence with parentheses and use uppercase F suffix
@@ -247,6 +466,9 @@ void MainMenuBar(const FpsCounter &fpsCounter) {
     if (ImGui::BeginMenu("View")) {
       ImGui::MenuItem("Performance", nullptr, &guiState.showPerformance);
       ImGui::MenuItem("Control Panel", nullptr, &guiState.showControlPanel);
+      ImGui::MenuItem("Ensemble Runs", nullptr, &guiState.showEnsemble);
+      ImGui::MenuItem("Porkchop Plot", nullptr, &guiState.showPorkchop);
+      ImGui::MenuItem("Conjunction Screening", nullptr, &guiState.showConjunctions);
       ImGui::MenuItem("Show Help Tooltips", nullptr, &guiState.showHelpTooltips);
       ImGui::EndMenu();
     }
@@ -267,7 +489,7 @@ void MainMenuBar(const FpsCounter &fpsCounter) {
   }
 }
 
-void PerformanceWindow(const FpsCounter &fpsCounter) {
+void PerformanceWindow(const FpsCounter &fpsCounter, const Renderer &renderer) {
   if (!guiState.showPerformance) {
     return;
   }
@@ -279,6 +501,9 @@ void PerformanceWindow(const FpsCounter &fpsCounter) {
   HelpMarker("Frames per second - higher is better");
 
   ImGui::Text("Frame Time: %.2f ms", 1000.0F / fpsCounter.getFps());
+  ImGui::Text("Scene: %dx%d (%.0f%%), %.2f ms GPU", renderer.getSceneWidth(),
+              renderer.getSceneHeight(), renderer.getResolutionScale() * 100.0F,
+              renderer.getSceneGpuTime());
 
   // Simple graph for FPS
   static float values[90] = {};
@@ -303,6 +528,46 @@ void PerformanceWindow(const FpsCounter &fpsCounter) {
   ImGui::PlotLines("##FPS", values, IM_ARRAYSIZE(values), values_offset, overlay, 0.0F, 120.0F,
                    ImVec2(0, 80.0F));
 
+  ImGui::Text("Visible Objects: %zu / %zu", renderer.getVisibleObjectCount(),
+              renderer.getTotalObjectCount());
+  ImGui::Text("Draw Calls: %d (%zu packets)", renderer.getDrawCallCount(),
+              renderer.getDrawPacketCount());
+  ImGui::Text("Impostors: %zu", renderer.getImpostorCount());
+  ImGui::Text("Transform Blocks Updated: %zu", renderer.getTransformBlocksUpdated());
+  ImGui::SameLine();
+  HelpMarker("Blocks of 8 objects whose matrices were recomputed; static objects are skipped");
+  ImGui::Text("Particles: %zu", renderer.getParticleCount());
+  ImGui::Text("Trail Vertices: %zu", renderer.getTrailVertexCount());
+  ImGui::Text("Predicted Paths: %zu%s", renderer.getPredictedPathCount(),
+              renderer.isPredicting() ? " (refining)" : "");
+  if (renderer.isWellFieldSampled()) {
+    ImGui::Text("Gravity Wells: sampled field");
+    ImGui::SameLine();
+    HelpMarker("Too many massive bodies to sum per vertex; their potential comes from a texture");
+  }
+  const auto &clusters = renderer.getLightClusters();
+  ImGui::Text("Lights: %zu (%zu unbounded), up to %zu per cluster", clusters.getLightCount(),
+              clusters.getUnboundedLightCount(), clusters.getMaxClusterLights());
+  const auto &terrain = renderer.getTerrain();
+  ImGui::Text("Terrain: %zu chunks, %zu triangles (%zu cached, %zu pending)",
+              terrain.getChunkCount(), terrain.getTriangleCount(), terrain.getResidentCount(),
+              terrain.getPendingCount());
+  const auto &surfaces = terrain.getSurfaces();
+  ImGui::Text("Surface tiles: %zu resident, %zu pending", surfaces.getResidentCount(),
+              surfaces.getPendingCount());
+  const auto &stars = renderer.getStars();
+  ImGui::Text("Stars: %zu in %zu tiles to magnitude %.1f (%zu cached, %zu pending)",
+              stars.getStarCount(), stars.getTileCount(), stars.getMagnitudeLimit(),
+              stars.getCachedCount(), stars.getPendingCount());
+  ImGui::Text("Depth: %s", renderer.usesClipControl() ? "reversed-Z" : "reversed logarithmic");
+  ImGui::SameLine();
+  HelpMarker("Float depth with no far plane. Without glClipControl the shaders write logarithmic "
+             "depth instead.");
+  ImGui::Text("Skipped State Changes: %d", renderer.getSkippedStateChanges());
+  ImGui::Text("Shared Meshes: %zu", getMeshLibrary().getMeshCount());
+  ImGui::SameLine();
+  HelpMarker("GPU meshes alive; bodies with the same shape and resolution share one");
+
   ImGui::End();
 }
 
@@ -357,62 +622,202 @@ void RenderSceneControls(Renderer &renderer, bool &sceneUpdated) {
       renderer.setWireframe(wireframeMode);
     }
 
+    ImGui::Checkbox("Render On Demand", &settings.renderOnDemand);
+    ImGui::SameLine();
+    HelpMarker("Draw the scene only when the camera, settings or scene change, or while something "
+               "is loading or animating, and sleep otherwise");
+
+    ImGui::Checkbox("Sphere Impostors", &settings.useImpostors);
+    ImGui::SameLine();
+    HelpMarker("Draw small bodies as ray-cast quads instead of meshes");
+    if (settings.useImpostors) {
+      ImGui::SliderFloat("Impostor Below (px)", &settings.impostorPixelRadius, 1.0F, 64.0F,
+                         "%.0f");
+    }
+
+    // Resolution Controls
+    if (ImGui::TreeNode("Resolution Scaling")) {
+      auto &resolution = settings.resolution;
+      ImGui::Checkbox("Dynamic Resolution", &resolution.dynamic);
+      ImGui::SameLine();
+      HelpMarker("Render the scene at a lower resolution while it takes longer than the target "
+                 "on the GPU, and scale it up to the window. The GUI stays sharp.");
+      ImGui::SliderFloat("Target GPU Time", &resolution.targetFrameTime, 4.0F, 50.0F, "%.1f ms");
+      ImGui::SliderFloat("Min Scale", &resolution.minScale, 0.25F, 1.0F, "%.2f");
+      ImGui::TreePop();
+    }
+
+    // Star Field Controls
+    if (ImGui::TreeNode("Star Field")) {
+      auto &style = settings.starStyle;
+      ImGui::Checkbox("Show Stars", &settings.showStars);
+      ImGui::SliderFloat("Magnitude Limit", &style.magnitudeLimit, 0.0F, 14.0F, "%.1f");
+      ImGui::SameLine();
+      HelpMarker("Faintest stars shown at a 45 degree field of view. Narrower views reach fainter "
+                 "stars, about five magnitudes per tenfold zoom.");
+      ImGui::SliderFloat("Star Brightness", &style.brightness, 0.1F, 10.0F, "%.2f",
+                         ImGuiSliderFlags_Logarithmic);
+      ImGui::SliderFloat("Max Star Size", &style.maxPointSize, 1.0F, 16.0F, "%.1f px");
+      StarFieldControls(renderer.getStars());
+      ImGui::TreePop();
+    }
+
+    // Terrain Controls
+    if (ImGui::TreeNode("Terrain Settings")) {
+      ImGui::SliderFloat("Max Pixel Error", &settings.terrainPixelError, 0.25F, 16.0F,
+                         "%.2f px", ImGuiSliderFlags_Logarithmic);
+      ImGui::SameLine();
+      HelpMarker("Terrain chunks split until the detail they leave out is at most this large on "
+                 "screen");
+      ImGui::SliderInt("Max Level", &settings.terrainMaxLevel, 0, TERRAIN_MAX_LEVEL);
+      ImGui::TreePop();
+    }
+
+    // Particle Controls
+    if (ImGui::TreeNode("Particle Settings")) {
+      auto &style = settings.particleStyle;
+      ImGui::Checkbox("Show Particles", &settings.showParticles);
+      ImGui::SameLine();
+      HelpMarker("Draw simulation bodies as point sprites");
+
+      const char *colorModes[] = {"Uniform", "Speed", "Eccentricity", "Inclination"};
+      int colorMode = static_cast<int>(style.colorMode);
+      if (ImGui::Combo("Color By", &colorMode, colorModes, IM_ARRAYSIZE(colorModes))) {
+        style.colorMode = static_cast<ParticleColorMode>(colorMode);
+      }
+      if (style.colorMode == ParticleColorMode::Uniform) {
+        ImGui::ColorEdit3("Particle Color", glm::value_ptr(style.color));
+      } else if (style.colorMode == ParticleColorMode::Speed) {
+        ImGui::SliderFloat("Speed Scale", &style.speedScale, 0.01F, 10.0F, "%.2f",
+                           ImGuiSliderFlags_Logarithmic);
+      }
+      ImGui::SliderFloat("Min Point Size", &style.minPointSize, 1.0F, 8.0F, "%.1f px");
+      ImGui::TreePop();
+    }
+
+    // Trail Controls
+    if (ImGui::TreeNode("Trail Settings")) {
+      auto &style = settings.trailStyle;
+      ImGui::Checkbox("Show Trails", &settings.showTrails);
+      ImGui::SameLine();
+      if (ImGui::Button("Clear Trails")) {
+        renderer.clearTrails();
+      }
+      ImGui::SliderInt("Trail Bodies", &settings.maxTrailBodies, 0, 50000);
+      ImGui::SameLine();
+      HelpMarker("Bulk bodies beyond this count get no trail");
+      ImGui::SliderInt("Samples", &style.length, 16, 1024);
+      ImGui::SliderFloat("Sample Angle", &style.sampleAngle, 0.25F, 15.0F, "%.2f deg");
+      ImGui::SameLine();
+      HelpMarker("A new sample is taken once a body's path turns this far");
+      ImGui::SliderFloat("Max Spacing", &style.maxSampleSpacing, 0.01F, 5.0F, "%.2f",
+                         ImGuiSliderFlags_Logarithmic);
+      ImGui::SliderFloat("Fade Time", &style.fadeTime, 1.0F, 120.0F, "%.0f s");
+      ImGui::ColorEdit3("Trail Color", glm::value_ptr(style.color));
+      ImGui::TreePop();
+    }
+
+    // Prediction Controls
+    if (ImGui::TreeNode("Prediction Settings")) {
+      auto &prediction = settings.prediction;
+      ImGui::Checkbox("Show Predictions", &settings.showPredictions);
+      ImGui::SameLine();
+      HelpMarker("Future paths, computed in the background and refined as they arrive");
+      ImGui::Checkbox("All Bodies", &settings.predictAllBodies);
+      ImGui::SameLine();
+      HelpMarker("Predict every body instead of only the selected object");
+      if (settings.predictAllBodies) {
+        ImGui::SliderInt("Predicted Bodies", &settings.maxPredictedBodies, 0, 20000);
+      }
+
+      auto horizon = static_cast<float>(prediction.maxHorizon);
+      if (ImGui::SliderFloat("Horizon", &horizon, 0.1F, 200.0F, "%.1f",
+                             ImGuiSliderFlags_Logarithmic)) {
+        prediction.maxHorizon = horizon;
+      }
+      ImGui::SameLine();
+      HelpMarker("Bound orbits are shown for one period, at most this long");
+
+      int coarse = static_cast<int>(prediction.coarseSamples);
+      int fine = static_cast<int>(prediction.fineSamples);
+      if (ImGui::SliderInt("Coarse Samples", &coarse, 4, 64)) {
+        prediction.coarseSamples = static_cast<size_t>(coarse);
+      }
+      if (ImGui::SliderInt("Fine Samples", &fine, 16, 2048)) {
+        prediction.fineSamples = static_cast<size_t>(fine);
+      }
+      ImGui::ColorEdit3("Path Color", glm::value_ptr(settings.predictionColor));
+      ImGui::TreePop();
+    }
+
     // Grid Controls
     if (ImGui::TreeNode("Grid Settings")) {
-      bool gridUpdated = false;
-
-      gridUpdated |= ImGui::Checkbox("Show Grid", &settings.showGrid);
+      ImGui::Checkbox("Show Grid", &settings.showGrid);
 
       if (settings.showGrid) {
         // Basic Grid Settings
         if (ImGui::CollapsingHeader("Basic Settings", ImGuiTreeNodeFlags_DefaultOpen)) {
-          gridUpdated |= ImGui::SliderFloat("Grid Size", &settings.gridSize, 5.0f, 100.0f, "%.1f");
-          ImGui::SameLine();
-          HelpMarker("Controls the total size of the grid");
-
-          gridUpdated |= ImGui::SliderInt("Grid Divisions", &settings.gridDivisions, 5, 100);
+          ImGui::SliderFloat("Cell Size", &settings.gridCellSize, 0.01f, 100.0f, "%.2f",
+                             ImGuiSliderFlags_Logarithmic);
           ImGui::SameLine();
-          HelpMarker("Controls how many lines make up the grid");
+          HelpMarker("Spacing of the finest lines; coarser levels fade in with distance");
 
-          gridUpdated |=
-              ImGui::SliderFloat("Grid Opacity", &settings.gridOpacity, 0.0f, 1.0f, "%.2f");
+          ImGui::SliderFloat("Grid Opacity", &settings.gridOpacity, 0.0f, 1.0f, "%.2f");
           ImGui::SameLine();
           HelpMarker("Controls overall grid transparency");
         }
 
         // Visual Settings
         if (ImGui::CollapsingHeader("Visual Settings", ImGuiTreeNodeFlags_DefaultOpen)) {
-          gridUpdated |= ColorControl("Minor Grid Color", settings.gridColor);
-          gridUpdated |= ColorControl("Major Grid Color", settings.majorGridColor);
+          ColorControl("Minor Grid Color", settings.gridColor);
+          ColorControl("Major Grid Color", settings.majorGridColor);
 
-          gridUpdated |=
-              ImGui::SliderFloat("Minor Line Width", &settings.minorLineWidth, 0.5f, 3.0f, "%.1f");
-          gridUpdated |=
-              ImGui::SliderFloat("Major Line Width", &settings.majorLineWidth, 1.0f, 5.0f, "%.1f");
+          ImGui::SliderFloat("Minor Line Width", &settings.minorLineWidth, 0.5f, 3.0f, "%.1f");
+          ImGui::SliderFloat("Major Line Width", &settings.majorLineWidth, 1.0f, 5.0f, "%.1f");
 
-          gridUpdated |= ImGui::SliderFloat("Major Grid Spacing", &settings.majorGridSpacing, 2.0f,
-                                            10.0f, "%.0f");
+          ImGui::SliderFloat("Major Grid Spacing", &settings.majorGridSpacing, 2.0f, 10.0f, "%.0f");
           ImGui::SameLine();
           HelpMarker("Number of minor grid cells between major grid lines");
         }
 
         // Axis Settings
         if (ImGui::CollapsingHeader("Axis Lines", ImGuiTreeNodeFlags_DefaultOpen)) {
-          gridUpdated |= ImGui::Checkbox("Show Axis Lines", &settings.showAxisLines);
+          ImGui::Checkbox("Show Axis Lines", &settings.showAxisLines);
           if (settings.showAxisLines) {
-            gridUpdated |= ColorControl("X-Axis Color", settings.xAxisColor);
-            gridUpdated |= ColorControl("Z-Axis Color", settings.zAxisColor);
+            ColorControl("X-Axis Color", settings.xAxisColor);
+            ColorControl("Z-Axis Color", settings.zAxisColor);
           }
         }
 
         // Fade Settings
         if (ImGui::CollapsingHeader("Fade Settings", ImGuiTreeNodeFlags_DefaultOpen)) {
-          gridUpdated |= ImGui::SliderFloat("Fade Distance", &settings.gridFadeDistance, 10.0f,
-                                            200.0f, "%.1f");
+          ImGui::SliderFloat("Fade Distance", &settings.gridFadeDistance, 10.0f, 200.0f, "%.1f");
           ImGui::SameLine();
           HelpMarker("Distance at which the grid fades out");
         }
 
+        // Gravity Wells
+        if (ImGui::CollapsingHeader("Gravity Wells")) {
+          auto &wells = settings.gravityWellStyle;
+          ImGui::Checkbox("Show Gravity Wells", &settings.showGravityWells);
+          ImGui::SameLine();
+          HelpMarker("Pulls the grid down into the potential of the central mass and the massive "
+                     "bulk bodies");
+          ImGui::SliderFloat("Depth Scale", &wells.depthScale, 0.01f, 100.0f, "%.2f",
+                             ImGuiSliderFlags_Logarithmic);
+          ImGui::SliderFloat("Max Depth", &wells.maxDepth, 0.1f, 100.0f, "%.1f",
+                             ImGuiSliderFlags_Logarithmic);
+          ImGui::SliderFloat("Softening", &wells.softening, 0.001f, 1.0f, "%.3f",
+                             ImGuiSliderFlags_Logarithmic);
+          ImGui::SameLine();
+          HelpMarker("Rounds off the bottom of each well");
+          ImGui::SliderInt("Field Resolution", &wells.fieldResolution, 32, 512);
+          ImGui::SliderFloat("Opening Angle", &wells.openingAngle, 0.1f, 1.5f, "%.2f");
+          ImGui::SameLine();
+          HelpMarker("Used once there are more massive bodies than the shader sums directly; "
+                     "smaller is more accurate and slower");
+        }
+
         // Grid Presets
         if (ImGui::TreeNode("Grid Presets")) {
           if (ImGui::Button("Engineering")) {
@@ -421,7 +826,6 @@ void RenderSceneControls(Renderer &renderer, bool &sceneUpdated) {
             settings.majorGridSpacing = 5.0f;
             settings.gridOpacity = 0.7f;
             settings.showAxisLines = true;
-            gridUpdated = true;
           }
           ImGui::SameLine();
           if (ImGui::Button("Blueprint")) {
@@ -430,7 +834,6 @@ void RenderSceneControls(Renderer &renderer, bool &sceneUpdated) {
             settings.majorGridSpacing = 4.0f;
             settings.gridOpacity = 0.5f;
             settings.showAxisLines = true;
-            gridUpdated = true;
           }
           ImGui::SameLine();
           if (ImGui::Button("Minimal")) {
@@ -439,16 +842,11 @@ void RenderSceneControls(Renderer &renderer, bool &sceneUpdated) {
             settings.majorGridSpacing = 2.0f;
             settings.gridOpacity = 0.3f;
             settings.showAxisLines = false;
-            gridUpdated = true;
           }
           ImGui::TreePop();
         }
       }
 
-      if (gridUpdated) {
-        renderer.initGrid();
-      }
-
       ImGui::TreePop();
     }
   }
@@ -457,7 +855,7 @@ void RenderSceneControls(Renderer &renderer, bool &sceneUpdated) {
 void RenderLightingControls(std::vector<std::shared_ptr<Light>> &lights) {
   if (ImGui::CollapsingHeader("Lighting", ImGuiTreeNodeFlags_DefaultOpen)) {
     // Add a Light button
-    if (ImGui::Button("Add Light")) {
+    if (ImGui::Button("Add Light") && lights.size() < static_cast<size_t>(MAX_LIGHTS)) {
       lights.push_back(std::make_shared<Light>("Light " + std::to_string(lights.size() + 1)));
     }
 
@@ -504,6 +902,15 @@ void RenderLightingControls(std::vector<std::shared_ptr<Light>> &lights) {
           light->setShininess(shininess);
         }
 
+        float range = light->getRange();
+        const char *rangeFormat = range > 0.0f ? "%.1f" : "unbounded";
+        if (ImGui::SliderFloat("Range", &range, 0.0f, 100.0f, rangeFormat)) {
+          light->setRange(range);
+        }
+        ImGui::SameLine();
+        HelpMarker("Distance at which the light fades out. Ranged lights only cost the fragments "
+                   "they reach; unbounded lights are evaluated everywhere.");
+
         // Delete button
         if (ImGui::Button("Delete") && lights.size() > 1) {
           lights.erase(lights.begin() + i);
@@ -545,6 +952,206 @@ void RenderLightingControls(std::vector<std::shared_ptr<Light>> &lights) {
   }
 }
 
+bool DragDouble(const char *label, double &value, double speed, double min, double max,
+                const char *format = "%.4f") {
+  return ImGui::DragScalar(label, ImGuiDataType_Double, &value, static_cast<float>(speed), &min,
+                           &max, format);
+}
+
+// Host picker for generators that attach to a body: the central mass or one of the scene objects.
+void HostCombo(const char *label, int &host, const std::vector<std::string> &names) {
+  host = std::min(host, static_cast<int>(names.size()));
+  const char *preview = host == 0 ? "Central mass" : names[host - 1].c_str();
+  if (ImGui::BeginCombo(label, preview)) {
+    if (ImGui::Selectable("Central mass", host == 0)) {
+      host = 0;
+    }
+    for (size_t i = 0; i < names.size(); ++i) {
+      if (ImGui::Selectable(names[i].c_str(), host == static_cast<int>(i) + 1)) {
+        host = static_cast<int>(i) + 1;
+      }
+    }
+    ImGui::EndCombo();
+  }
+}
+
+void RenderGeneratorControls(Scene &scene) {
+  static int generatorType = 0;
+  static int count = 100000;
+  static int seed = 1;
+  static int host = 0;
+  static sim::PlummerSpec plummer;
+  static sim::KingSpec king;
+  static sim::ExponentialDiskSpec disk;
+  static sim::KeplerianRingSpec ring;
+  static sim::DebrisCloudSpec debris;
+  static double lastMilliseconds = 0.0;
+  static size_t lastCount = 0;
+
+  const char *generatorTypes[] = {"Plummer Cluster", "King Cluster", "Exponential Disk",
+                                  "Keplerian Ring", "Debris Cloud"};
+  ImGui::Combo("Population", &generatorType, generatorTypes, IM_ARRAYSIZE(generatorTypes));
+  ImGui::InputInt("Bodies", &count, 1000, 100000);
+  count = std::clamp(count, 1, 10000000);
+  ImGui::InputInt("Seed", &seed);
+  ImGui::SameLine();
+  HelpMarker("The same seed always produces the same bodies, whatever the thread count");
+
+  const std::vector<std::string> names = scene.getObjectNames();
+  switch (generatorType) {
+  case 0:
+    DragDouble("Total Mass", plummer.totalMass, 0.01, 1.0e-6, 1.0e3);
+    DragDouble("Scale Radius", plummer.scaleRadius, 0.01, 1.0e-3, 100.0);
+    break;
+  case 1:
+    DragDouble("Total Mass", king.totalMass, 0.01, 1.0e-6, 1.0e3);
+    DragDouble("Core Radius", king.coreRadius, 0.01, 1.0e-3, 100.0);
+    DragDouble("W0", king.centralPotential, 0.05, 0.5, 12.0, "%.2f");
+    ImGui::SameLine();
+    HelpMarker("Central potential depth; higher values give a denser core and wider halo");
+    break;
+  case 2:
+    DragDouble("Disk Mass", disk.diskMass, 0.01, 0.0, 1.0e3);
+    DragDouble("Scale Length", disk.scaleLength, 0.01, 1.0e-3, 100.0);
+    DragDouble("Scale Height", disk.scaleHeight, 0.001, 0.0, 10.0);
+    DragDouble("Truncation", disk.outerRadius, 0.1, 0.5, 20.0, "%.1f");
+    ImGui::SameLine();
+    HelpMarker("Outer edge of the disk in scale lengths");
+    DragDouble("Dispersion", disk.velocityDispersion, 0.005, 0.0, 1.0, "%.3f");
+    break;
+  case 3:
+    HostCombo("Host", host, names);
+    DragDouble("Host GM", ring.hostMu, 0.01, 1.0e-6, 1.0e4);
+    DragDouble("Inner Radius", ring.innerRadius, 0.01, 1.0e-3, 100.0);
+    DragDouble("Outer Radius", ring.outerRadius, 0.01, 1.0e-3, 100.0);
+    ring.outerRadius = std::max(ring.outerRadius, ring.innerRadius);
+    DragDouble("Eccentricity", ring.eccentricityScale, 0.001, 0.0, 0.5, "%.3f");
+    DragDouble("Inclination", ring.inclinationScale, 0.001, 0.0, 0.5, "%.3f");
+    ImGui::SameLine();
+    HelpMarker("Rayleigh scales of the eccentricity and inclination (radians) distributions");
+    break;
+  default:
+    HostCombo("Parent", host, names);
+    DragDouble("Parent Mass", debris.parentMass, 1.0e-7, 0.0, 1.0, "%.2e");
+    DragDouble("Ejection Speed", debris.deltaV, 0.001, 0.0, 10.0);
+    DragDouble("Speed Spread", debris.deltaVSpread, 0.01, 0.0, 2.0, "%.2f");
+    DragDouble("Mass Exponent", debris.massExponent, 0.01, 0.1, 2.0, "%.2f");
+    break;
+  }
+
+  if (ImGui::Button("Generate", ImVec2(ImGui::GetContentRegionAvail().x, 0))) {
+    // Attach to the chosen host using the same state the analysis windows see.
+    sim::OrbitState hostState;
+    if (host > 0 && static_cast<size_t>(host) <= names.size()) {
+      const sim::BodyStorage bodies = scene.collectBodies();
+      hostState = {bodies.position(host - 1), bodies.velocity(host - 1)};
+    }
+
+    const auto configure = [&](sim::GeneratorSpec &spec) {
+      spec.count = static_cast<size_t>(count);
+      spec.seed = static_cast<std::uint64_t>(seed);
+      spec.center = hostState.position;
+      spec.velocity = hostState.velocity;
+    };
+    auto &bodies = scene.getBodies();
+    auto &pool = getThreadPool();
+    const auto start = std::chrono::steady_clock::now();
+    switch (generatorType) {
+    case 0:
+      configure(plummer);
+      sim::generatePlummer(plummer, bodies, pool);
+      break;
+    case 1:
+      configure(king);
+      sim::generateKing(king, bodies, pool);
+      break;
+    case 2:
+      configure(disk);
+      disk.centralMu = scene.getCentralMu();
+      sim::generateExponentialDisk(disk, bodies, pool);
+      break;
+    case 3:
+      configure(ring);
+      sim::generateKeplerianRing(ring, bodies, pool);
+      break;
+    default:
+      configure(debris);
+      sim::generateDebrisCloud(debris, bodies, pool);
+      break;
+    }
+    lastMilliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+            .count();
+    lastCount = static_cast<size_t>(count);
+    scene.markChanged();
+  }
+
+  if (lastCount > 0) {
+    ImGui::Text("Generated %zu bodies in %.1f ms", lastCount, lastMilliseconds);
+  }
+  ImGui::Text("Bulk bodies: %zu", scene.getBodies().size());
+  if (ImGui::Button("Clear Bodies")) {
+    scene.getBodies().clear();
+    scene.markChanged();
+    lastCount = 0;
+  }
+}
+
+void RenderOrbitalElementsTable(Scene &scene) {
+  CentralMassControl(scene);
+
+  // Converted again only when the scene changes, as the trajectory prediction does
+  static sim::KeplerianElements elements;
+  static std::vector<std::string> names;
+  static size_t bodyCount = 0;
+  static std::optional<std::uint64_t> convertedRevision;
+  if (convertedRevision != scene.getRevision()) {
+    const sim::BodyStorage bodies = scene.collectBodies();
+    sim::stateToKeplerian(bodies, scene.getCentralMu(), elements, getThreadPool());
+    names = scene.getObjectNames();
+    bodyCount = bodies.size();
+    convertedRevision = scene.getRevision();
+  }
+
+  constexpr ImGuiTableFlags flags =
+      ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY;
+  if (bodyCount > 0 && ImGui::BeginTable("OrbitalElements", 7, flags, ImVec2(0, 300))) {
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Body");
+    ImGui::TableSetupColumn("a");
+    ImGui::TableSetupColumn("e");
+    ImGui::TableSetupColumn("i (deg)");
+    ImGui::TableSetupColumn("Node (deg)");
+    ImGui::TableSetupColumn("Peri (deg)");
+    ImGui::TableSetupColumn("Anomaly (deg)");
+    ImGui::TableHeadersRow();
+
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(bodyCount));
+    while (clipper.Step()) {
+      for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        if (static_cast<size_t>(row) < names.size()) {
+          ImGui::TextUnformatted(names[row].c_str());
+        } else {
+          ImGui::Text("Body %zu", row - names.size());
+        }
+        ImGui::TableNextColumn();
+        ImGui::Text("%.4f", elements.semiMajorAxis[row]);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.4f", elements.eccentricity[row]);
+        for (const auto *angle : {&elements.inclination, &elements.ascendingNode,
+                                  &elements.argumentOfPeriapsis, &elements.trueAnomaly}) {
+          ImGui::TableNextColumn();
+          ImGui::Text("%.2f", glm::degrees((*angle)[row]));
+        }
+      }
+    }
+    ImGui::EndTable();
+  }
+}
+
 void RenderObjectControls(Sphere &sphere, CubeSphere &cubeSphere) {
   if (ImGui::BeginTabBar("ObjectTabs")) {
     if (ImGui::BeginTabItem("Sphere")) {
@@ -554,11 +1161,13 @@ void RenderObjectControls(Sphere &sphere, CubeSphere &cubeSphere) {
       glm::vec3 position = sphere.getPosition();
       if (Vec3Control("Position", position)) {
         sphere.setPosition(position);
+        getScene().markChanged();
       }
 
       float radius = sphere.getRadius();
       if (ImGui::SliderFloat("Radius", &radius, 0.1F, 5.0F)) {
         sphere.setRadius(radius);
+        getScene().markChanged();
       }
 
       glm::vec3 scale = sphere.getScale();
@@ -566,6 +1175,11 @@ void RenderObjectControls(Sphere &sphere, CubeSphere &cubeSphere) {
         sphere.setScale(scale);
       }
 
+      glm::vec3 rotation = sphere.getRotation();
+      if (Vec3Control("Rotation", rotation, 0.0F, 1.0F, -180.0F, 180.0F)) {
+        sphere.setRotation(rotation);
+      }
+
       // Color control
       glm::vec3 color = sphere.getColor();
       if (ColorControl("Color", color)) {
@@ -602,6 +1216,7 @@ void RenderObjectControls(Sphere &sphere, CubeSphere &cubeSphere) {
       // Position control
       if (glm::vec3 position = cubeSphere.getPosition(); Vec3Control("Position", position)) {
         cubeSphere.setPosition(position);
+        getScene().markChanged();
       }
 
       if (glm::vec3 scale = cubeSphere.getScale();
@@ -609,6 +1224,11 @@ void RenderObjectControls(Sphere &sphere, CubeSphere &cubeSphere) {
         cubeSphere.setScale(scale);
       }
 
+      if (glm::vec3 rotation = cubeSphere.getRotation();
+          Vec3Control("Rotation", rotation, 0.0F, 1.0F, -180.0F, 180.0F)) {
+        cubeSphere.setRotation(rotation);
+      }
+
       // Color control
       glm::vec3 color = cubeSphere.getColor();
       if (ColorControl("Color", color)) {
@@ -629,10 +1249,38 @@ void RenderObjectControls(Sphere &sphere, CubeSphere &cubeSphere) {
       float size = cubeSphere.getSize();
       if (ImGui::SliderFloat("Size", &size, 0.1F, 2.0F)) {
         cubeSphere.setSize(size);
+        getScene().markChanged();
       }
       ImGui::SameLine();
       HelpMarker("Adjusts the overall size of the cube sphere.");
 
+      // Procedural terrain
+      ImGui::Separator();
+      TerrainSettings terrain = cubeSphere.getTerrain();
+      bool terrainChanged = ImGui::Checkbox("Terrain", &terrain.enabled);
+      ImGui::SameLine();
+      HelpMarker("Procedural relief drawn as a quadtree of chunks that refines toward the camera");
+      if (terrain.enabled) {
+        terrainChanged |= ImGui::SliderFloat("Relief", &terrain.heightScale, 0.0F, 0.2F, "%.3f");
+        ImGui::SameLine();
+        HelpMarker("Highest peaks over the radius");
+        terrainChanged |= ImGui::SliderFloat("Feature Scale", &terrain.baseFrequency, 0.5F, 16.0F,
+                                             "%.1f", ImGuiSliderFlags_Logarithmic);
+        terrainChanged |= ImGui::SliderInt("Octaves", &terrain.octaves, 1, 24);
+        int seed = static_cast<int>(terrain.seed);
+        if (ImGui::InputInt("Seed", &seed)) {
+          terrain.seed = static_cast<std::uint32_t>(seed);
+          terrainChanged = true;
+        }
+      }
+      if (terrainChanged) {
+        cubeSphere.setTerrain(terrain);
+        getScene().markChanged();
+      }
+
+      ImGui::Separator();
+      SurfaceMapControls(cubeSphere);
+
       ImGui::EndTabItem();
     }
 
@@ -677,6 +1325,17 @@ void RenderObjectControls(Sphere &sphere, CubeSphere &cubeSphere) {
         objectPosition = glm::vec3(0.0F);
       }
 
+      ImGui::Spacing();
+      ImGui::Separator();
+      ImGui::Text("Generate a population:");
+      RenderGeneratorControls(getScene());
+
+      ImGui::EndTabItem();
+    }
+
+    if (ImGui::BeginTabItem("Orbital Elements")) {
+      ImGui::Spacing();
+      RenderOrbitalElementsTable(getScene());
       ImGui::EndTabItem();
     }
 
@@ -684,13 +1343,57 @@ void RenderObjectControls(Sphere &sphere, CubeSphere &cubeSphere) {
   }
 }
 
+// Parent and frame of the selected object; its position is then edited relative to the parent.
+void RenderFrameControls(Scene &scene) {
+  auto &objects = scene.getObjects();
+  const auto selected = std::find_if(objects.begin(), objects.end(),
+                                     [](const SceneObject &obj) { return obj.selected; });
+  if (selected == objects.end()) {
+    ImGui::TextDisabled("Select an object to edit its reference frame");
+    return;
+  }
+  const auto index = static_cast<size_t>(selected - objects.begin());
+
+  ImGui::Separator();
+  ImGui::Text("Reference Frame");
+  const int parent = scene.getParentIndex(index);
+  if (ImGui::BeginCombo("Parent", parent < 0 ? "None" : objects[parent].name.c_str())) {
+    if (ImGui::Selectable("None", parent < 0)) {
+      scene.setParent(index, -1, scene.getFrameType(index));
+    }
+    for (size_t i = 0; i < objects.size(); ++i) {
+      // setParent refuses cycles, so descendants simply do nothing when picked
+      if (i != index && ImGui::Selectable(objects[i].name.c_str(), static_cast<int>(i) == parent)) {
+        scene.setParent(index, static_cast<int>(i), scene.getFrameType(index));
+      }
+    }
+    ImGui::EndCombo();
+  }
+
+  const char *frameTypes[] = {"Barycentric", "Body-Fixed", "Rotating"};
+  int frameType = static_cast<int>(scene.getFrameType(index));
+  ImGui::BeginDisabled(parent < 0);
+  if (ImGui::Combo("Frame", &frameType, frameTypes, IM_ARRAYSIZE(frameTypes))) {
+    scene.setParent(index, parent, static_cast<sim::FrameType>(frameType));
+  }
+  ImGui::SameLine();
+  HelpMarker("Barycentric: parent-centered, fixed axes. Body-Fixed: turns with the parent. "
+             "Rotating: +X points away from the parent's own primary.");
+
+  glm::vec3 local(scene.getLocalPosition(index));
+  if (Vec3Control("Local Position", local)) {
+    scene.setLocalPosition(index, glm::dvec3(local));
+  }
+  ImGui::EndDisabled();
+}
+
 void RenderObjectList() {
   ImGui::Begin("Scene Objects");
 
   auto &objects = getScene().getObjects();
 
-  // Object List
-  ImGui::BeginChild("ObjectList", ImVec2(0, -ImGui::GetFrameHeightWithSpacing()));
+  // Object List, leaving room for the selected object's frame controls
+  ImGui::BeginChild("ObjectList", ImVec2(0, -ImGui::GetFrameHeightWithSpacing() * 6));
   for (size_t i = 0; i < objects.size(); i++) {
     auto &obj = objects[i];
     char label[128];
@@ -716,6 +1419,8 @@ void RenderObjectList() {
   }
   ImGui::EndChild();
 
+  RenderFrameControls(getScene());
+
   ImGui::End();
 }
 
@@ -730,11 +1435,22 @@ void RenderGui(const FpsCounter &fpsCounter, const std::shared_ptr<Sphere> &sphe
   MainMenuBar(fpsCounter);
 
   // Performance window
-  PerformanceWindow(fpsCounter);
+  PerformanceWindow(fpsCounter, renderer);
 
   // Object List window
   RenderObjectList();
 
+  // Analysis windows
+  if (guiState.showEnsemble) {
+    EnsembleWindow(&guiState.showEnsemble);
+  }
+  if (guiState.showPorkchop) {
+    PorkchopWindow(&guiState.showPorkchop);
+  }
+  if (guiState.showConjunctions) {
+    ConjunctionWindow(&guiState.showConjunctions);
+  }
+
   // Main control panel
   if (guiState.showControlPanel) {
     ImGui::SetNextWindowPos(ImVec2(10, 30), ImGuiCond_FirstUseEver);
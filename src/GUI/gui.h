@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -22,6 +23,7 @@ struct SceneObject {
     std::string name;
     std::shared_ptr<Object3D> object;
     bool selected = false;
+    std::uint32_t frame = 0;  // node in the Scene's frame tree
 };
 
 // Update function signature to use shared_ptr
@@ -31,9 +33,30 @@ Scene& getScene();
 
 // Update function declarations to accept const references
 void MainMenuBar(const FpsCounter& fpsCounter);
-void PerformanceWindow(const FpsCounter& fpsCounter);
+void PerformanceWindow(const FpsCounter& fpsCounter, const Renderer& renderer);
 
 // Function to render lighting controls
 void RenderLightingControls(std::vector<std::shared_ptr<Light>>& lights);
 
+// On-demand rendering: windows that change without input, such as one waiting on a background
+// job, ask for the next frame. TakeRedrawRequest() reports whether any did since the last call.
+void RequestRedraw();
+bool TakeRedrawRequest();
+
+// Shared widgets
+void HelpMarker(const char* desc);
+bool CentralMassControl(Scene& scene);
+
+// Analysis windows
+void EnsembleWindow(bool* open);
+void PorkchopWindow(bool* open);
+void ConjunctionWindow(bool* open);
+void WaitEnsembleJob();
+void WaitPorkchopJob();
+void WaitConjunctionJob();
+
+// Waits for every background job the windows started. The jobs run on the thread pool, which
+// is destroyed before the windows' state, so main calls this before it returns.
+void Shutdown();
+
 } // namespace gui
@@ -1,20 +1,47 @@
 #include "cubeSphere.h"
 
 #include <glad/glad.h>
+#include <algorithm>
+#include <atomic>
 #include <glm/gtc/matrix_transform.hpp>
+#include "Graphics/core/MeshLibrary.h"
 
-CubeSphere::CubeSphere(float s, int res) : size(s), resolution(res) {
-  rebuild();
-  setupBuffers();
+namespace {
+
+std::uint32_t nextTerrainId() {
+  static std::atomic<std::uint32_t> counter{0};
+  return ++counter;
+}
+
+} // namespace
+
+CubeSphere::CubeSphere(float s, int res) : size(s), resolution(res), terrainId(nextTerrainId()) {
+  acquireMesh();
 }
 
 void CubeSphere::setResolution(int res) {
   resolution = res;
-  rebuild();
-  setupBuffers();
+  acquireMesh();
 }
 
-glm::vec3 CubeSphere::spherify(const glm::vec3 &point) const {
+void CubeSphere::setTerrain(const TerrainSettings &settings) {
+  if (settings == terrain) {
+    return;
+  }
+  terrain = settings;
+  terrainId = nextTerrainId();
+}
+
+void CubeSphere::acquireMesh() {
+  // Bodies with the same resolution share one GPU mesh per detail level
+  for (int level = 0; level < MESH_LOD_COUNT; ++level) {
+    const int levelResolution = std::max(resolution >> level, 2);
+    meshes[level] = getMeshLibrary().acquire({MeshShape::CubeSphere, levelResolution},
+                                             [=] { return buildMesh(levelResolution); });
+  }
+}
+
+glm::vec3 CubeSphere::spherify(const glm::vec3 &point) {
   float x2 = point.x * point.x;
   float y2 = point.y * point.y;
   float z2 = point.z * point.z;
@@ -23,18 +50,17 @@ glm::vec3 CubeSphere::spherify(const glm::vec3 &point) const {
   float y = point.y * sqrt(1.0f - (x2 + z2) / 2.0f + (x2 * z2) / 3.0f);
   float z = point.z * sqrt(1.0f - (x2 + y2) / 2.0f + (x2 * y2) / 3.0f);
 
-  return glm::vec3(x, y, z) * size;
+  return {x, y, z};
 }
 
-void CubeSphere::rebuild() {
-  vertices.clear();
-  normals.clear();
-  indices.clear();
-  buildVertices();
-  buildIndices();
+MeshData CubeSphere::buildMesh(int resolution) {
+  MeshData data;
+  buildVertices(data, resolution);
+  buildIndices(data, resolution);
+  return data;
 }
 
-void CubeSphere::buildVertices() {
+void CubeSphere::buildVertices(MeshData &data, int resolution) {
   float step = 2.0f / resolution;
 
   // Generate vertices for each face
@@ -85,22 +111,19 @@ void CubeSphere::buildVertices() {
           point = glm::vec3(x, y, fixed);
         }
 
+        // Interleaved position and normal (the normalized position)
         glm::vec3 spherePoint = spherify(point);
-        vertices.push_back(spherePoint.x);
-        vertices.push_back(spherePoint.y);
-        vertices.push_back(spherePoint.z);
-
-        // Calculate normal as the normalized position
         glm::vec3 normalizedPos = glm::normalize(spherePoint);
-        normals.push_back(normalizedPos.x);
-        normals.push_back(normalizedPos.y);
-        normals.push_back(normalizedPos.z);
+        data.vertices.insert(data.vertices.end(),
+                             {spherePoint.x, spherePoint.y, spherePoint.z, normalizedPos.x,
+                              normalizedPos.y, normalizedPos.z});
       }
     }
   }
 }
 
-void CubeSphere::buildIndices() {
+void CubeSphere::buildIndices(MeshData &data, int resolution) {
+  auto &indices = data.indices;
   int verticesPerRow = resolution + 1;
   int facesOffset = verticesPerRow * verticesPerRow;
 
@@ -123,53 +146,7 @@ void CubeSphere::buildIndices() {
   }
 }
 
-void CubeSphere::setupBuffers() {
-  // Interleave vertex attributes
-  interleavedVertices.clear();
-  std::size_t vertexCount = vertices.size() / 3;
-  for (std::size_t i = 0; i < vertexCount; ++i) {
-    interleavedVertices.push_back(vertices[i * 3]);     // x
-    interleavedVertices.push_back(vertices[i * 3 + 1]); // y
-    interleavedVertices.push_back(vertices[i * 3 + 2]); // z
-    interleavedVertices.push_back(normals[i * 3]);      // nx
-    interleavedVertices.push_back(normals[i * 3 + 1]);  // ny
-    interleavedVertices.push_back(normals[i * 3 + 2]);  // nz
-  }
-
-  // Create and setup buffers
-  if (VAO == 0) {
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-  }
-
-  glBindVertexArray(VAO);
-
-  // VBO
-  glBindBuffer(GL_ARRAY_BUFFER, VBO);
-  glBufferData(GL_ARRAY_BUFFER, interleavedVertices.size() * sizeof(float),
-               interleavedVertices.data(), GL_STATIC_DRAW);
-
-  // EBO
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(),
-               GL_STATIC_DRAW);
-
-  // Vertex attributes
-  // Position
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)0);
-  glEnableVertexAttribArray(0);
-  // Normal
-  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)(3 * sizeof(float)));
-  glEnableVertexAttribArray(1);
-
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  glBindVertexArray(0);
-}
-
 void CubeSphere::draw(Renderer *renderer) {
   // Basic drawing without any transformation - those are handled by the visitor
-  glBindVertexArray(VAO);
-  glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
-  glBindVertexArray(0);
+  meshes[0]->draw();
 }
@@ -1,11 +1,20 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <glm/glm.hpp>
+#include <memory>
+#include <utility>
 #include <vector>
+#include "Graphics/core/Mesh.h"
+#include "Graphics/core/MeshLibrary.h"
 #include "Graphics/core/Object3D.h"
 #include "Graphics/core/ObjectVisitor.h"
+#include "Graphics/core/Terrain.h"
 #include "Graphics/renderer.h"
 
+class SurfaceMap;
+
 class CubeSphere : public Object3D {
 public:
   explicit CubeSphere(float size = 1.0f, int resolution = 16);
@@ -21,6 +30,14 @@ public:
   void setColor(const glm::vec3 &c) override { color = c; }
   glm::vec3 getColor() const override { return color; }
 
+  float getBoundingRadius() const override {
+    const float relief = terrain.enabled ? 1.0f + glm::max(terrain.heightScale, 0.0f) : 1.0f;
+    return size * relief * glm::max(scale.x, glm::max(scale.y, scale.z));
+  }
+
+  const Mesh &getMesh(int levelOfDetail) const override { return *meshes[levelOfDetail]; }
+  float getMeshScale() const override { return size; }
+
   void draw(Renderer *renderer) override;
   void accept(ObjectVisitor &visitor) override { visitor.visit(*this); }
   void accept(RenderVisitor &visitor) override { visitor.visit(this); }
@@ -35,29 +52,38 @@ public:
   void setResolution(int res);
   int getResolution() const { return resolution; }
 
-  void setSize(const float s) {
-    this->size = s;
-    rebuild();
-  }
+  void setSize(const float s) { this->size = s; }
 
   float getSize() const { return size; }
 
+  // Procedural relief, drawn as a quadtree of chunks when enabled. Any change gives the body a
+  // new terrain id, so chunks cached for the old landscape are never drawn again.
+  const TerrainSettings &getTerrain() const { return terrain; }
+  void setTerrain(const TerrainSettings &settings);
+  std::uint32_t getTerrainId() const { return terrainId; }
+
+  // Color map of the surface, streamed in as the terrain chunks need it. Setting one draws the
+  // body as terrain chunks even without relief. Maps are shared, so bodies can use the same file.
+  const std::shared_ptr<const SurfaceMap> &getSurfaceMap() const { return surfaceMap; }
+  void setSurfaceMap(std::shared_ptr<const SurfaceMap> map) { surfaceMap = std::move(map); }
+
+  // Unit cube sphere geometry; the size is applied through the model matrix.
+  static MeshData buildMesh(int resolution);
+
 private:
-  void rebuild();
-  void buildVertices();
-  void buildIndices();
-  void setupBuffers();
-  glm::vec3 spherify(const glm::vec3 &point) const;
-
-  std::vector<float> vertices;
-  std::vector<float> normals;
-  std::vector<float> interleavedVertices;
-  std::vector<unsigned int> indices;
-  unsigned int VAO{}, VBO{}, EBO{};
+  void acquireMesh();
+  static void buildVertices(MeshData &data, int resolution);
+  static void buildIndices(MeshData &data, int resolution);
+  static glm::vec3 spherify(const glm::vec3 &point);
+
+  std::array<std::shared_ptr<Mesh>, MESH_LOD_COUNT> meshes;
 
   float size;
   int resolution;
   glm::vec3 position{0.0f};
   glm::vec3 scale{1.0f};
   glm::vec3 color{1.0f};
+  TerrainSettings terrain;
+  std::uint32_t terrainId;
+  std::shared_ptr<const SurfaceMap> surfaceMap;
 };
@@ -1,62 +1,62 @@
 #include "sphere.h"
 #include <glad/glad.h> // Fixed include path
+#include <algorithm>
 #include <cmath>
 #include <glm/gtc/matrix_transform.hpp>
+#include "Graphics/core/MeshLibrary.h"
 #include "Graphics/core/RenderVisitor.h"
 
 Sphere::Sphere(float r, int sectors, int stacks)
     : radius(r), sectors(sectors), stacks(stacks) {
-    build();
-    setupBuffers();
+    acquireMesh();
 }
 
 void Sphere::setResolution(int newSectors, int newStacks) {
     sectors = newSectors;
     stacks = newStacks;
-    build();
-    setupBuffers();
+    acquireMesh();
 }
 
-void Sphere::build() {
-    vertices.clear();
-    normals.clear();
-    indices.clear();
-    buildVertices();
-    buildIndices();
+void Sphere::acquireMesh() {
+    // Bodies with the same resolution share one GPU mesh per detail level
+    for (int level = 0; level < MESH_LOD_COUNT; ++level) {
+        const int levelSectors = std::max(sectors >> level, 8);
+        const int levelStacks = std::max(stacks >> level, 4);
+        meshes[level] = getMeshLibrary().acquire(
+            {MeshShape::Sphere, levelSectors, levelStacks},
+            [=] { return buildMesh(levelSectors, levelStacks); });
+    }
+}
+
+MeshData Sphere::buildMesh(int sectors, int stacks) {
+    MeshData data;
+    buildVertices(data, sectors, stacks);
+    buildIndices(data, sectors, stacks);
+    return data;
 }
 
-void Sphere::buildVertices() {
+void Sphere::buildVertices(MeshData& data, int sectors, int stacks) {
     float sectorStep = 2 * M_PI / sectors;
     float stackStep = M_PI / stacks;
 
-    // Generate vertices and normals
+    // Generate interleaved vertices and normals; on a unit sphere they coincide
     for (int i = 0; i <= stacks; ++i) {
         float stackAngle = M_PI / 2 - i * stackStep;
-        float xy = radius * cosf(stackAngle);
-        float z = radius * sinf(stackAngle);
+        float xy = cosf(stackAngle);
+        float z = sinf(stackAngle);
 
         for (int j = 0; j <= sectors; ++j) {
             float sectorAngle = j * sectorStep;
 
-            // Vertex position
             float x = xy * cosf(sectorAngle);
             float y = xy * sinf(sectorAngle);
-            vertices.push_back(x);
-            vertices.push_back(y);
-            vertices.push_back(z);
-
-            // Normalized vertex normal
-            float nx = x / radius;
-            float ny = y / radius;
-            float nz = z / radius;
-            normals.push_back(nx);
-            normals.push_back(ny);
-            normals.push_back(nz);
+            data.vertices.insert(data.vertices.end(), {x, y, z, x, y, z});
         }
     }
 }
 
-void Sphere::buildIndices() {
+void Sphere::buildIndices(MeshData& data, int sectors, int stacks) {
+    auto& indices = data.indices;
     // Generate indices
     for (int i = 0; i < stacks; ++i) {
         int k1 = i * (sectors + 1);
@@ -78,58 +78,7 @@ void Sphere::buildIndices() {
     }
 }
 
-void Sphere::setupBuffers() {
-    // Interleave vertex attributes
-    interleavedVertices.clear();
-    std::size_t vertexCount = vertices.size() / 3;
-    for (std::size_t i = 0; i < vertexCount; ++i) {
-        interleavedVertices.push_back(vertices[i * 3]);     // x
-        interleavedVertices.push_back(vertices[i * 3 + 1]); // y
-        interleavedVertices.push_back(vertices[i * 3 + 2]); // z
-        interleavedVertices.push_back(normals[i * 3]);      // nx
-        interleavedVertices.push_back(normals[i * 3 + 1]);  // ny
-        interleavedVertices.push_back(normals[i * 3 + 2]);  // nz
-    }
-
-    // Create and setup buffers
-    if (VAO == 0) {
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
-        glGenBuffers(1, &EBO);
-    }
-
-    glBindVertexArray(VAO);
-
-    // VBO
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, interleavedVertices.size() * sizeof(float),
-                 interleavedVertices.data(), GL_STATIC_DRAW);
-
-    // EBO
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
-                 indices.data(), GL_STATIC_DRAW);
-
-    // Vertex attributes
-    // Position
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // Normal
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-}
-
 void Sphere::draw(Renderer* renderer) {
     // Basic drawing without any transformation - those are handled by the visitor
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    meshes[0]->draw();
 }
-
-// void Sphere::accept(RenderVisitor& visitor) {
-//     visitor.visit(this);
-// }
-
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <array>
 #include <glm/glm.hpp>
+#include <memory>
 #include <vector>
+#include "Graphics/core/Mesh.h"
+#include "Graphics/core/MeshLibrary.h"
 #include "Graphics/core/Object3D.h"
 #include "Graphics/core/ObjectVisitor.h"
 #include "Graphics/renderer.h"
@@ -21,6 +25,13 @@ public:
   void setColor(const glm::vec3 &c) override { color = c; }
   glm::vec3 getColor() const override { return color; }
 
+  float getBoundingRadius() const override {
+    return radius * glm::max(scale.x, glm::max(scale.y, scale.z));
+  }
+
+  const Mesh &getMesh(int levelOfDetail) const override { return *meshes[levelOfDetail]; }
+  float getMeshScale() const override { return radius; }
+
   void draw(Renderer *renderer) override; // Changed from Renderer& to Renderer*
   void accept(ObjectVisitor &visitor) override { visitor.visit(*this); }
   void accept(RenderVisitor &visitor) override { visitor.visit(this); }
@@ -36,23 +47,17 @@ public:
   int getSectorCount() const { return sectors; }
   int getStackCount() const { return stacks; }
   float getRadius() const { return radius; }
-  void setRadius(const float radius) {
-    this->radius = radius;
-    build();
-    setupBuffers();
-  }
+  void setRadius(const float radius) { this->radius = radius; }
+
+  // Unit sphere geometry; the radius is applied through the model matrix.
+  static MeshData buildMesh(int sectors, int stacks);
 
 private:
-  void build();
-  void buildVertices();
-  void buildIndices();
-  void setupBuffers();
-
-  std::vector<float> vertices;
-  std::vector<float> normals;
-  std::vector<float> interleavedVertices;
-  std::vector<unsigned int> indices;
-  unsigned int VAO{}, VBO{}, EBO{};
+  void acquireMesh();
+  static void buildVertices(MeshData &data, int sectors, int stacks);
+  static void buildIndices(MeshData &data, int sectors, int stacks);
+
+  std::array<std::shared_ptr<Mesh>, MESH_LOD_COUNT> meshes;
 
   float radius;
   int sectors;
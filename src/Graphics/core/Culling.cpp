@@ -0,0 +1,99 @@
+#include "Culling.h"
+#include <algorithm>
+#include <numeric>
+#include "MeshLibrary.h"
+#include "core/thread_pool.h"
+
+namespace {
+
+constexpr std::size_t CULL_GRAIN = 16384;
+// Below this many bodies the pass is cheaper than waking the pool.
+constexpr std::size_t PARALLEL_THRESHOLD = 4 * CULL_GRAIN;
+// Minimum on-screen radius, in pixels, for each detail level.
+constexpr float LOD_PIXEL_THRESHOLDS[MESH_LOD_COUNT - 1] = {64.0F, 24.0F, 8.0F};
+
+} // namespace
+
+Frustum Frustum::fromViewProjection(const glm::mat4 &m) {
+  // Gribb-Hartmann: each plane is the fourth row of the matrix plus or minus another row.
+  const glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+  const glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+  const glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+  const glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+  Frustum frustum{{row3 + row0, row3 - row0, row3 + row1, row3 - row1, row3 + row2, row3 - row2}};
+  for (auto &plane : frustum.planes) {
+    plane /= glm::length(glm::vec3(plane));
+  }
+  return frustum;
+}
+
+void CullingPass::clear() {
+  x.clear();
+  y.clear();
+  z.clear();
+  radius.clear();
+}
+
+void CullingPass::add(const glm::vec3 &center, float sphereRadius) {
+  x.push_back(center.x);
+  y.push_back(center.y);
+  z.push_back(center.z);
+  radius.push_back(sphereRadius);
+}
+
+void CullingPass::runRange(const Frustum &frustum, const glm::vec4 &depthRow, float pixelScale,
+                           std::size_t begin, std::size_t end) {
+  const float *px = x.data();
+  const float *py = y.data();
+  const float *pz = z.data();
+  const float *pr = radius.data();
+  std::uint8_t *out = visible.data();
+  float *pixels = pixelRadius.data();
+
+  for (std::size_t i = begin; i < end; ++i) {
+    out[i] = 1;
+  }
+  for (const auto &plane : frustum.planes) {
+    for (std::size_t i = begin; i < end; ++i) {
+      const float distance = (plane.x * px[i]) + (plane.y * py[i]) + (plane.z * pz[i]) + plane.w;
+      out[i] &= static_cast<std::uint8_t>(distance >= -pr[i]);
+    }
+  }
+  for (std::size_t i = begin; i < end; ++i) {
+    // Distance in front of the camera; spheres reaching behind it count as very close.
+    const float depth =
+        -((depthRow.x * px[i]) + (depthRow.y * py[i]) + (depthRow.z * pz[i]) + depthRow.w);
+    pixels[i] = pr[i] * pixelScale / std::max(depth - pr[i], 1.0e-4F);
+  }
+}
+
+void CullingPass::run(const glm::mat4 &view, const glm::mat4 &projection, float viewportHeight,
+                      ThreadPool &pool) {
+  const std::size_t count = radius.size();
+  visible.resize(count);
+  pixelRadius.resize(count);
+
+  const Frustum frustum = Frustum::fromViewProjection(projection * view);
+  const glm::vec4 depthRow(view[0][2], view[1][2], view[2][2], view[3][2]);
+  // projection[1][1] is cot(fov / 2): a radius r at depth d spans r * cot / d of half the
+  // viewport.
+  const float pixelScale = projection[1][1] * 0.5F * viewportHeight;
+
+  if (count < PARALLEL_THRESHOLD) {
+    runRange(frustum, depthRow, pixelScale, 0, count);
+  } else {
+    pool.parallelFor(count, CULL_GRAIN, [&](std::size_t begin, std::size_t end) {
+      runRange(frustum, depthRow, pixelScale, begin, end);
+    });
+  }
+  visibleCount = std::accumulate(visible.begin(), visible.end(), std::size_t{0});
+}
+
+int selectLevelOfDetail(float pixelRadius) {
+  int level = 0;
+  while (level < MESH_LOD_COUNT - 1 && pixelRadius < LOD_PIXEL_THRESHOLDS[level]) {
+    ++level;
+  }
+  return level;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+class ThreadPool;
+
+// Frustum planes (a, b, c, d) with inward-facing unit normals, so a point p is inside when
+// dot(abc, p) + d >= 0 for all six planes.
+struct Frustum {
+  glm::vec4 planes[6];
+
+  static Frustum fromViewProjection(const glm::mat4 &viewProjection);
+};
+
+// Batched visibility and screen-size pass over bounding spheres. Centers and radii are kept as
+// separate arrays and each plane is tested over the whole batch in a branch-free loop, so the
+// compiler can vectorize the tests.
+class CullingPass {
+public:
+  void clear();
+  void add(const glm::vec3 &center, float radius);
+
+  // Tests every sphere against the frustum and estimates its on-screen radius in pixels.
+  void run(const glm::mat4 &view, const glm::mat4 &projection, float viewportHeight,
+           ThreadPool &pool);
+
+  std::size_t size() const { return radius.size(); }
+  bool isVisible(std::size_t i) const { return visible[i] != 0; }
+  float getPixelRadius(std::size_t i) const { return pixelRadius[i]; }
+  std::size_t getVisibleCount() const { return visibleCount; }
+
+private:
+  void runRange(const Frustum &frustum, const glm::vec4 &depthRow, float pixelScale,
+                std::size_t begin, std::size_t end);
+
+  std::vector<float> x, y, z, radius;
+  std::vector<std::uint8_t> visible;
+  std::vector<float> pixelRadius;
+  std::size_t visibleCount = 0;
+};
+
+// Mesh detail level for a body covering `pixelRadius` pixels; 0 is the full resolution.
+int selectLevelOfDetail(float pixelRadius);
@@ -0,0 +1,61 @@
+#include "GLStateCache.h"
+#include <glad/glad.h>
+
+void GLStateCache::invalidate() {
+  program = -1;
+  vertexArray = -1;
+  arrayBuffer = -1;
+  blend = -1;
+  wireframe = -1;
+  skippedChanges = 0;
+}
+
+void GLStateCache::useProgram(unsigned int newProgram) {
+  if (program == newProgram) {
+    ++skippedChanges;
+    return;
+  }
+  program = newProgram;
+  glUseProgram(newProgram);
+}
+
+void GLStateCache::bindVertexArray(unsigned int newVertexArray) {
+  if (vertexArray == newVertexArray) {
+    ++skippedChanges;
+    return;
+  }
+  vertexArray = newVertexArray;
+  glBindVertexArray(newVertexArray);
+}
+
+void GLStateCache::bindArrayBuffer(unsigned int newBuffer) {
+  if (arrayBuffer == newBuffer) {
+    ++skippedChanges;
+    return;
+  }
+  arrayBuffer = newBuffer;
+  glBindBuffer(GL_ARRAY_BUFFER, newBuffer);
+}
+
+void GLStateCache::setBlend(bool enabled) {
+  if (blend == static_cast<int>(enabled)) {
+    ++skippedChanges;
+    return;
+  }
+  blend = static_cast<int>(enabled);
+  if (enabled) {
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  } else {
+    glDisable(GL_BLEND);
+  }
+}
+
+void GLStateCache::setWireframe(bool enabled) {
+  if (wireframe == static_cast<int>(enabled)) {
+    ++skippedChanges;
+    return;
+  }
+  wireframe = static_cast<int>(enabled);
+  glPolygonMode(GL_FRONT_AND_BACK, enabled ? GL_LINE : GL_FILL);
+}
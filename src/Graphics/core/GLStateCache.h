@@ -0,0 +1,28 @@
+#pragma once
+
+// Shadow copy of the GL state the renderer changes most often. Each setter only reaches the
+// driver when the value actually differs. Anything else that touches GL (ImGui, shader
+// compilation, buffer uploads) can leave the real state out of sync, so call invalidate()
+// at the start of every frame.
+class GLStateCache {
+public:
+  void invalidate();
+
+  void useProgram(unsigned int program);
+  void bindVertexArray(unsigned int vertexArray);
+  void bindArrayBuffer(unsigned int buffer);
+  void setBlend(bool enabled);
+  void setWireframe(bool enabled);
+
+  // Number of GL calls the cache has skipped since the last invalidate().
+  int getSkippedChanges() const { return skippedChanges; }
+
+private:
+  // -1 marks state that has not been set through the cache yet.
+  long long program = -1;
+  long long vertexArray = -1;
+  long long arrayBuffer = -1;
+  int blend = -1;
+  int wireframe = -1;
+  int skippedChanges = 0;
+};
@@ -0,0 +1,191 @@
+#include "GravityWellRenderer.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <utility>
+#include "GLStateCache.h"
+#include "Graphics/shader.h"
+#include "Graphics/uniformBuffer.h"
+#include "Simulation/BodyStorage.h"
+#include "core/thread_pool.h"
+
+namespace {
+
+// Cells from the center to each edge of the surface mesh, and how much wider each is than
+// the one inside it.
+constexpr int WELL_MESH_HALF_CELLS = 96;
+constexpr float WELL_MESH_GROWTH = 0.04f;
+
+} // namespace
+
+GravityWellRenderer::GravityWellRenderer(std::shared_ptr<Shader> wellShader)
+    : shader(std::move(wellShader)),
+      wellsBlock(std::make_unique<UniformBuffer>(WELLS_BLOCK_BINDING, sizeof(WellsBlock))) {
+  buildMesh();
+
+  // Single zero sample until the first pass lands
+  const float zero = 0.0f;
+  glGenTextures(1, &fieldTexture);
+  glBindTexture(GL_TEXTURE_2D, fieldTexture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, 1, 1, 0, GL_RED, GL_FLOAT, &zero);
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+GravityWellRenderer::~GravityWellRenderer() {
+  // The pass writes into `samples`, so it has to finish first
+  if (pending.valid()) {
+    pending.wait();
+  }
+  glDeleteTextures(1, &fieldTexture);
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteBuffers(1, &VBO);
+  glDeleteBuffers(1, &EBO);
+}
+
+void GravityWellRenderer::buildMesh() {
+  // Local coordinates in [-1, 1]; ring i sits at ((1 + g)^i - 1) / ((1 + g)^N - 1)
+  constexpr int n = WELL_MESH_HALF_CELLS;
+  constexpr int side = (2 * n) + 1;
+  const float outer = std::pow(1.0f + WELL_MESH_GROWTH, static_cast<float>(n)) - 1.0f;
+  std::vector<float> rings(side);
+  for (int i = -n; i <= n; ++i) {
+    const float ring =
+        (std::pow(1.0f + WELL_MESH_GROWTH, static_cast<float>(std::abs(i))) - 1.0f) / outer;
+    rings[i + n] = i < 0 ? -ring : ring;
+  }
+  innerSpacing = rings[n + 1];
+
+  std::vector<glm::vec2> vertices;
+  vertices.reserve(static_cast<size_t>(side) * side);
+  for (int z = 0; z < side; ++z) {
+    for (int x = 0; x < side; ++x) {
+      vertices.emplace_back(rings[x], rings[z]);
+    }
+  }
+
+  std::vector<unsigned int> indices;
+  indices.reserve(static_cast<size_t>(side - 1) * (side - 1) * 6);
+  for (int z = 0; z + 1 < side; ++z) {
+    for (int x = 0; x + 1 < side; ++x) {
+      const auto corner = static_cast<unsigned int>((z * side) + x);
+      const auto below = corner + static_cast<unsigned int>(side);
+      indices.insert(indices.end(), {corner, below, corner + 1, corner + 1, below, below + 1});
+    }
+  }
+  indexCount = static_cast<int>(indices.size());
+
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &VBO);
+  glGenBuffers(1, &EBO);
+
+  glBindVertexArray(VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec2), vertices.data(),
+               GL_STATIC_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(),
+               GL_STATIC_DRAW);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void *)0);
+  glEnableVertexAttribArray(0);
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GravityWellRenderer::update(const sim::BodyStorage &bodies, std::uint64_t revision,
+                                 double centralMu, const glm::vec3 &cameraPosition,
+                                 float halfExtent, const GravityWellStyle &style) {
+  // Snap to the innermost ring's width so the vertices near the camera keep sampling the same
+  // points as it moves, rather than swimming through the wells
+  const float step = std::max(halfExtent * innerSpacing, 1e-6f);
+  const glm::vec2 center = glm::round(glm::vec2(cameraPosition.x, cameraPosition.z) / step) * step;
+
+  WellsBlock block{};
+  int count = 0;
+  if (centralMu > 0.0) {
+    block.bodies[count++] = glm::vec4(0.0f, 0.0f, 0.0f, static_cast<float>(centralMu));
+  }
+  size_t massive = 0;
+  for (size_t i = 0; i < bodies.size(); ++i) {
+    massive += bodies.mass[i] > 0.0 ? 1 : 0;
+  }
+
+  fieldInUse = massive > static_cast<size_t>(MAX_WELL_BODIES - count);
+  if (!fieldInUse) {
+    for (size_t i = 0; i < bodies.size(); ++i) {
+      if (bodies.mass[i] > 0.0) {
+        block.bodies[count++] =
+            glm::vec4(glm::vec3(bodies.position(i)), static_cast<float>(bodies.mass[i]));
+      }
+    }
+  }
+
+  // At most one pass in flight: take the finished one, then resample if anything moved since
+  if (pending.valid() &&
+      pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+    pending.get();
+    uploadField();
+  }
+  const FieldKey key{revision, center, halfExtent, style};
+  if (fieldInUse && !pending.valid() && sampledKey != key) {
+    sampledKey = key;
+    startSampling(bodies, center, halfExtent, style);
+  }
+
+  block.surface = glm::vec4(center.x, center.y, halfExtent, style.depthScale);
+  block.field = glm::vec4(static_cast<float>(count), style.softening, style.maxDepth,
+                          fieldInUse && hasField ? 1.0f : 0.0f);
+  block.region = fieldRegion;
+  wellsBlock->update(block);
+}
+
+void GravityWellRenderer::startSampling(const sim::BodyStorage &bodies, const glm::vec2 &center,
+                                        float halfExtent, const GravityWellStyle &style) {
+  // The pass works on its own copy of the massive bodies, so the scene can move on meanwhile
+  sim::BodyStorage snapshot;
+  for (size_t i = 0; i < bodies.size(); ++i) {
+    if (bodies.mass[i] > 0.0) {
+      snapshot.add(bodies.position(i), glm::dvec3(0.0), bodies.mass[i], 0.0);
+    }
+  }
+
+  pendingGrid.center = glm::dvec2(center);
+  pendingGrid.halfExtent = halfExtent;
+  pendingGrid.resolution = std::max(style.fieldResolution, 2);
+  pendingGrid.softening = style.softening;
+  pendingGrid.openingAngle = style.openingAngle;
+  pending = std::async(std::launch::async, [this, snapshot = std::move(snapshot),
+                                            grid = pendingGrid] {
+    sim::samplePotential(snapshot, grid, samples, getThreadPool());
+  });
+}
+
+void GravityWellRenderer::uploadField() {
+  const int resolution = pendingGrid.resolution;
+  glBindTexture(GL_TEXTURE_2D, fieldTexture);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, resolution, resolution, 0, GL_RED, GL_FLOAT,
+               samples.data());
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  fieldRegion = glm::vec4(static_cast<float>(pendingGrid.center.x),
+                          static_cast<float>(pendingGrid.center.y),
+                          static_cast<float>(pendingGrid.halfExtent), 0.0f);
+  hasField = true;
+}
+
+void GravityWellRenderer::draw(GLStateCache &state) {
+  state.useProgram(shader->getID());
+  shader->setInt("potentialMap", 0);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, fieldTexture);
+
+  state.setBlend(true);
+  state.bindVertexArray(VAO);
+  glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
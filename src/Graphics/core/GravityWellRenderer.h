@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <glm/glm.hpp>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "Simulation/Potential.h"
+
+class GLStateCache;
+class Shader;
+class UniformBuffer;
+
+namespace sim {
+struct BodyStorage;
+}
+
+struct GravityWellStyle {
+  float depthScale = 1.0f;     // depth per unit of potential
+  float maxDepth = 10.0f;      // wells are clamped here instead of reaching down to -infinity
+  float softening = 0.1f;      // scene units added in quadrature to every distance
+  int fieldResolution = 128;   // samples per side of the potential texture
+  float openingAngle = 0.5f;   // Barnes-Hut accuracy of the potential texture
+
+  bool operator==(const GravityWellStyle &) const = default;
+};
+
+// The ground grid pulled down into the gravitational potential of the scene's masses. The
+// surface is one static mesh centered under the camera whose rings widen geometrically
+// outward, so vertices are dense where the grid is seen up close and sparse toward the fade
+// distance. The central mass is always summed in the vertex shader. A handful of massive bulk
+// bodies are summed there too; past that, a background pass samples their potential into a
+// texture with a Barnes-Hut octree and the vertex shader reads it instead.
+class GravityWellRenderer {
+public:
+  explicit GravityWellRenderer(std::shared_ptr<Shader> shader);
+  ~GravityWellRenderer();
+
+  GravityWellRenderer(const GravityWellRenderer &) = delete;
+  GravityWellRenderer &operator=(const GravityWellRenderer &) = delete;
+
+  // Places the surface under the camera, `halfExtent` to a side, and gathers this frame's
+  // wells. A finished potential pass is uploaded here. Another is started only once the
+  // bodies (by `revision`), the snapped center, the extent or the style differ from the last.
+  void update(const sim::BodyStorage &bodies, std::uint64_t revision, double centralMu,
+              const glm::vec3 &cameraPosition, float halfExtent, const GravityWellStyle &style);
+  void draw(GLStateCache &state);
+
+  bool isFieldSampled() const { return fieldInUse; }
+  // A potential pass is running, so the surface will change again without any edits
+  bool isSampling() const { return pending.valid(); }
+
+private:
+  // Everything a potential pass depends on
+  struct FieldKey {
+    std::uint64_t revision = 0;
+    glm::vec2 center{0.0f};
+    float halfExtent = 0.0f;
+    GravityWellStyle style;
+
+    bool operator==(const FieldKey &) const = default;
+  };
+
+  void buildMesh();
+  void startSampling(const sim::BodyStorage &bodies, const glm::vec2 &center, float halfExtent,
+                     const GravityWellStyle &style);
+  void uploadField();
+
+  std::shared_ptr<Shader> shader;
+  std::unique_ptr<UniformBuffer> wellsBlock;
+  unsigned int VAO{}, VBO{}, EBO{};
+  int indexCount = 0;
+  float innerSpacing = 0.0f; // local width of the innermost ring, for snapping
+
+  // Potential texture and the background pass filling the next one. `samples` belongs to the
+  // pass while `pending` is running.
+  unsigned int fieldTexture = 0;
+  std::future<void> pending;
+  sim::PotentialGrid pendingGrid;
+  std::vector<float> samples;
+  glm::vec4 fieldRegion{0.0f};
+  bool hasField = false;
+  bool fieldInUse = false;
+  std::optional<FieldKey> sampledKey; // of the pass in flight, or else the last one uploaded
+};
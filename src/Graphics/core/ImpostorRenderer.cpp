@@ -0,0 +1,66 @@
+#include "ImpostorRenderer.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include "GLStateCache.h"
+#include "Graphics/shader.h"
+
+ImpostorRenderer::ImpostorRenderer(std::shared_ptr<Shader> impostorShader)
+    : shader(std::move(impostorShader)) {
+  const float corners[] = {-1.0F, -1.0F, 1.0F, -1.0F, -1.0F, 1.0F, 1.0F, 1.0F};
+
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &quadVBO);
+  glGenBuffers(1, &instanceVBO);
+
+  glBindVertexArray(VAO);
+
+  // Quad corners, drawn as a triangle strip
+  glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
+  glEnableVertexAttribArray(0);
+
+  // Per-instance sphere and color
+  glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+  glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+                        (void *)offsetof(Instance, sphere));
+  glEnableVertexAttribArray(1);
+  glVertexAttribDivisor(1, 1);
+  glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+                        (void *)offsetof(Instance, color));
+  glEnableVertexAttribArray(2);
+  glVertexAttribDivisor(2, 1);
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindVertexArray(0);
+}
+
+ImpostorRenderer::~ImpostorRenderer() {
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteBuffers(1, &quadVBO);
+  glDeleteBuffers(1, &instanceVBO);
+}
+
+void ImpostorRenderer::add(const glm::vec3 &center, float radius, const glm::vec3 &color) {
+  instances.push_back({glm::vec4(center, radius), glm::vec4(color, 1.0F)});
+}
+
+void ImpostorRenderer::draw(GLStateCache &state) {
+  if (instances.empty()) {
+    return;
+  }
+
+  // Orphan the previous frame's storage so the driver never stalls on a buffer still in use.
+  state.bindArrayBuffer(instanceVBO);
+  instanceCapacity = std::max(instanceCapacity, instances.size());
+  glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(Instance), nullptr, GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(Instance), instances.data());
+
+  state.useProgram(shader->getID());
+  state.setBlend(false);
+  state.setWireframe(false);
+  state.bindVertexArray(VAO);
+  glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(instances.size()));
+}
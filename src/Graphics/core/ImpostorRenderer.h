@@ -0,0 +1,37 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+class GLStateCache;
+class Shader;
+
+// Draws spheres as camera-facing quads, ray-casting each pixel in the fragment shader for an
+// exact silhouette, normal and depth. Meant for bodies a few to a few dozen pixels across,
+// where a mesh would spend hundreds of triangles on a handful of pixels.
+class ImpostorRenderer {
+public:
+  explicit ImpostorRenderer(std::shared_ptr<Shader> shader);
+  ~ImpostorRenderer();
+
+  ImpostorRenderer(const ImpostorRenderer &) = delete;
+  ImpostorRenderer &operator=(const ImpostorRenderer &) = delete;
+
+  void clear() { instances.clear(); }
+  void add(const glm::vec3 &center, float radius, const glm::vec3 &color);
+  void draw(GLStateCache &state);
+
+  std::size_t size() const { return instances.size(); }
+
+private:
+  struct Instance {
+    glm::vec4 sphere; // center, radius
+    glm::vec4 color;
+  };
+
+  std::shared_ptr<Shader> shader;
+  std::vector<Instance> instances;
+  unsigned int VAO{}, quadVBO{}, instanceVBO{};
+  std::size_t instanceCapacity = 0;
+};
@@ -0,0 +1,197 @@
+#include "LightClusters.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include "Graphics/lighting/Light.h"
+#include "core/thread_pool.h"
+
+namespace {
+
+constexpr int TILES_PER_SLICE = CLUSTER_TILES_X * CLUSTER_TILES_Y;
+
+void createBufferTexture(unsigned int &buffer, unsigned int &texture, GLenum format) {
+  glGenBuffers(1, &buffer);
+  glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+  glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_BUFFER, texture);
+  glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+  glBindTexture(GL_TEXTURE_BUFFER, 0);
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+// Orphans the old storage so the upload never waits on a frame still reading it. Buffer
+// textures follow their buffer, so the texture needs no update.
+void uploadBuffer(unsigned int buffer, const void *data, std::size_t size) {
+  glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+  glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(std::max<std::size_t>(size, 16)),
+               nullptr, GL_STREAM_DRAW);
+  if (size > 0) {
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, static_cast<GLsizeiptr>(size), data);
+  }
+}
+
+} // namespace
+
+LightClusters::LightClusters()
+    : clusterMinX(CLUSTER_COUNT), clusterMaxX(CLUSTER_COUNT), clusterMinY(CLUSTER_COUNT),
+      clusterMaxY(CLUSTER_COUNT), sliceNear(CLUSTER_SLICES), sliceFar(CLUSTER_SLICES),
+      sliceIndices(CLUSTER_SLICES), sliceHits(CLUSTER_SLICES), clusters(CLUSTER_COUNT) {
+  createBufferTexture(lightBuffer, lightTexture, GL_RGBA32F);
+  createBufferTexture(clusterBuffer, clusterTexture, GL_RG32UI);
+  createBufferTexture(indexBuffer, indexTexture, GL_R32UI);
+}
+
+LightClusters::~LightClusters() {
+  const unsigned int textures[] = {lightTexture, clusterTexture, indexTexture};
+  const unsigned int buffers[] = {lightBuffer, clusterBuffer, indexBuffer};
+  glDeleteTextures(3, textures);
+  glDeleteBuffers(3, buffers);
+}
+
+void LightClusters::buildClusterBounds(const glm::mat4 &projection, float nearPlane,
+                                       float farPlane) {
+  const float ratio = farPlane / nearPlane;
+  for (int slice = 0; slice < CLUSTER_SLICES; ++slice) {
+    sliceNear[slice] = nearPlane * std::pow(ratio, static_cast<float>(slice) / CLUSTER_SLICES);
+    sliceFar[slice] = nearPlane * std::pow(ratio, static_cast<float>(slice + 1) / CLUSTER_SLICES);
+  }
+
+  // A tile spanning [ndc0, ndc1] covers view-space x in [ndc0, ndc1] * depth / projection[0][0].
+  // The cross-section grows with depth, so each box is the union of both ends of its slice.
+  for (int slice = 0; slice < CLUSTER_SLICES; ++slice) {
+    for (int y = 0; y < CLUSTER_TILES_Y; ++y) {
+      for (int x = 0; x < CLUSTER_TILES_X; ++x) {
+        const int cluster = (slice * TILES_PER_SLICE) + (y * CLUSTER_TILES_X) + x;
+        const float x0 = ((2.0F * x / CLUSTER_TILES_X) - 1.0F) / projection[0][0];
+        const float x1 = ((2.0F * (x + 1) / CLUSTER_TILES_X) - 1.0F) / projection[0][0];
+        const float y0 = ((2.0F * y / CLUSTER_TILES_Y) - 1.0F) / projection[1][1];
+        const float y1 = ((2.0F * (y + 1) / CLUSTER_TILES_Y) - 1.0F) / projection[1][1];
+        clusterMinX[cluster] = std::min(x0 * sliceNear[slice], x0 * sliceFar[slice]);
+        clusterMaxX[cluster] = std::max(x1 * sliceNear[slice], x1 * sliceFar[slice]);
+        clusterMinY[cluster] = std::min(y0 * sliceNear[slice], y0 * sliceFar[slice]);
+        clusterMaxY[cluster] = std::max(y1 * sliceNear[slice], y1 * sliceFar[slice]);
+      }
+    }
+  }
+  boundsProjection = projection;
+  boundsNear = nearPlane;
+  boundsFar = farPlane;
+}
+
+void LightClusters::update(const std::vector<std::shared_ptr<Light>> &lights,
+                           const glm::mat4 &view, const glm::mat4 &projection, float nearPlane,
+                           float farPlane, const glm::vec2 &viewport, ThreadPool &pool,
+                           LightsBlock &block) {
+  if (projection != boundsProjection || nearPlane != boundsNear || farPlane != boundsFar) {
+    buildClusterBounds(projection, nearPlane, farPlane);
+  }
+
+  // Unbounded lights first, so a shader can walk them without an index list
+  const std::size_t count = std::min<std::size_t>(lights.size(), MAX_LIGHTS);
+  lightData.clear();
+  viewSpheres.clear();
+  for (int pass = 0; pass < 2; ++pass) {
+    for (std::size_t i = 0; i < count; ++i) {
+      const Light &light = *lights[i];
+      const bool ranged = light.getRange() > 0.0F;
+      if (ranged != (pass == 1)) {
+        continue;
+      }
+      lightData.push_back({glm::vec4(light.getPosition(), std::max(light.getRange(), 0.0F)),
+                           glm::vec4(light.getColor(), light.getIntensity()),
+                           glm::vec4(light.getAmbientStrength(), light.getDiffuseStrength(),
+                                     light.getSpecularStrength(), light.getShininess())});
+      if (ranged) {
+        // View space looks down -z; store the center's depth as a positive distance
+        const glm::vec3 center = glm::vec3(view * glm::vec4(light.getPosition(), 1.0F));
+        viewSpheres.emplace_back(center.x, center.y, -center.z, light.getRange());
+      }
+    }
+    if (pass == 0) {
+      unboundedCount = lightData.size();
+    }
+  }
+
+  pool.parallelFor(CLUSTER_SLICES, 1, [this](std::size_t begin, std::size_t end) {
+    for (std::size_t slice = begin; slice < end; ++slice) {
+      binSlice(static_cast<int>(slice));
+    }
+  });
+
+  // Concatenate the slices' lists and point every cluster at its range
+  indices.clear();
+  maxClusterLights = 0;
+  for (int slice = 0; slice < CLUSTER_SLICES; ++slice) {
+    const auto &hits = sliceHits[slice];
+    const auto &candidates = sliceIndices[slice];
+    for (int tile = 0; tile < TILES_PER_SLICE; ++tile) {
+      const auto offset = static_cast<std::uint32_t>(indices.size());
+      for (std::size_t c = 0; c < candidates.size(); ++c) {
+        if (hits[(c * TILES_PER_SLICE) + tile] != 0) {
+          indices.push_back(candidates[c]);
+        }
+      }
+      const auto lightCount = static_cast<std::uint32_t>(indices.size()) - offset;
+      clusters[(slice * TILES_PER_SLICE) + tile] = glm::uvec2(offset, lightCount);
+      maxClusterLights = std::max<std::size_t>(maxClusterLights, lightCount);
+    }
+  }
+  upload();
+
+  block.clusterGrid = glm::vec4(CLUSTER_TILES_X, CLUSTER_TILES_Y, CLUSTER_SLICES,
+                                static_cast<float>(unboundedCount));
+  block.clusterDepth =
+      glm::vec4(nearPlane, CLUSTER_SLICES / std::log(farPlane / nearPlane), 0.0F, 0.0F);
+  block.viewport = glm::vec4(viewport, 0.0F, 0.0F);
+}
+
+void LightClusters::binSlice(int slice) {
+  auto &candidates = sliceIndices[slice];
+  auto &hits = sliceHits[slice];
+  candidates.clear();
+
+  // Lights whose depth range reaches this slice, then each against every tile of it
+  const float zNear = sliceNear[slice];
+  const float zFar = sliceFar[slice];
+  for (std::size_t i = 0; i < viewSpheres.size(); ++i) {
+    const glm::vec4 &sphere = viewSpheres[i];
+    if (sphere.z + sphere.w >= zNear && sphere.z - sphere.w <= zFar) {
+      candidates.push_back(static_cast<std::uint32_t>(unboundedCount + i));
+    }
+  }
+  hits.resize(candidates.size() * TILES_PER_SLICE);
+
+  const std::size_t first = static_cast<std::size_t>(slice) * TILES_PER_SLICE;
+  const float *minX = &clusterMinX[first];
+  const float *maxX = &clusterMaxX[first];
+  const float *minY = &clusterMinY[first];
+  const float *maxY = &clusterMaxY[first];
+  for (std::size_t c = 0; c < candidates.size(); ++c) {
+    const glm::vec4 &sphere = viewSpheres[candidates[c] - unboundedCount];
+    const float dz = std::max({zNear - sphere.z, sphere.z - zFar, 0.0F});
+    const float radius2 = (sphere.w * sphere.w) - (dz * dz);
+    std::uint8_t *out = &hits[c * TILES_PER_SLICE];
+    for (int tile = 0; tile < TILES_PER_SLICE; ++tile) {
+      const float dx = std::max(std::max(minX[tile] - sphere.x, sphere.x - maxX[tile]), 0.0F);
+      const float dy = std::max(std::max(minY[tile] - sphere.y, sphere.y - maxY[tile]), 0.0F);
+      out[tile] = static_cast<std::uint8_t>((dx * dx) + (dy * dy) <= radius2);
+    }
+  }
+}
+
+void LightClusters::upload() {
+  uploadBuffer(lightBuffer, lightData.data(), lightData.size() * sizeof(LightData));
+  uploadBuffer(clusterBuffer, clusters.data(), clusters.size() * sizeof(glm::uvec2));
+  uploadBuffer(indexBuffer, indices.data(), indices.size() * sizeof(std::uint32_t));
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+  // These units are reserved for the light textures, so the bindings stay put between frames
+  glActiveTexture(GL_TEXTURE0 + LIGHT_DATA_TEXTURE_UNIT);
+  glBindTexture(GL_TEXTURE_BUFFER, lightTexture);
+  glActiveTexture(GL_TEXTURE0 + LIGHT_CLUSTERS_TEXTURE_UNIT);
+  glBindTexture(GL_TEXTURE_BUFFER, clusterTexture);
+  glActiveTexture(GL_TEXTURE0 + LIGHT_INDICES_TEXTURE_UNIT);
+  glBindTexture(GL_TEXTURE_BUFFER, indexTexture);
+  glActiveTexture(GL_TEXTURE0);
+}
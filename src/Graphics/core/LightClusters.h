@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include "Graphics/uniformBuffer.h"
+
+class Light;
+class ThreadPool;
+
+// Froxel grid the view frustum is divided into: screen tiles in x and y, and slices in z whose
+// depth grows geometrically from the near plane, so clusters stay roughly cubical.
+constexpr int CLUSTER_TILES_X = 16;
+constexpr int CLUSTER_TILES_Y = 9;
+constexpr int CLUSTER_SLICES = 24;
+constexpr int CLUSTER_COUNT = CLUSTER_TILES_X * CLUSTER_TILES_Y * CLUSTER_SLICES;
+
+// Clustered forward lighting. Lights without a range reach every fragment and are listed
+// once; ranged lights are binned each frame into the clusters their spheres overlap, so a
+// fragment only evaluates the lights of its own cluster. Binning runs slice by slice on the
+// thread pool, testing one light against a whole slice of cluster boxes in a branch-free loop.
+// The lights, per-cluster ranges and light lists go to the GPU as buffer textures bound to the
+// units in SHARED_SAMPLERS.
+class LightClusters {
+public:
+  LightClusters();
+  ~LightClusters();
+
+  LightClusters(const LightClusters &) = delete;
+  LightClusters &operator=(const LightClusters &) = delete;
+
+  // Bins `lights` for a symmetric perspective projection and uploads the result. `block` is
+  // filled with what the shaders need to find a fragment's cluster.
+  void update(const std::vector<std::shared_ptr<Light>> &lights, const glm::mat4 &view,
+              const glm::mat4 &projection, float nearPlane, float farPlane,
+              const glm::vec2 &viewport, ThreadPool &pool, LightsBlock &block);
+
+  std::size_t getLightCount() const { return lightData.size(); }
+  std::size_t getUnboundedLightCount() const { return unboundedCount; }
+  std::size_t getIndexCount() const { return indices.size(); }
+  std::size_t getMaxClusterLights() const { return maxClusterLights; }
+
+private:
+  void buildClusterBounds(const glm::mat4 &projection, float nearPlane, float farPlane);
+  void binSlice(int slice);
+  void upload();
+
+  // View-space bounds of every cluster, slice-major, with depth as a positive distance
+  std::vector<float> clusterMinX, clusterMaxX, clusterMinY, clusterMaxY;
+  std::vector<float> sliceNear, sliceFar;
+  glm::mat4 boundsProjection{0.0F};
+  float boundsNear = 0.0F;
+  float boundsFar = 0.0F;
+
+  // Ranged lights in view space, indexed like their entries after the unbounded ones
+  std::vector<glm::vec4> viewSpheres;
+  std::vector<LightData> lightData;
+  std::size_t unboundedCount = 0;
+
+  // Per-slice results, merged in slice order so the lists do not depend on thread timing
+  std::vector<std::vector<std::uint32_t>> sliceIndices;
+  std::vector<std::vector<std::uint8_t>> sliceHits;
+  std::vector<glm::uvec2> clusters; // offset into `indices`, light count
+  std::vector<std::uint32_t> indices;
+  std::size_t maxClusterLights = 0;
+
+  unsigned int lightBuffer = 0, clusterBuffer = 0, indexBuffer = 0;
+  unsigned int lightTexture = 0, clusterTexture = 0, indexTexture = 0;
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+
+// CPU-side geometry: interleaved position/normal vertices and triangle indices.
+struct MeshData {
+  std::vector<float> vertices; // x, y, z, nx, ny, nz per vertex
+  std::vector<unsigned int> indices;
+};
+
+// GPU mesh owning its VAO/VBO/EBO. Meshes are shared between bodies through MeshLibrary, so
+// they are neither copyable nor movable.
+class Mesh {
+public:
+  explicit Mesh(const MeshData &data);
+  ~Mesh();
+
+  Mesh(const Mesh &) = delete;
+  Mesh(Mesh &&) = delete;
+  Mesh &operator=(const Mesh &) = delete;
+  Mesh &operator=(Mesh &&) = delete;
+
+  void draw() const;
+
+  unsigned int getVertexArray() const { return VAO; }
+  int getIndexCount() const { return indexCount; }
+
+private:
+  unsigned int VAO{}, VBO{}, EBO{};
+  int indexCount = 0;
+};
@@ -0,0 +1,27 @@
+#include "MeshLibrary.h"
+
+std::shared_ptr<Mesh> MeshLibrary::acquire(const MeshKey &key,
+                                           const std::function<MeshData()> &build) {
+  auto &entry = meshes[key];
+  if (auto mesh = entry.lock()) {
+    return mesh;
+  }
+  auto mesh = std::make_shared<Mesh>(build());
+  entry = mesh;
+  prune();
+  return mesh;
+}
+
+std::size_t MeshLibrary::getMeshCount() {
+  prune();
+  return meshes.size();
+}
+
+void MeshLibrary::prune() {
+  std::erase_if(meshes, [](const auto &entry) { return entry.second.expired(); });
+}
+
+MeshLibrary &getMeshLibrary() {
+  static MeshLibrary library;
+  return library;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <tuple>
+#include "Mesh.h"
+
+enum class MeshShape { Sphere, CubeSphere };
+
+// Each body keeps handles to this many detail levels. Level 0 is its own resolution and every
+// further level halves it, down to a per-shape floor.
+constexpr int MESH_LOD_COUNT = 4;
+
+// Identifies a unit-sized mesh. Shapes with a single resolution leave `detail` at zero.
+struct MeshKey {
+  MeshShape shape;
+  int resolution;
+  int detail = 0;
+
+  bool operator<(const MeshKey &other) const {
+    return std::tie(shape, resolution, detail) <
+           std::tie(other.shape, other.resolution, other.detail);
+  }
+};
+
+// Cache of GPU meshes shared by every body with the same shape and resolution. Bodies hold a
+// shared_ptr handle; the library only keeps weak references, so a mesh is freed as soon as the
+// last body using it is destroyed or switches resolution.
+class MeshLibrary {
+public:
+  // Returns the cached mesh for `key`, building and uploading it with `build` on a miss.
+  std::shared_ptr<Mesh> acquire(const MeshKey &key, const std::function<MeshData()> &build);
+
+  // Number of meshes currently alive on the GPU.
+  std::size_t getMeshCount();
+
+private:
+  void prune();
+
+  std::map<MeshKey, std::weak_ptr<Mesh>> meshes;
+};
+
+// Process-wide library; meshes are tied to the single GL context.
+MeshLibrary &getMeshLibrary();
@@ -4,6 +4,7 @@
 #include "RenderVisitor.h"
 #include "SceneObject.h"
 
+class Mesh;
 class Renderer;
 class RenderVisitor;
 
@@ -28,6 +29,15 @@ public:
     virtual void setColor(const glm::vec3& color) = 0;
     virtual glm::vec3 getColor() const = 0;
 
+    // Radius of a sphere around getPosition() that encloses the scaled mesh.
+    virtual float getBoundingRadius() const = 0;
+
+    // Unit-sized mesh shared with every body of the same shape and resolution, at a detail
+    // level in [0, MESH_LOD_COUNT), and the factor that brings it to this body's size before
+    // getScale() is applied.
+    virtual const Mesh& getMesh(int levelOfDetail) const = 0;
+    virtual float getMeshScale() const = 0;
+
     // Draw method can be called with nullptr when drawing is handled by visitor
     virtual void draw(Renderer* renderer) = 0;
     virtual void accept(RenderVisitor& visitor) = 0;
@@ -0,0 +1,155 @@
+#include "ParticleRenderer.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <utility>
+#include "GLStateCache.h"
+#include "Graphics/shader.h"
+#include "Simulation/BodyStorage.h"
+#include "core/thread_pool.h"
+
+namespace {
+
+constexpr std::size_t STREAM_GRAIN = 16384;
+
+} // namespace
+
+ParticleRenderer::ParticleRenderer(std::shared_ptr<Shader> particleShader)
+    : shader(std::move(particleShader)) {
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &VBO);
+}
+
+ParticleRenderer::~ParticleRenderer() {
+  for (auto *fence : fences) {
+    if (fence != nullptr) {
+      glDeleteSync(static_cast<GLsync>(fence));
+    }
+  }
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteBuffers(1, &VBO);
+}
+
+void ParticleRenderer::reserve(std::size_t count, GLStateCache &state) {
+  if (count <= capacity) {
+    return;
+  }
+  // Grow geometrically; the old storage may still be in use, so drop its fences too.
+  for (auto &fence : fences) {
+    if (fence != nullptr) {
+      glDeleteSync(static_cast<GLsync>(fence));
+      fence = nullptr;
+    }
+  }
+  capacity = std::max(count, capacity * 2);
+  state.bindArrayBuffer(VBO);
+  glBufferData(GL_ARRAY_BUFFER, SEGMENT_COUNT * capacity * sizeof(Particle), nullptr,
+               GL_STREAM_DRAW);
+}
+
+void ParticleRenderer::waitForSegment(int segment) {
+  auto *&fence = fences[segment];
+  if (fence == nullptr) {
+    return;
+  }
+  // With three segments in flight this returns immediately unless the GPU is over two frames
+  // behind.
+  const auto sync = static_cast<GLsync>(fence);
+  while (glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {
+  }
+  glDeleteSync(sync);
+  fence = nullptr;
+}
+
+void ParticleRenderer::update(const sim::BodyStorage &bodies, double mu,
+                              const ParticleStyle &style, ThreadPool &pool, GLStateCache &state) {
+  particleCount = bodies.size();
+  if (particleCount == 0) {
+    return;
+  }
+  reserve(particleCount, state);
+
+  currentSegment = (currentSegment + 1) % SEGMENT_COUNT;
+  waitForSegment(currentSegment);
+
+  // GL 4.1 has no persistent mapping, so map the segment unsynchronized instead. The fence
+  // above already guarantees the GPU is done with it.
+  state.bindArrayBuffer(VBO);
+  const std::size_t bytes = particleCount * sizeof(Particle);
+  auto *mapped = static_cast<Particle *>(glMapBufferRange(
+      GL_ARRAY_BUFFER, currentSegment * capacity * sizeof(Particle), bytes,
+      GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT));
+  if (mapped == nullptr) {
+    particleCount = 0;
+    return;
+  }
+
+  const bool needsElements = style.colorMode == ParticleColorMode::Eccentricity ||
+                             style.colorMode == ParticleColorMode::Inclination;
+  if (needsElements) {
+    elements.resize(particleCount);
+  }
+
+  pool.parallelFor(particleCount, STREAM_GRAIN, [&](std::size_t begin, std::size_t end) {
+    if (needsElements) {
+      sim::stateToKeplerian(bodies, mu, begin, end, elements);
+    }
+    for (std::size_t i = begin; i < end; ++i) {
+      float value = 0.0F;
+      switch (style.colorMode) {
+      case ParticleColorMode::Uniform:
+        break;
+      case ParticleColorMode::Speed: {
+        const double speed = glm::length(bodies.velocity(i));
+        value = static_cast<float>(speed / (speed + style.speedScale));
+        break;
+      }
+      case ParticleColorMode::Eccentricity:
+        value = static_cast<float>(std::min(elements.eccentricity[i], 1.0));
+        break;
+      case ParticleColorMode::Inclination:
+        value = static_cast<float>(elements.inclination[i] / std::numbers::pi);
+        break;
+      }
+      mapped[i] = {glm::vec4(static_cast<float>(bodies.x[i]), static_cast<float>(bodies.y[i]),
+                             static_cast<float>(bodies.z[i]), static_cast<float>(bodies.radius[i])),
+                   value};
+    }
+  });
+
+  glUnmapBuffer(GL_ARRAY_BUFFER);
+}
+
+void ParticleRenderer::draw(const glm::mat4 &projection, float viewportHeight,
+                            const ParticleStyle &style, GLStateCache &state) {
+  if (particleCount == 0) {
+    return;
+  }
+
+  state.useProgram(shader->getID());
+  shader->setFloat("pointScale", projection[1][1] * 0.5F * viewportHeight);
+  shader->setFloat("minPointSize", style.minPointSize);
+  shader->setInt("colorMode", static_cast<int>(style.colorMode));
+  shader->setVec3("uniformColor", style.color);
+
+  // Point the attributes at this frame's segment.
+  state.bindVertexArray(VAO);
+  state.bindArrayBuffer(VBO);
+  const std::size_t base = currentSegment * capacity * sizeof(Particle);
+  glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Particle),
+                        (void *)(base + offsetof(Particle, positionRadius)));
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(Particle),
+                        (void *)(base + offsetof(Particle, value)));
+  glEnableVertexAttribArray(1);
+
+  state.setBlend(false);
+  state.setWireframe(false);
+  glEnable(GL_PROGRAM_POINT_SIZE);
+  glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(particleCount));
+  glDisable(GL_PROGRAM_POINT_SIZE);
+
+  fences[currentSegment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
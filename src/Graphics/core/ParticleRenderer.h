@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <memory>
+#include "Simulation/OrbitalElements.h"
+
+class GLStateCache;
+class Shader;
+class ThreadPool;
+
+namespace sim {
+struct BodyStorage;
+}
+
+// What the per-particle scalar that drives the color map represents.
+enum class ParticleColorMode { Uniform, Speed, Eccentricity, Inclination };
+
+struct ParticleStyle {
+  ParticleColorMode colorMode = ParticleColorMode::Speed;
+  glm::vec3 color{0.8f, 0.85f, 1.0f}; // used by ParticleColorMode::Uniform
+  float speedScale = 1.0f;            // speed mapped to the middle of the color map
+  float minPointSize = 1.5f;          // pixels
+
+  bool operator==(const ParticleStyle &) const = default;
+};
+
+// Draws the scene's bulk bodies as point sprites, straight from the simulation's SoA arrays.
+// Each frame converts positions, radii and the color scalar into one segment of a ring of
+// stream segments. The GPU reads the other segments meanwhile, and fences guard reuse, so
+// the CPU never waits on a draw still in flight.
+class ParticleRenderer {
+public:
+  explicit ParticleRenderer(std::shared_ptr<Shader> shader);
+  ~ParticleRenderer();
+
+  ParticleRenderer(const ParticleRenderer &) = delete;
+  ParticleRenderer &operator=(const ParticleRenderer &) = delete;
+
+  // Streams the bodies into the next segment; `mu` is the central mass for element colors.
+  void update(const sim::BodyStorage &bodies, double mu, const ParticleStyle &style,
+              ThreadPool &pool, GLStateCache &state);
+  void draw(const glm::mat4 &projection, float viewportHeight, const ParticleStyle &style,
+            GLStateCache &state);
+
+  std::size_t size() const { return particleCount; }
+
+private:
+  // Interleaved per-particle attributes.
+  struct Particle {
+    glm::vec4 positionRadius;
+    float value; // color map input in [0, 1]
+  };
+
+  static constexpr int SEGMENT_COUNT = 3;
+
+  void reserve(std::size_t count, GLStateCache &state);
+  void waitForSegment(int segment);
+
+  std::shared_ptr<Shader> shader;
+  unsigned int VAO{}, VBO{};
+  std::array<void *, SEGMENT_COUNT> fences{}; // GLsync handles
+  std::size_t capacity = 0;                   // particles per segment
+  std::size_t particleCount = 0;
+  int currentSegment = 0;
+  sim::KeplerianElements elements;
+};
@@ -0,0 +1,59 @@
+#include "PathRenderer.h"
+#include <glad/glad.h>
+#include <utility>
+#include "GLStateCache.h"
+#include "Graphics/shader.h"
+#include "Simulation/Prediction.h"
+
+PathRenderer::PathRenderer(std::shared_ptr<Shader> pathShader) : shader(std::move(pathShader)) {
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &VBO);
+
+  glBindVertexArray(VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void *)0);
+  glEnableVertexAttribArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindVertexArray(0);
+}
+
+PathRenderer::~PathRenderer() {
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteBuffers(1, &VBO);
+}
+
+void PathRenderer::upload(const sim::PredictedPaths &paths, GLStateCache &state) {
+  samplesPerPath = paths.samplesPerBody;
+  const std::size_t pathCount = paths.getBodyCount();
+  firsts.resize(pathCount);
+  counts.assign(pathCount, static_cast<int>(samplesPerPath));
+
+  // w holds how far along its prediction each sample lies, for the fade
+  staging.resize(paths.points.size());
+  const float lastSample = samplesPerPath > 1 ? static_cast<float>(samplesPerPath - 1) : 1.0F;
+  for (std::size_t i = 0; i < pathCount; ++i) {
+    firsts[i] = static_cast<int>(i * samplesPerPath);
+    for (std::size_t k = 0; k < samplesPerPath; ++k) {
+      const std::size_t index = i * samplesPerPath + k;
+      staging[index] = glm::vec4(paths.points[index], static_cast<float>(k) / lastSample);
+    }
+  }
+
+  state.bindArrayBuffer(VBO);
+  glBufferData(GL_ARRAY_BUFFER, staging.size() * sizeof(glm::vec4), staging.data(),
+               GL_STATIC_DRAW);
+}
+
+void PathRenderer::draw(const glm::vec3 &color, GLStateCache &state) {
+  if (firsts.empty() || samplesPerPath < 2) {
+    return;
+  }
+
+  state.useProgram(shader->getID());
+  shader->setVec3("pathColor", color);
+  state.setBlend(true);
+  state.setWireframe(false);
+  state.bindVertexArray(VAO);
+  glMultiDrawArrays(GL_LINE_STRIP, firsts.data(), counts.data(),
+                    static_cast<GLsizei>(firsts.size()));
+}
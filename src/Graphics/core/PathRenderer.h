@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+class GLStateCache;
+class Shader;
+
+namespace sim {
+struct PredictedPaths;
+}
+
+// Draws predicted trajectories as line strips, fading toward the end of each prediction. The
+// paths change only when the predictor publishes a pass, so they are uploaded then and drawn
+// from the same buffer every frame with one glMultiDrawArrays.
+class PathRenderer {
+public:
+  explicit PathRenderer(std::shared_ptr<Shader> shader);
+  ~PathRenderer();
+
+  PathRenderer(const PathRenderer &) = delete;
+  PathRenderer &operator=(const PathRenderer &) = delete;
+
+  void upload(const sim::PredictedPaths &paths, GLStateCache &state);
+  void draw(const glm::vec3 &color, GLStateCache &state);
+
+  std::size_t getPathCount() const { return firsts.size(); }
+  std::size_t getSamplesPerPath() const { return samplesPerPath; }
+
+private:
+  std::shared_ptr<Shader> shader;
+  unsigned int VAO{}, VBO{};
+  std::size_t samplesPerPath = 0;
+  std::vector<int> firsts;
+  std::vector<int> counts;
+  std::vector<glm::vec4> staging;
+};
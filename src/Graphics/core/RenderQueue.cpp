@@ -0,0 +1,134 @@
+#include "RenderQueue.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include "GLStateCache.h"
+#include "Graphics/shader.h"
+#include "Mesh.h"
+
+namespace {
+
+constexpr GLuint INSTANCE_MODEL_LOCATION = 2;
+constexpr GLuint INSTANCE_COLOR_LOCATION = 6;
+constexpr GLuint INSTANCE_NORMAL_LOCATION = 7;
+
+constexpr int LAYER_SHIFT = 63;
+constexpr int PROGRAM_SHIFT = 48;
+constexpr int MESH_SHIFT = 28;
+constexpr int STATE_SHIFT = 24;
+constexpr std::uint64_t PROGRAM_MASK = (1ULL << 15) - 1;
+constexpr std::uint64_t MESH_MASK = (1ULL << 20) - 1;
+constexpr std::uint64_t DEPTH_MASK = (1ULL << 24) - 1;
+constexpr std::uint64_t STATE_BLENDED = 1;
+
+// Points the instance attributes of the bound VAO at the run starting at `firstInstance`.
+// GL 4.1 has no base-instance draws, so the offset goes into the attribute pointers instead.
+void bindInstanceAttributes(std::size_t firstInstance) {
+  const std::size_t base = firstInstance * sizeof(InstanceData);
+  for (GLuint column = 0; column < 4; ++column) {
+    const GLuint location = INSTANCE_MODEL_LOCATION + column;
+    glEnableVertexAttribArray(location);
+    glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                          (void *)(base + offsetof(InstanceData, model) +
+                                   (column * sizeof(glm::vec4))));
+    glVertexAttribDivisor(location, 1);
+  }
+  glEnableVertexAttribArray(INSTANCE_COLOR_LOCATION);
+  glVertexAttribPointer(INSTANCE_COLOR_LOCATION, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                        (void *)(base + offsetof(InstanceData, color)));
+  glVertexAttribDivisor(INSTANCE_COLOR_LOCATION, 1);
+  for (GLuint column = 0; column < 3; ++column) {
+    const GLuint location = INSTANCE_NORMAL_LOCATION + column;
+    glEnableVertexAttribArray(location);
+    glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                          (void *)(base + offsetof(InstanceData, normal) +
+                                   (column * sizeof(glm::vec4))));
+    glVertexAttribDivisor(location, 1);
+  }
+}
+
+bool isBlended(std::uint64_t key) { return (key >> LAYER_SHIFT) != 0; }
+
+} // namespace
+
+RenderQueue::~RenderQueue() {
+  if (instanceVBO != 0) {
+    glDeleteBuffers(1, &instanceVBO);
+  }
+}
+
+std::uint64_t RenderQueue::makeKey(unsigned int program, unsigned int mesh, bool blended,
+                                   float viewDepth) {
+  // Non-negative floats order the same as their bit patterns, so the top 24 bits of the
+  // pattern give a depth key that needs no near/far range.
+  const auto depthBits = std::bit_cast<std::uint32_t>(std::max(viewDepth, 0.0F));
+  std::uint64_t depth = (depthBits >> 7) & DEPTH_MASK;
+  if (blended) {
+    depth = DEPTH_MASK - depth;
+  }
+  return (static_cast<std::uint64_t>(blended) << LAYER_SHIFT) |
+         ((program & PROGRAM_MASK) << PROGRAM_SHIFT) | ((mesh & MESH_MASK) << MESH_SHIFT) |
+         ((blended ? STATE_BLENDED : 0) << STATE_SHIFT) | depth;
+}
+
+void RenderQueue::record(const Shader &shader, const Mesh &mesh, const InstanceData &instance,
+                         float viewDepth, bool blended) {
+  packets.push_back({makeKey(shader.getID(), mesh.getVertexArray(), blended, viewDepth), &shader,
+                     &mesh, instance});
+}
+
+void RenderQueue::uploadInstances(GLStateCache &state) {
+  instanceData.clear();
+  for (const auto &[key, index] : order) {
+    instanceData.push_back(packets[index].instance);
+  }
+
+  if (instanceVBO == 0) {
+    glGenBuffers(1, &instanceVBO);
+  }
+  state.bindArrayBuffer(instanceVBO);
+  // Orphan the previous frame's storage so the driver never stalls on a buffer still in use.
+  instanceCapacity = std::max(instanceCapacity, instanceData.size());
+  glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, instanceData.size() * sizeof(InstanceData),
+                  instanceData.data());
+}
+
+void RenderQueue::submit(GLStateCache &state) {
+  drawCalls = 0;
+  if (packets.empty()) {
+    return;
+  }
+
+  // Sort small (key, index) pairs rather than the packets themselves.
+  order.resize(packets.size());
+  for (std::uint32_t i = 0; i < packets.size(); ++i) {
+    order[i] = {packets[i].key, i};
+  }
+  std::sort(order.begin(), order.end());
+  uploadInstances(state);
+
+  std::size_t first = 0;
+  while (first < order.size()) {
+    const DrawPacket &head = packets[order[first].second];
+    const bool blended = isBlended(head.key);
+    std::size_t last = first + 1;
+    while (last < order.size()) {
+      const DrawPacket &next = packets[order[last].second];
+      if (next.shader != head.shader || next.mesh != head.mesh || isBlended(next.key) != blended) {
+        break;
+      }
+      ++last;
+    }
+
+    state.useProgram(head.shader->getID());
+    state.setBlend(blended);
+    state.bindVertexArray(head.mesh->getVertexArray());
+    bindInstanceAttributes(first);
+    glDrawElementsInstanced(GL_TRIANGLES, head.mesh->getIndexCount(), GL_UNSIGNED_INT, nullptr,
+                            static_cast<GLsizei>(last - first));
+    ++drawCalls;
+    first = last;
+  }
+}
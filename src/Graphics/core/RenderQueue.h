@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <utility>
+#include <vector>
+
+class GLStateCache;
+class Mesh;
+class Shader;
+
+// Inverse transpose of a model matrix's upper 3x3, as three columns padded to vec4.
+struct NormalMatrix {
+  glm::vec4 columns[3];
+};
+
+// Per-instance attributes streamed to the GPU; locations 2-5 hold the model matrix columns,
+// location 6 the color and locations 7-9 the normal matrix columns.
+struct InstanceData {
+  glm::mat4 model;
+  glm::vec4 color;
+  NormalMatrix normal;
+};
+
+// One recorded draw. The sort key packs, from the most significant bit down:
+//   [63]       layer: 0 opaque, 1 blended
+//   [48, 63)   program
+//   [28, 48)   mesh (its vertex array name)
+//   [24, 28)   render state flags
+//   [0, 24)    view depth: front to back when opaque, back to front when blended
+struct DrawPacket {
+  std::uint64_t key;
+  const Shader *shader;
+  const Mesh *mesh;
+  InstanceData instance;
+};
+
+// Draws are recorded into a flat packet list, then sorted and submitted in one pass. Recording
+// never touches GL, so it may run on any thread. Submission must run on the GL thread. It merges
+// consecutive packets that share program, mesh and state into one instanced draw, and issues
+// state changes through a GLStateCache.
+class RenderQueue {
+public:
+  RenderQueue() = default;
+  ~RenderQueue();
+
+  RenderQueue(const RenderQueue &) = delete;
+  RenderQueue &operator=(const RenderQueue &) = delete;
+
+  void clear() { packets.clear(); }
+  void record(const Shader &shader, const Mesh &mesh, const InstanceData &instance,
+              float viewDepth, bool blended = false);
+
+  void submit(GLStateCache &state);
+
+  std::size_t getPacketCount() const { return packets.size(); }
+  int getDrawCallCount() const { return drawCalls; }
+
+  static std::uint64_t makeKey(unsigned int program, unsigned int mesh, bool blended,
+                               float viewDepth);
+
+private:
+  void uploadInstances(GLStateCache &state);
+
+  std::vector<DrawPacket> packets;
+  std::vector<std::pair<std::uint64_t, std::uint32_t>> order;
+  std::vector<InstanceData> instanceData;
+  unsigned int instanceVBO = 0;
+  std::size_t instanceCapacity = 0;
+  int drawCalls = 0;
+};
@@ -1,56 +1,34 @@
 #include "RenderVisitor.h"
 #include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-#include "Graphics/bodies/cubeSphere.h"
 #include "Object3D.h"
+#include "TransformSystem.h"
 
-void RenderVisitor::visit(Object3D *object) {
+void RenderVisitor::visit(Object3D *object, int levelOfDetail) {
   if (object == nullptr) {
     return;
   }
 
-  // Get the appropriate shader based on object type
-  std::string shaderType = "Sphere"; // Default
-  if (dynamic_cast<CubeSphere *>(object) != nullptr) {
-    shaderType = "CubeSphere";
-  }
+  glm::mat4 model;
+  NormalMatrix normal;
+  TransformSystem::compose(object->getPosition(), object->getOrientation(),
+                           object->getScale() * object->getMeshScale(), model, normal);
+  visit(object, levelOfDetail, model, normal);
+}
 
-  const auto shader = shaders[shaderType];
-  if (!shader) {
+void RenderVisitor::visit(Object3D *object, int levelOfDetail, const glm::mat4 &model,
+                          const NormalMatrix &normal) {
+  if (object == nullptr) {
     return;
   }
 
-  // Set up transformation matrices
-  glm::mat4 model(1.0f);
-  model = glm::translate(model, object->getPosition());
-  model = glm::scale(model, object->getScale());
-
-  shader->use();
-  shader->setMat4("projection", projectionMatrix);
-  shader->setMat4("view", viewMatrix);
-  shader->setMat4("model", model);
-  shader->setVec3("objectColor", object->getColor());
-
-  // Set view position for specular lighting
-  glm::mat4 invView = glm::inverse(viewMatrix);
-  glm::vec3 viewPos = glm::vec3(invView[3]); // Extract camera position from inverse view matrix
-  shader->setVec3("viewPos", viewPos);
-
-  // Update lighting information for each light
-  shader->setInt("numLights", static_cast<int>(lights.size()));
-  for (size_t i = 0; i < lights.size(); ++i) {
-    const auto &light = lights[i];
-    std::string index = std::to_string(i);
-
-    shader->setVec3("lights[" + index + "].position", light->getPosition());
-    shader->setVec3("lights[" + index + "].color", light->getColor());
-    shader->setFloat("lights[" + index + "].intensity", light->getIntensity());
-    shader->setFloat("lights[" + index + "].ambientStrength", light->getAmbientStrength());
-    shader->setFloat("lights[" + index + "].diffuseStrength", light->getDiffuseStrength());
-    shader->setFloat("lights[" + index + "].specularStrength", light->getSpecularStrength());
-    shader->setFloat("lights[" + index + "].shininess", light->getShininess());
+  // Get the appropriate shader based on object type
+  const auto it = shaders.find(object->getType());
+  if (it == shaders.end() || !it->second) {
+    return;
   }
 
-  // The object will handle its own drawing after shader setup
-  object->draw(nullptr);
+  // Distance along the view direction, used to order draws front to back
+  const float viewDepth = -(viewMatrix * glm::vec4(object->getPosition(), 1.0f)).z;
+  queue.record(*it->second, object->getMesh(levelOfDetail),
+               {model, glm::vec4(object->getColor(), 1.0f), normal}, viewDepth);
 }
@@ -6,10 +6,15 @@
 #include <string>
 #include <vector>
 #include "Graphics/shader.h"
-#include "Graphics/lighting/Light.h"
+#include "RenderQueue.h"
 
+class GLStateCache;
 class Object3D;
 
+// Record phase of scene rendering: each visited object becomes a draw packet carrying its
+// shader, shared mesh, model and normal matrices and color. Call begin() before visiting a frame's objects
+// and submit() afterwards; the queue sorts the packets and draws them with instancing.
+// Camera and lights come from the shared uniform blocks the Renderer uploads each frame.
 class RenderVisitor {
 public:
     RenderVisitor(const glm::mat4& view, const glm::mat4& projection)
@@ -24,15 +29,19 @@ public:
         shaders[objectType] = shader;
     }
 
-    void setLights(const std::vector<std::shared_ptr<Light>>& newLights) {
-        lights = newLights;
-    }
+    void begin() { queue.clear(); }
+    void visit(Object3D* object) { visit(object, 0); }
+    void visit(Object3D* object, int levelOfDetail);
+    // Same, with matrices already computed by a TransformSystem
+    void visit(Object3D* object, int levelOfDetail, const glm::mat4& model,
+               const NormalMatrix& normal);
+    void submit(GLStateCache& state) { queue.submit(state); }
 
-    void visit(Object3D* object);
+    const RenderQueue& getQueue() const { return queue; }
 
 private:
     glm::mat4 viewMatrix;
     glm::mat4 projectionMatrix;
     std::map<std::string, std::shared_ptr<Shader>> shaders;
-    std::vector<std::shared_ptr<Light>> lights;
+    RenderQueue queue;
 };
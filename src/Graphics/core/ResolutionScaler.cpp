@@ -0,0 +1,112 @@
+#include "ResolutionScaler.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Scales are multiples of this, so small wobbles in the timings do not move it
+constexpr float SCALE_STEP = 0.05f;
+constexpr float MAX_SCALE_RISE = 0.1f;
+
+// Frames under HEADROOM * target count toward a rise; a change aims for the middle of the band
+constexpr float HEADROOM = 0.75f;
+constexpr float AIM = 0.85f;
+
+// Frames in a row over the target before the scale drops, and under the band before it rises
+constexpr int DROP_FRAMES = 3;
+constexpr int RISE_FRAMES = 90;
+
+constexpr float SMOOTHING = 0.1f;
+
+} // namespace
+
+ResolutionScaler::ResolutionScaler() { glGenQueries(QUERY_COUNT, queries.data()); }
+
+ResolutionScaler::~ResolutionScaler() { glDeleteQueries(QUERY_COUNT, queries.data()); }
+
+void ResolutionScaler::begin() {
+  // A query still unread means the GPU is QUERY_COUNT frames behind; this frame goes untimed
+  timing = !issued[next];
+  if (timing) {
+    glBeginQuery(GL_TIME_ELAPSED, queries[next]);
+  }
+}
+
+void ResolutionScaler::end(const ResolutionStyle &style) {
+  if (timing) {
+    glEndQuery(GL_TIME_ELAPSED);
+    issued[next] = true;
+    stale[next] = false;
+    next = (next + 1) % QUERY_COUNT;
+    timing = false;
+  }
+
+  // Oldest first; queries finish in the order they were issued
+  for (int k = 0; k < QUERY_COUNT; ++k) {
+    const int slot = (next + k) % QUERY_COUNT;
+    if (!issued[slot]) {
+      continue;
+    }
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE) {
+      break;
+    }
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(queries[slot], GL_QUERY_RESULT, &nanoseconds);
+    issued[slot] = false;
+    if (!stale[slot]) {
+      adjust(static_cast<float>(nanoseconds) * 1.0e-6f, style);
+    }
+  }
+
+  // Switching off, or raising the minimum, takes effect at once
+  const float lowest = style.dynamic ? std::clamp(style.minScale, SCALE_STEP, 1.0f) : 1.0f;
+  if (scale < lowest) {
+    scale = lowest;
+    overFrames = underFrames = 0;
+    stale = issued;
+  }
+}
+
+void ResolutionScaler::adjust(float milliseconds, const ResolutionStyle &style) {
+  frameTime = frameTime == 0.0f ? milliseconds
+                                : frameTime + (SMOOTHING * (milliseconds - frameTime));
+  if (!style.dynamic) {
+    return;
+  }
+
+  const float target = std::max(style.targetFrameTime, 0.1f);
+  if (frameTime > target) {
+    ++overFrames;
+    underFrames = 0;
+  } else if (frameTime < HEADROOM * target) {
+    ++underFrames;
+    overFrames = 0;
+  } else {
+    overFrames = underFrames = 0;
+  }
+
+  // GPU time goes roughly with the pixel count, the square of the scale
+  const float ideal = scale * std::sqrt(AIM * target / frameTime);
+  float scaled = scale;
+  if (overFrames >= DROP_FRAMES) {
+    scaled = std::floor(ideal / SCALE_STEP) * SCALE_STEP;
+  } else if (underFrames >= RISE_FRAMES) {
+    scaled = std::round(std::min(ideal, scale + MAX_SCALE_RISE) / SCALE_STEP) * SCALE_STEP;
+    scaled = std::max(scaled, scale + SCALE_STEP);
+  } else {
+    return;
+  }
+  scaled = std::clamp(scaled, std::clamp(style.minScale, SCALE_STEP, 1.0f), 1.0f);
+  overFrames = underFrames = 0;
+  if (scaled == scale) {
+    return;
+  }
+
+  // Timings still in flight were taken at the old scale; the estimate is carried over instead
+  frameTime *= (scaled * scaled) / (scale * scale);
+  scale = scaled;
+  stale = issued;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+struct ResolutionStyle {
+  bool dynamic = true;
+  float targetFrameTime = 14.0f; // milliseconds of GPU time for the scene
+  float minScale = 0.5f;         // of the window's size along each axis
+
+  bool operator==(const ResolutionStyle &) const = default;
+};
+
+// Picks the resolution the scene is rendered at so its GPU time stays within a target. Each
+// frame is timed with a GL_TIME_ELAPSED query, read back a few frames later so the CPU never
+// waits on it. The scale drops soon after frames run over the target and rises only after a
+// long run of frames well under it; the band between keeps it from hunting back and forth.
+class ResolutionScaler {
+public:
+  ResolutionScaler();
+  ~ResolutionScaler();
+
+  ResolutionScaler(const ResolutionScaler &) = delete;
+  ResolutionScaler &operator=(const ResolutionScaler &) = delete;
+
+  // Bracket the GPU work of the scene. end() folds in any finished timings and updates the
+  // scale for the next frame.
+  void begin();
+  void end(const ResolutionStyle &style);
+
+  float getScale() const { return scale; }
+  // Smoothed GPU time of the scene in milliseconds, 0 until the first timing arrives
+  float getFrameTime() const { return frameTime; }
+
+private:
+  static constexpr int QUERY_COUNT = 4;
+
+  void adjust(float milliseconds, const ResolutionStyle &style);
+
+  std::array<unsigned int, QUERY_COUNT> queries{};
+  std::array<bool, QUERY_COUNT> issued{};
+  std::array<bool, QUERY_COUNT> stale{}; // timed at a scale that has since changed
+  int next = 0;
+  bool timing = false;
+
+  float scale = 1.0f;
+  float frameTime = 0.0f;
+  int overFrames = 0;
+  int underFrames = 0;
+};
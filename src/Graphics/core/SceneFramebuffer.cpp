@@ -0,0 +1,56 @@
+#include "SceneFramebuffer.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+SceneFramebuffer::~SceneFramebuffer() { release(); }
+
+void SceneFramebuffer::release() {
+  if (FBO != 0) {
+    glDeleteFramebuffers(1, &FBO);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteRenderbuffers(1, &depthBuffer);
+  }
+  FBO = colorBuffer = depthBuffer = 0;
+  width = height = 0;
+  viewportWidth = viewportHeight = 0;
+}
+
+void SceneFramebuffer::bind(int targetWidth, int targetHeight, float scale) {
+  if (targetWidth != width || targetHeight != height || FBO == 0) {
+    release();
+    width = targetWidth;
+    height = targetHeight;
+
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32F, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+      std::cout << "ERROR::FRAMEBUFFER::SCENE_TARGET_INCOMPLETE" << std::endl;
+    }
+  }
+  viewportWidth = std::max(1, std::min(static_cast<int>(std::lround(width * scale)), width));
+  viewportHeight = std::max(1, std::min(static_cast<int>(std::lround(height * scale)), height));
+  glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+  glViewport(0, 0, viewportWidth, viewportHeight);
+}
+
+void SceneFramebuffer::present(int targetWidth, int targetHeight) const {
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+  const bool scaled = viewportWidth != targetWidth || viewportHeight != targetHeight;
+  glBlitFramebuffer(0, 0, viewportWidth, viewportHeight, 0, 0, targetWidth, targetHeight,
+                    GL_COLOR_BUFFER_BIT, scaled ? GL_LINEAR : GL_NEAREST);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glViewport(0, 0, targetWidth, targetHeight);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+// Offscreen target the scene is drawn into: 8-bit color with a 32-bit float depth buffer. The
+// default framebuffer's depth format is up to the platform, and reversed-Z only keeps its
+// precision at every distance with float depth. The scene can be drawn into a scaled-down
+// corner of the target and stretched over the window when presented, so a lower resolution
+// costs no reallocation.
+class SceneFramebuffer {
+public:
+  SceneFramebuffer() = default;
+  ~SceneFramebuffer();
+
+  SceneFramebuffer(const SceneFramebuffer &) = delete;
+  SceneFramebuffer &operator=(const SceneFramebuffer &) = delete;
+
+  // Binds the target for drawing at `scale` times `width` by `height`, reallocating it first
+  // if the full size changed.
+  void bind(int width, int height, float scale = 1.0f);
+  // Copies the color into the default framebuffer, `width` by `height`, and binds that.
+  void present(int targetWidth, int targetHeight) const;
+
+  // Size the scene is drawn at, in pixels of the target
+  int getWidth() const { return viewportWidth; }
+  int getHeight() const { return viewportHeight; }
+
+private:
+  void release();
+
+  unsigned int FBO = 0;
+  unsigned int colorBuffer = 0;
+  unsigned int depthBuffer = 0;
+  int width = 0;
+  int height = 0;
+  int viewportWidth = 0;
+  int viewportHeight = 0;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include <string>
 #include <memory>
 #include <vector>
@@ -20,6 +21,9 @@ public:
     const glm::vec3& getRotation() const { return rotation; }
     const glm::vec3& getScale() const { return scale; }
 
+    // Rotation holds Euler angles in degrees (pitch, yaw, roll about X, Y and Z)
+    glm::quat getOrientation() const { return glm::quat(glm::radians(rotation)); }
+
     virtual const std::string& getType() const = 0;
 
 protected:
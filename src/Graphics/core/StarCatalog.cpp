@@ -0,0 +1,163 @@
+#include "StarCatalog.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <numbers>
+#include <stdexcept>
+#include "Terrain.h"
+
+namespace {
+
+constexpr char STAR_MAGIC[8] = {'O', 'R', 'B', 'S', 'T', 'A', 'R', '1'};
+constexpr std::uint32_t STAR_VERSION = 1;
+constexpr int STAR_MAX_TILES_PER_EDGE = 256;
+
+struct FileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t tilesPerEdge;
+  std::uint64_t starCount;
+  std::uint64_t indexOffset;
+};
+static_assert(sizeof(FileHeader) == 32, "star catalog header must be packed");
+
+constexpr double QUARTER_PI = std::numbers::pi / 4.0;
+
+// Equiangular cube map: tile edges are evenly spaced in angle rather than along the face
+int findTile(const glm::vec3 &direction, int tilesPerEdge) {
+  int face = 0;
+  double u = 0.0;
+  double v = 0.0;
+  cubeFaceCoordinates(glm::dvec3(direction), face, u, v);
+  const auto cell = [tilesPerEdge](double coordinate) {
+    const double angle = std::atan(coordinate) / QUARTER_PI; // [-1, 1]
+    return std::clamp(static_cast<int>((angle + 1.0) * 0.5 * tilesPerEdge), 0, tilesPerEdge - 1);
+  };
+  return (((face * tilesPerEdge) + cell(v)) * tilesPerEdge) + cell(u);
+}
+
+glm::dvec3 tileCorner(int face, int x, int y, int tilesPerEdge) {
+  const auto coordinate = [tilesPerEdge](int edge) {
+    return std::tan(((2.0 * edge / tilesPerEdge) - 1.0) * QUARTER_PI);
+  };
+  return glm::normalize(cubeFacePoint(face, coordinate(x), coordinate(y)));
+}
+
+} // namespace
+
+StarCatalog::StarCatalog(const std::string &filePath) : path(filePath), file(filePath) {
+  FileHeader header{};
+  if (file.size() < sizeof(header)) {
+    throw std::runtime_error("Not a star catalog: " + path);
+  }
+  std::memcpy(&header, file.data(), sizeof(header));
+  if (std::memcmp(header.magic, STAR_MAGIC, sizeof(STAR_MAGIC)) != 0) {
+    throw std::runtime_error("Not a star catalog: " + path);
+  }
+  if (header.version != STAR_VERSION || header.tilesPerEdge < 1 ||
+      header.tilesPerEdge > STAR_MAX_TILES_PER_EDGE) {
+    throw std::runtime_error("Unsupported star catalog format: " + path);
+  }
+
+  const int tilesPerEdge = static_cast<int>(header.tilesPerEdge);
+  const auto tileCount = static_cast<std::size_t>(6 * tilesPerEdge * tilesPerEdge);
+  // Sizes are compared by what remains of the file, so a huge offset or count cannot wrap
+  if (header.indexOffset % alignof(StarTileEntry) != 0 || header.indexOffset > file.size() ||
+      (file.size() - header.indexOffset) / sizeof(StarTileEntry) < tileCount) {
+    throw std::runtime_error("Star catalog is truncated: " + path);
+  }
+  const std::size_t starsOffset = header.indexOffset + (tileCount * sizeof(StarTileEntry));
+  if ((file.size() - starsOffset) / sizeof(StarRecord) < header.starCount) {
+    throw std::runtime_error("Star catalog is truncated: " + path);
+  }
+  starCount = static_cast<std::size_t>(header.starCount);
+  index = reinterpret_cast<const StarTileEntry *>(file.data() + header.indexOffset);
+  stars = reinterpret_cast<const StarRecord *>(file.data() + starsOffset);
+
+  centers.resize(tileCount);
+  radii.resize(tileCount);
+  for (std::size_t tile = 0; tile < tileCount; ++tile) {
+    // Every bin's count is a prefix of the tile that gets copied out, so each has to fit
+    const StarTileEntry &entry = index[tile];
+    bool damaged = entry.first > starCount || entry.count > starCount - entry.first;
+    std::uint32_t previous = 0;
+    for (const std::uint32_t brighter : entry.brighter) {
+      damaged = damaged || brighter < previous || brighter > entry.count;
+      previous = brighter;
+    }
+    if (damaged) {
+      throw std::runtime_error("Star catalog index is damaged: " + path);
+    }
+
+    const int face = static_cast<int>(tile) / (tilesPerEdge * tilesPerEdge);
+    const int y = (static_cast<int>(tile) / tilesPerEdge) % tilesPerEdge;
+    const int x = static_cast<int>(tile) % tilesPerEdge;
+    const std::array<glm::dvec3, 4> corners = {
+        tileCorner(face, x, y, tilesPerEdge), tileCorner(face, x + 1, y, tilesPerEdge),
+        tileCorner(face, x, y + 1, tilesPerEdge), tileCorner(face, x + 1, y + 1, tilesPerEdge)};
+    const glm::dvec3 center = glm::normalize(corners[0] + corners[1] + corners[2] + corners[3]);
+    double radius = 0.0;
+    for (const glm::dvec3 &corner : corners) {
+      radius = std::max(radius, std::acos(std::clamp(glm::dot(center, corner), -1.0, 1.0)));
+    }
+    centers[tile] = glm::vec3(center);
+    radii[tile] = static_cast<float>(radius);
+  }
+}
+
+std::size_t StarCatalog::getStarCount(int tile, int bin) const {
+  const StarTileEntry &entry = index[tile];
+  if (bin >= STAR_MAGNITUDE_BINS) {
+    return static_cast<std::size_t>(entry.count);
+  }
+  return bin < 0 ? 0 : entry.brighter[static_cast<std::size_t>(bin)];
+}
+
+const StarRecord *StarCatalog::getStars(int tile) const { return stars + index[tile].first; }
+
+void writeStarCatalog(const std::string &path, std::vector<StarRecord> stars) {
+  constexpr int tilesPerEdge = STAR_TILES_PER_EDGE;
+  constexpr auto tileCount = static_cast<std::size_t>(6 * tilesPerEdge * tilesPerEdge);
+
+  // Tile by tile, brightest first within each
+  std::vector<std::pair<int, std::size_t>> order(stars.size());
+  for (std::size_t i = 0; i < stars.size(); ++i) {
+    order[i] = {findTile(stars[i].direction, tilesPerEdge), i};
+  }
+  std::sort(order.begin(), order.end(), [&stars](const auto &a, const auto &b) {
+    return a.first != b.first ? a.first < b.first
+                              : stars[a.second].magnitude < stars[b.second].magnitude;
+  });
+
+  std::vector<StarTileEntry> index(tileCount);
+  std::vector<StarRecord> sorted(stars.size());
+  for (std::size_t k = 0; k < order.size(); ++k) {
+    const StarRecord &star = stars[order[k].second];
+    StarTileEntry &entry = index[static_cast<std::size_t>(order[k].first)];
+    if (entry.count == 0) {
+      entry.first = k;
+    }
+    ++entry.count;
+    for (int bin = 0; bin < STAR_MAGNITUDE_BINS; ++bin) {
+      if (star.magnitude < static_cast<float>(STAR_MAGNITUDE_MIN + bin)) {
+        ++entry.brighter[static_cast<std::size_t>(bin)];
+      }
+    }
+    sorted[k] = star;
+  }
+
+  writeFileReplacing(path, [&](std::ofstream &out) {
+    FileHeader header{};
+    std::memcpy(header.magic, STAR_MAGIC, sizeof(STAR_MAGIC));
+    header.version = STAR_VERSION;
+    header.tilesPerEdge = tilesPerEdge;
+    header.starCount = sorted.size();
+    header.indexOffset = sizeof(FileHeader);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(index.data()),
+              static_cast<std::streamsize>(index.size() * sizeof(StarTileEntry)));
+    out.write(reinterpret_cast<const char *>(sorted.data()),
+              static_cast<std::streamsize>(sorted.size() * sizeof(StarRecord)));
+  });
+}
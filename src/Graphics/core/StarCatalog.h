@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include "core/mapped_file.h"
+
+// Sky tiles along each edge of a cube face when writing a catalog: 6 * 32 * 32 tiles of about
+// 2.6 degrees each.
+constexpr int STAR_TILES_PER_EDGE = 32;
+
+// Whole magnitudes at which each tile records how many of its stars are brighter, from
+// STAR_MAGNITUDE_MIN up. Stars are loaded up to one of these limits.
+constexpr int STAR_MAGNITUDE_BINS = 32;
+constexpr int STAR_MAGNITUDE_MIN = -2;
+
+// One star as stored in the catalog and in the vertex buffer.
+struct StarRecord {
+  glm::vec3 direction{0.0f, 0.0f, 1.0f}; // unit vector in scene coordinates
+  float magnitude = 0.0f;                // apparent visual magnitude
+  float colorIndex = 0.0f;               // B-V
+};
+static_assert(sizeof(StarRecord) == 20, "star records are stored packed");
+
+// Index entry of one sky tile as stored in the catalog.
+struct StarTileEntry {
+  std::uint64_t first = 0; // records before the tile's first star
+  std::uint64_t count = 0;
+  std::array<std::uint32_t, STAR_MAGNITUDE_BINS> brighter{}; // by whole magnitude
+};
+
+// Star catalog binned into sky tiles, read from a memory-mapped file, so only the tiles and
+// magnitudes actually drawn are ever read from disk. Tiles are the cells of an equiangular cube
+// map, which keeps their areas within a factor of 1.5 of each other, and each tile's stars are
+// sorted brightest first, so the stars down to any magnitude are a prefix of the tile.
+//
+// File layout, little-endian:
+//   header  magic "ORBSTAR1", version, tiles per face edge, star count, index offset
+//   index   StarTileEntry per tile: first star, star count, then the STAR_MAGNITUDE_BINS
+//           counts of stars brighter than STAR_MAGNITUDE_MIN, STAR_MAGNITUDE_MIN + 1, ...
+//   stars   StarRecord by tile, brightest first
+class StarCatalog {
+public:
+  // Maps the file and checks its header and index; throws std::runtime_error if it is not a
+  // star catalog this build can read.
+  explicit StarCatalog(const std::string &path);
+
+  const std::string &getPath() const { return path; }
+  std::size_t getStarCount() const { return starCount; }
+  int getTileCount() const { return static_cast<int>(centers.size()); }
+
+  // Direction of a tile's center and the angle from it to the tile's farthest corner.
+  const glm::vec3 &getTileCenter(int tile) const { return centers[static_cast<std::size_t>(tile)]; }
+  float getTileRadius(int tile) const { return radii[static_cast<std::size_t>(tile)]; }
+
+  // Stars of the tile brighter than STAR_MAGNITUDE_MIN + bin; reading the count touches only
+  // the index. The stars themselves are the first `count` records at getStars(tile).
+  std::size_t getStarCount(int tile, int bin) const;
+  const StarRecord *getStars(int tile) const;
+
+private:
+  std::string path;
+  MappedFile file;
+  std::size_t starCount = 0;
+  const StarTileEntry *index = nullptr;
+  const StarRecord *stars = nullptr;
+  std::vector<glm::vec3> centers;
+  std::vector<float> radii;
+};
+
+// Bins the stars into sky tiles, sorts each tile by magnitude and writes the catalog. The file is
+// replaced only once complete, so catalogs already open on it keep their old contents.
+void writeStarCatalog(const std::string &path, std::vector<StarRecord> stars);
@@ -0,0 +1,227 @@
+#include "StarRenderer.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <utility>
+#include "GLStateCache.h"
+#include "Graphics/shader.h"
+
+namespace {
+
+// Stars drawn per frame at most, stars kept in the cache, and stars read per background batch
+constexpr std::size_t STAR_MAX_DRAWN = std::size_t{1} << 20;
+constexpr std::size_t STAR_CACHE_STARS = std::size_t{2} << 20;
+constexpr std::size_t STAR_BATCH_STARS = std::size_t{1} << 18;
+
+// The vertical field of view at which StarStyle::magnitudeLimit applies, 45 degrees
+constexpr float STAR_REFERENCE_FOV = std::numbers::pi_v<float> / 4.0f;
+
+} // namespace
+
+StarRenderer::StarRenderer(std::shared_ptr<Shader> starShader) : shader(std::move(starShader)) {
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &VBO);
+
+  glBindVertexArray(VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  constexpr GLsizei stride = sizeof(StarRecord);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride,
+                        (void *)offsetof(StarRecord, direction));
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, stride,
+                        (void *)offsetof(StarRecord, magnitude));
+  glEnableVertexAttribArray(1);
+  glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride,
+                        (void *)offsetof(StarRecord, colorIndex));
+  glEnableVertexAttribArray(2);
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+StarRenderer::~StarRenderer() {
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteBuffers(1, &VBO);
+}
+
+void StarRenderer::setCatalog(std::shared_ptr<const StarCatalog> starCatalog) {
+  batch.reset();
+  cache.clear();
+  cachedStars = 0;
+  dirty = true;
+  catalog = std::move(starCatalog);
+}
+
+void StarRenderer::draw(const glm::mat4 &view, const glm::mat4 &projection, float viewportHeight,
+                        const StarStyle &style, GLStateCache &state) {
+  ++frame;
+  batch.clearRequests();
+  drawFirsts.clear();
+  drawCounts.clear();
+  drawnStars = 0;
+  if (!catalog) {
+    return;
+  }
+
+  collect();
+  select(view, projection, style);
+  evict();
+  rebuild(state);
+
+  for (const int tile : visibleTiles) {
+    const auto cached = cache.find(tile);
+    if (cached == cache.end()) {
+      continue;
+    }
+    const std::size_t count =
+        std::min(cached->second.stars.size(), catalog->getStarCount(tile, magnitudeBin));
+    if (count > 0) {
+      drawFirsts.push_back(cached->second.first);
+      drawCounts.push_back(static_cast<int>(count));
+      drawnStars += count;
+    }
+  }
+
+  if (!drawFirsts.empty()) {
+    state.useProgram(shader->getID());
+    shader->setFloat("magnitudeLimit", magnitudeLimit);
+    shader->setFloat("brightness", style.brightness);
+    shader->setFloat("maxPointSize", std::min(style.maxPointSize, viewportHeight));
+    state.bindVertexArray(VAO);
+    state.setBlend(true);
+    state.setWireframe(false);
+
+    // Drawn first and without depth, so everything else in the scene covers them
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    glMultiDrawArrays(GL_POINTS, drawFirsts.data(), drawCounts.data(),
+                      static_cast<GLsizei>(drawFirsts.size()));
+    glDisable(GL_PROGRAM_POINT_SIZE);
+    glEnable(GL_DEPTH_TEST);
+  }
+  dispatch();
+}
+
+void StarRenderer::collect() {
+  batch.collect([this](const Request &request, std::vector<StarRecord> &stars) {
+    CachedTile &tile = cache[request.tile];
+    if (request.bin <= tile.bin) {
+      return;
+    }
+    cachedStars = cachedStars - tile.stars.size() + stars.size();
+    tile.stars = std::move(stars);
+    tile.bin = request.bin;
+    tile.lastUsed = frame;
+    dirty = true;
+  });
+}
+
+void StarRenderer::select(const glm::mat4 &view, const glm::mat4 &projection,
+                          const StarStyle &style) {
+  // The view's third row is the camera's backward axis in world space
+  const glm::vec3 forward = -glm::vec3(view[0][2], view[1][2], view[2][2]);
+  const float tanX = 1.0f / projection[0][0];
+  const float tanY = 1.0f / projection[1][1];
+  const float halfDiagonal = std::atan(std::sqrt((tanX * tanX) + (tanY * tanY)));
+
+  // Five magnitudes fainter for every tenfold narrowing of the view
+  const float referenceTan = std::tan(STAR_REFERENCE_FOV * 0.5f);
+  const float limit = style.magnitudeLimit + (5.0f * std::log10(referenceTan / tanY));
+  magnitudeBin = std::clamp(static_cast<int>(std::ceil(limit)) - STAR_MAGNITUDE_MIN, 0,
+                            STAR_MAGNITUDE_BINS);
+
+  visibleTiles.clear();
+  for (int tile = 0; tile < catalog->getTileCount(); ++tile) {
+    const float angle = std::acos(std::clamp(glm::dot(catalog->getTileCenter(tile), forward),
+                                             -1.0f, 1.0f));
+    if (angle <= halfDiagonal + catalog->getTileRadius(tile)) {
+      visibleTiles.push_back(tile);
+    }
+  }
+
+  // Stop at a brighter magnitude where the view holds more stars than the budget
+  const auto countStars = [this](int bin) {
+    std::size_t total = 0;
+    for (const int tile : visibleTiles) {
+      total += catalog->getStarCount(tile, bin);
+    }
+    return total;
+  };
+  while (magnitudeBin > 0 && countStars(magnitudeBin) > STAR_MAX_DRAWN) {
+    --magnitudeBin;
+  }
+  magnitudeLimit = std::min(limit, static_cast<float>(STAR_MAGNITUDE_MIN + magnitudeBin));
+
+  for (const int tile : visibleTiles) {
+    const auto cached = cache.find(tile);
+    const std::size_t wanted = catalog->getStarCount(tile, magnitudeBin);
+    if (cached == cache.end()) {
+      if (wanted > 0) {
+        request(tile, magnitudeBin);
+      }
+      continue;
+    }
+    CachedTile &entry = cached->second;
+    entry.lastUsed = frame;
+    if (entry.bin < magnitudeBin) {
+      if (wanted > entry.stars.size()) {
+        request(tile, magnitudeBin);
+      } else {
+        entry.bin = magnitudeBin; // nothing fainter in this tile
+      }
+    }
+  }
+}
+
+void StarRenderer::request(int tile, int bin) {
+  batch.request({tile, bin, catalog}, [tile](const Request &entry) { return entry.tile == tile; });
+}
+
+void StarRenderer::dispatch() {
+  // As many tiles as fit the batch, in the order they were found short
+  batch.dispatch(
+      [](const Request &) { return 0; },
+      [](const Request &entry) { return entry.catalog->getStarCount(entry.tile, entry.bin); },
+      STAR_BATCH_STARS,
+      [](const Request &entry, std::vector<StarRecord> &stars) {
+        const StarRecord *first = entry.catalog->getStars(entry.tile);
+        stars.assign(first, first + entry.catalog->getStarCount(entry.tile, entry.bin));
+      });
+}
+
+void StarRenderer::evict() {
+  // Least recently seen tiles first, never one in view
+  while (cachedStars > STAR_CACHE_STARS) {
+    auto oldest = cache.end();
+    for (auto it = cache.begin(); it != cache.end(); ++it) {
+      if (it->second.lastUsed < frame &&
+          (oldest == cache.end() || it->second.lastUsed < oldest->second.lastUsed)) {
+        oldest = it;
+      }
+    }
+    if (oldest == cache.end()) {
+      return;
+    }
+    cachedStars -= oldest->second.stars.size();
+    cache.erase(oldest);
+    dirty = true;
+  }
+}
+
+void StarRenderer::rebuild(GLStateCache &state) {
+  if (!dirty) {
+    return;
+  }
+  dirty = false;
+
+  std::vector<StarRecord> vertices;
+  vertices.reserve(cachedStars);
+  for (auto &[tile, entry] : cache) {
+    entry.first = static_cast<int>(vertices.size());
+    vertices.insert(vertices.end(), entry.stars.begin(), entry.stars.end());
+  }
+  state.bindArrayBuffer(VBO);
+  glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertices.size() * sizeof(StarRecord)),
+               vertices.data(), GL_STATIC_DRAW);
+}
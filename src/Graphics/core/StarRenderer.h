@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "StarCatalog.h"
+#include "core/background_batch.h"
+
+class GLStateCache;
+class Shader;
+
+struct StarStyle {
+  float magnitudeLimit = 6.5f; // faintest stars shown at a 45 degree field of view
+  float brightness = 1.0f;
+  float maxPointSize = 6.0f; // pixels, for the brightest stars
+
+  bool operator==(const StarStyle &) const = default;
+};
+
+// Star field behind the scene, streamed from a StarCatalog. Each frame picks the sky tiles the
+// view can see and the faintest magnitude worth drawing, which grows as the field of view
+// narrows the way a telescope reaches fainter stars. Only those tiles down to that magnitude are
+// read, on a background batch, and kept in a bounded cache; the whole catalog is never loaded.
+// Stars are drawn as points sized and dimmed by magnitude, under everything else.
+class StarRenderer {
+public:
+  explicit StarRenderer(std::shared_ptr<Shader> shader);
+  ~StarRenderer();
+
+  StarRenderer(const StarRenderer &) = delete;
+  StarRenderer &operator=(const StarRenderer &) = delete;
+
+  void setCatalog(std::shared_ptr<const StarCatalog> catalog);
+  const std::shared_ptr<const StarCatalog> &getCatalog() const { return catalog; }
+
+  void draw(const glm::mat4 &view, const glm::mat4 &projection, float viewportHeight,
+            const StarStyle &style, GLStateCache &state);
+
+  std::size_t getStarCount() const { return drawnStars; }
+  std::size_t getTileCount() const { return drawFirsts.size(); }
+  std::size_t getCachedCount() const { return cachedStars; }
+  std::size_t getPendingCount() const { return batch.getPendingCount(); }
+  float getMagnitudeLimit() const { return magnitudeLimit; }
+
+private:
+  struct CachedTile {
+    int bin = -1; // loaded down to STAR_MAGNITUDE_MIN + bin
+    std::vector<StarRecord> stars;
+    std::uint64_t lastUsed = 0;
+    int first = 0; // in the vertex buffer
+  };
+
+  // The catalog is held until the tile is read, even if it is replaced meanwhile
+  struct Request {
+    int tile = 0;
+    int bin = 0;
+    std::shared_ptr<const StarCatalog> catalog;
+  };
+
+  void collect();
+  void select(const glm::mat4 &view, const glm::mat4 &projection, const StarStyle &style);
+  void request(int tile, int bin);
+  void dispatch();
+  void evict();
+  void rebuild(GLStateCache &state);
+
+  std::shared_ptr<Shader> shader;
+  unsigned int VAO{}, VBO{};
+  std::shared_ptr<const StarCatalog> catalog;
+  std::uint64_t frame = 0;
+
+  // Tiles read so far, which the vertex buffer mirrors once `dirty` is cleared
+  std::unordered_map<int, CachedTile> cache;
+  std::size_t cachedStars = 0;
+  bool dirty = false;
+
+  // This frame's selection
+  std::vector<int> visibleTiles;
+  int magnitudeBin = 0;
+  float magnitudeLimit = 0.0f;
+  std::vector<int> drawFirsts;
+  std::vector<int> drawCounts;
+  std::size_t drawnStars = 0;
+
+  // Tiles found short this frame, read in the background
+  BackgroundBatch<Request, std::vector<StarRecord>> batch;
+};
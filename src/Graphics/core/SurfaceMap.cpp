@@ -0,0 +1,156 @@
+#include "SurfaceMap.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include "core/thread_pool.h"
+
+namespace {
+
+constexpr char SURFACE_MAGIC[8] = {'O', 'R', 'B', 'S', 'U', 'R', 'F', '1'};
+constexpr std::uint32_t SURFACE_VERSION = 1;
+
+// Tiles shaded per step of writeSurfaceMap, about 4 MB of texels
+constexpr std::size_t SURFACE_WRITE_BATCH = 64;
+
+struct FileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t levels;
+  std::uint32_t tileTexels;
+  std::uint32_t border;
+  std::uint64_t indexOffset;
+  std::uint64_t tileCount;
+};
+static_assert(sizeof(FileHeader) == 40, "surface map header must be packed");
+
+std::uint32_t nextSurfaceMapId() {
+  static std::atomic<std::uint32_t> counter{0};
+  return ++counter;
+}
+
+// Tiles in the levels above `level` of one face: 1 + 4 + 16 + ...
+std::size_t tilesAbove(int level) { return ((std::size_t{1} << (2 * level)) - 1) / 3; }
+
+std::size_t tileIndex(int levels, const TerrainChunkId &tile) {
+  const std::size_t cells = std::size_t{1} << tile.level;
+  return (static_cast<std::size_t>(tile.face) * tilesAbove(levels)) + tilesAbove(tile.level) +
+         (tile.y * cells) + tile.x;
+}
+
+// Header, index and every tile of a surface map
+void writeSurfaceTiles(std::ofstream &out, int levels, const SurfaceShader &shade) {
+  FileHeader header{};
+  std::memcpy(header.magic, SURFACE_MAGIC, sizeof(SURFACE_MAGIC));
+  header.version = SURFACE_VERSION;
+  header.levels = static_cast<std::uint32_t>(levels);
+  header.tileTexels = SURFACE_TILE_TEXELS;
+  header.border = SURFACE_TILE_BORDER;
+  header.indexOffset = sizeof(FileHeader);
+  header.tileCount = 6 * tilesAbove(levels);
+
+  // The index is written again once every tile's offset is known
+  std::vector<std::uint64_t> index(header.tileCount, 0);
+  const auto indexBytes = static_cast<std::streamsize>(index.size() * sizeof(std::uint64_t));
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(index.data()), indexBytes);
+  std::uint64_t offset = header.indexOffset + static_cast<std::uint64_t>(indexBytes);
+
+  std::vector<std::vector<glm::u8vec4>> batch(SURFACE_WRITE_BATCH);
+  for (int face = 0; face < 6; ++face) {
+    for (int level = 0; level < levels; ++level) {
+      const std::uint32_t cells = 1U << level;
+      const std::size_t count = static_cast<std::size_t>(cells) * cells;
+      for (std::size_t first = 0; first < count; first += SURFACE_WRITE_BATCH) {
+        const std::size_t size = std::min(SURFACE_WRITE_BATCH, count - first);
+        getThreadPool().parallelFor(size, 1, [&](std::size_t begin, std::size_t end) {
+          std::vector<glm::vec3> directions(static_cast<std::size_t>(SURFACE_TILE_STORED) *
+                                            SURFACE_TILE_STORED);
+          for (std::size_t k = begin; k < end; ++k) {
+            const auto cell = static_cast<std::uint32_t>(first + k);
+            const TerrainChunkId tile{face, level, cell % cells, cell / cells};
+            const glm::dvec2 low = tile.getMin();
+            const double step = (tile.getMax().x - low.x) / SURFACE_TILE_TEXELS;
+            // Texel centers; the border texels continue onto the neighbouring tile or face
+            for (int row = 0; row < SURFACE_TILE_STORED; ++row) {
+              for (int column = 0; column < SURFACE_TILE_STORED; ++column) {
+                const double u = low.x + ((column - SURFACE_TILE_BORDER + 0.5) * step);
+                const double v = low.y + ((row - SURFACE_TILE_BORDER + 0.5) * step);
+                directions[static_cast<std::size_t>((row * SURFACE_TILE_STORED) + column)] =
+                    glm::vec3(cubeFaceDirection(face, u, v));
+              }
+            }
+            shade(directions, batch[k]);
+          }
+        });
+
+        for (std::size_t k = 0; k < size; ++k) {
+          if (batch[k].size() * sizeof(glm::u8vec4) != SURFACE_TILE_BYTES) {
+            throw std::runtime_error("Surface shader returned the wrong number of texels");
+          }
+          out.write(reinterpret_cast<const char *>(batch[k].data()), SURFACE_TILE_BYTES);
+          const TerrainChunkId tile{face, level, static_cast<std::uint32_t>((first + k) % cells),
+                                    static_cast<std::uint32_t>((first + k) / cells)};
+          index[tileIndex(levels, tile)] = offset;
+          offset += SURFACE_TILE_BYTES;
+        }
+      }
+    }
+  }
+
+  out.seekp(static_cast<std::streamoff>(header.indexOffset));
+  out.write(reinterpret_cast<const char *>(index.data()), indexBytes);
+}
+
+} // namespace
+
+SurfaceMap::SurfaceMap(const std::string &filePath)
+    : id(nextSurfaceMapId()), path(filePath), file(filePath) {
+  FileHeader header{};
+  if (file.size() < sizeof(header)) {
+    throw std::runtime_error("Not a surface map: " + path);
+  }
+  std::memcpy(&header, file.data(), sizeof(header));
+  if (std::memcmp(header.magic, SURFACE_MAGIC, sizeof(SURFACE_MAGIC)) != 0) {
+    throw std::runtime_error("Not a surface map: " + path);
+  }
+  if (header.version != SURFACE_VERSION || header.tileTexels != SURFACE_TILE_TEXELS ||
+      header.border != SURFACE_TILE_BORDER) {
+    throw std::runtime_error("Unsupported surface map format: " + path);
+  }
+  if (header.levels < 1 || header.levels > SURFACE_MAP_MAX_LEVELS) {
+    throw std::runtime_error("Surface map has an invalid level count: " + path);
+  }
+
+  levels = static_cast<int>(header.levels);
+  const std::size_t tileCount = 6 * tilesAbove(levels);
+  if (header.tileCount != tileCount || header.indexOffset % sizeof(std::uint64_t) != 0 ||
+      header.indexOffset > file.size() ||
+      (file.size() - header.indexOffset) / sizeof(std::uint64_t) < tileCount) {
+    throw std::runtime_error("Surface map index is damaged: " + path);
+  }
+  offsets = reinterpret_cast<const std::uint64_t *>(file.data() + header.indexOffset);
+}
+
+const std::uint8_t *SurfaceMap::getTile(const TerrainChunkId &tile) const {
+  if (tile.level < 0 || tile.level >= levels) {
+    return nullptr;
+  }
+  // Offsets past the end of a truncated file count as missing tiles
+  const std::uint64_t offset = offsets[tileIndex(levels, tile)];
+  if (offset == 0 || file.size() < SURFACE_TILE_BYTES ||
+      offset > file.size() - SURFACE_TILE_BYTES) {
+    return nullptr;
+  }
+  return file.data() + offset;
+}
+
+void writeSurfaceMap(const std::string &path, int levels, const SurfaceShader &shade) {
+  if (levels < 1 || levels > SURFACE_MAP_MAX_LEVELS) {
+    throw std::invalid_argument("Surface map levels must be between 1 and " +
+                                std::to_string(SURFACE_MAP_MAX_LEVELS));
+  }
+
+  writeFileReplacing(path, [&](std::ofstream &out) { writeSurfaceTiles(out, levels, shade); });
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_precision.hpp>
+#include <string>
+#include <vector>
+#include "Terrain.h"
+#include "core/mapped_file.h"
+
+// Texels along each edge of a surface map tile, the border of neighbouring texels around it so
+// filtering never reads across into another tile, and the deepest level a map may have.
+constexpr int SURFACE_TILE_TEXELS = 128;
+constexpr int SURFACE_TILE_BORDER = 1;
+constexpr int SURFACE_TILE_STORED = SURFACE_TILE_TEXELS + (2 * SURFACE_TILE_BORDER);
+constexpr std::size_t SURFACE_TILE_BYTES =
+    static_cast<std::size_t>(SURFACE_TILE_STORED) * SURFACE_TILE_STORED * 4;
+constexpr int SURFACE_MAP_MAX_LEVELS = 12;
+
+// Color map of a CubeSphere's surface, read straight from a memory-mapped file. The map is a
+// pyramid of RGBA8 tiles for each cube face, with the same layout as the terrain quadtree: the
+// tile of a TerrainChunkId covers exactly that chunk, so tile (face, level, x, y) spans
+// 2^-level of the face. Tiles may be missing from a level; the coarser tile above stands in.
+//
+// File layout, little-endian:
+//   header  magic "ORBSURF1", version, levels, tile texels, border, index offset, tile count
+//   index   one 64-bit file offset per tile, by face, level, row and column; 0 where missing
+//   tiles   SURFACE_TILE_STORED rows of SURFACE_TILE_STORED RGBA8 texels each
+class SurfaceMap {
+public:
+  // Maps the file and checks its header and index; throws std::runtime_error if it is not a
+  // surface map this build can read.
+  explicit SurfaceMap(const std::string &path);
+
+  SurfaceMap(const SurfaceMap &) = delete;
+  SurfaceMap &operator=(const SurfaceMap &) = delete;
+
+  // Tells maps apart in caches; never reused.
+  std::uint32_t getId() const { return id; }
+  const std::string &getPath() const { return path; }
+  int getLevels() const { return levels; }
+
+  // SURFACE_TILE_BYTES of texels in the mapping, or nullptr where the file has no such tile.
+  // Reading them may fault pages in from disk, so the renderer copies tiles on its loader.
+  const std::uint8_t *getTile(const TerrainChunkId &tile) const;
+
+private:
+  std::uint32_t id;
+  std::string path;
+  MappedFile file;
+  int levels = 0;
+  const std::uint64_t *offsets = nullptr;
+};
+
+// Fills `texels` with the colors at unit `directions`, one per direction.
+using SurfaceShader = std::function<void(const std::vector<glm::vec3> &directions,
+                                         std::vector<glm::u8vec4> &texels)>;
+
+// Writes a complete map of `levels` levels, each texel shaded at the center of its footprint on
+// the sphere. Tiles are shaded on the thread pool and streamed to the file level by level. The
+// file is replaced only once complete, so maps already open on it keep their old contents.
+void writeSurfaceMap(const std::string &path, int levels, const SurfaceShader &shade);
@@ -0,0 +1,268 @@
+#include "Terrain.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+
+// The same cube-to-sphere mapping as CubeSphere::spherify, in double so that chunks deep in
+// the tree still get distinct vertices.
+glm::dvec3 spherify(const glm::dvec3 &point) {
+  const double x2 = point.x * point.x;
+  const double y2 = point.y * point.y;
+  const double z2 = point.z * point.z;
+  return {point.x * std::sqrt(1.0 - ((y2 + z2) / 2.0) + ((y2 * z2) / 3.0)),
+          point.y * std::sqrt(1.0 - ((x2 + z2) / 2.0) + ((x2 * z2) / 3.0)),
+          point.z * std::sqrt(1.0 - ((x2 + y2) / 2.0) + ((x2 * y2) / 3.0))};
+}
+
+// Integer hash of a lattice point; multiplies, xors and shifts only, all of which vectorize.
+inline std::uint32_t hashLattice(std::int32_t x, std::int32_t y, std::int32_t z,
+                                 std::uint32_t seed) {
+  std::uint32_t h = seed ^ (static_cast<std::uint32_t>(x) * 0x8DA6B343U) ^
+                    (static_cast<std::uint32_t>(y) * 0xD8163841U) ^
+                    (static_cast<std::uint32_t>(z) * 0xCB1AB31FU);
+  h ^= h >> 16;
+  h *= 0x7FEB352DU;
+  h ^= h >> 15;
+  h *= 0x846CA68BU;
+  h ^= h >> 16;
+  return h;
+}
+
+// Dot product with one of Perlin's twelve edge gradients picked by the low hash bits
+inline float gradient(std::uint32_t hash, float x, float y, float z) {
+  const std::uint32_t h = hash & 15U;
+  const float u = h < 8U ? x : y;
+  const float v = h < 4U ? y : (h == 12U || h == 14U ? x : z);
+  return ((h & 1U) != 0U ? -u : u) + ((h & 2U) != 0U ? -v : v);
+}
+
+// Truncate, then step down for negative fractions; std::floor is a library call the
+// vectorizer will not touch
+inline std::int32_t floorToInt(float value) {
+  const auto truncated = static_cast<std::int32_t>(value);
+  return truncated - (value < static_cast<float>(truncated) ? 1 : 0);
+}
+
+inline float fade(float t) { return t * t * t * ((t * ((t * 6.0f) - 15.0f)) + 10.0f); }
+
+inline float lerp(float a, float b, float t) { return a + (t * (b - a)); }
+
+inline float gradientNoise(float x, float y, float z, std::uint32_t seed) {
+  const std::int32_t ix = floorToInt(x);
+  const std::int32_t iy = floorToInt(y);
+  const std::int32_t iz = floorToInt(z);
+  const float dx = x - static_cast<float>(ix);
+  const float dy = y - static_cast<float>(iy);
+  const float dz = z - static_cast<float>(iz);
+
+  const float n000 = gradient(hashLattice(ix, iy, iz, seed), dx, dy, dz);
+  const float n100 = gradient(hashLattice(ix + 1, iy, iz, seed), dx - 1.0f, dy, dz);
+  const float n010 = gradient(hashLattice(ix, iy + 1, iz, seed), dx, dy - 1.0f, dz);
+  const float n110 = gradient(hashLattice(ix + 1, iy + 1, iz, seed), dx - 1.0f, dy - 1.0f, dz);
+  const float n001 = gradient(hashLattice(ix, iy, iz + 1, seed), dx, dy, dz - 1.0f);
+  const float n101 = gradient(hashLattice(ix + 1, iy, iz + 1, seed), dx - 1.0f, dy, dz - 1.0f);
+  const float n011 = gradient(hashLattice(ix, iy + 1, iz + 1, seed), dx, dy - 1.0f, dz - 1.0f);
+  const float n111 =
+      gradient(hashLattice(ix + 1, iy + 1, iz + 1, seed), dx - 1.0f, dy - 1.0f, dz - 1.0f);
+
+  const float u = fade(dx);
+  const float v = fade(dy);
+  const float w = fade(dz);
+  return lerp(lerp(lerp(n000, n100, u), lerp(n010, n110, u), v),
+              lerp(lerp(n001, n101, u), lerp(n011, n111, u), v), w);
+}
+
+// One octave over a batch of points
+void addOctave(const float *x, const float *y, const float *z, float *out, std::size_t count,
+               float frequency, float amplitude, std::uint32_t seed) {
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] += amplitude * gradientNoise(x[i] * frequency, y[i] * frequency, z[i] * frequency,
+                                        seed);
+  }
+}
+
+} // namespace
+
+std::uint64_t TerrainChunkId::pack() const {
+  return (static_cast<std::uint64_t>(face) << 61) | (static_cast<std::uint64_t>(level) << 56) |
+         (static_cast<std::uint64_t>(x) << 28) | static_cast<std::uint64_t>(y);
+}
+
+TerrainChunkId TerrainChunkId::unpack(std::uint64_t key) {
+  constexpr std::uint64_t coordinateMask = (std::uint64_t{1} << 28) - 1;
+  return {static_cast<int>(key >> 61), static_cast<int>((key >> 56) & 31U),
+          static_cast<std::uint32_t>((key >> 28) & coordinateMask),
+          static_cast<std::uint32_t>(key & coordinateMask)};
+}
+
+glm::dvec2 TerrainChunkId::getMin() const {
+  const double size = 2.0 / static_cast<double>(std::uint64_t{1} << level);
+  return {-1.0 + (x * size), -1.0 + (y * size)};
+}
+
+glm::dvec2 TerrainChunkId::getMax() const {
+  const double size = 2.0 / static_cast<double>(std::uint64_t{1} << level);
+  return {-1.0 + ((x + 1) * size), -1.0 + ((y + 1) * size)};
+}
+
+glm::dvec3 cubeFacePoint(int face, double u, double v) {
+  const double fixed = (face & 1) == 0 ? 1.0 : -1.0;
+  if (face < 2) {
+    return {fixed, u, v};
+  }
+  if (face < 4) {
+    return {u, fixed, v};
+  }
+  return {u, v, fixed};
+}
+
+void cubeFaceCoordinates(const glm::dvec3 &point, int &face, double &u, double &v) {
+  // The face is the dominant axis; the other two coordinates, projected onto it, are (u, v)
+  const glm::dvec3 magnitude = glm::abs(point);
+  if (magnitude.x >= magnitude.y && magnitude.x >= magnitude.z) {
+    face = point.x >= 0.0 ? 0 : 1;
+    u = point.y / magnitude.x;
+    v = point.z / magnitude.x;
+  } else if (magnitude.y >= magnitude.z) {
+    face = point.y >= 0.0 ? 2 : 3;
+    u = point.x / magnitude.y;
+    v = point.z / magnitude.y;
+  } else {
+    face = point.z >= 0.0 ? 4 : 5;
+    u = point.x / magnitude.z;
+    v = point.y / magnitude.z;
+  }
+}
+
+glm::dvec3 cubeFaceDirection(int face, double u, double v) {
+  int onFace = 0;
+  double faceU = 0.0;
+  double faceV = 0.0;
+  cubeFaceCoordinates(cubeFacePoint(face, u, v), onFace, faceU, faceV);
+  return glm::normalize(spherify(cubeFacePoint(onFace, faceU, faceV)));
+}
+
+void sampleTerrainNoise(const float *x, const float *y, const float *z, float *out,
+                        std::size_t count, const TerrainSettings &settings) {
+  std::fill(out, out + count, 0.0f);
+
+  float frequency = settings.baseFrequency;
+  float amplitude = 1.0f;
+  float total = 0.0f;
+  for (int octave = 0; octave < settings.octaves; ++octave) {
+    const std::uint32_t seed =
+        (settings.seed * 0x9E3779B9U) + (static_cast<std::uint32_t>(octave) * 0x632BE5ABU);
+    addOctave(x, y, z, out, count, frequency, amplitude, seed);
+    total += amplitude;
+    amplitude *= 0.5f;
+    frequency *= 2.0f;
+  }
+
+  const float normalize = total > 0.0f ? 1.0f / total : 0.0f;
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] *= normalize;
+  }
+}
+
+void buildTerrainChunk(const TerrainSettings &settings, TerrainChunkId id,
+                       TerrainChunkData &out) {
+  // One extra ring of samples around the chunk for the normals at its edges. Samples past the
+  // face's edge are taken on the neighbouring face, so shading is seamless across faces.
+  constexpr int border = TERRAIN_CHUNK_SIDE + 2;
+  constexpr std::size_t sampleCount = static_cast<std::size_t>(border) * border;
+  const glm::dvec2 low = id.getMin();
+  const double step = (id.getMax().x - low.x) / TERRAIN_CHUNK_CELLS;
+
+  std::vector<glm::dvec3> directions(sampleCount);
+  std::vector<float> x(sampleCount);
+  std::vector<float> y(sampleCount);
+  std::vector<float> z(sampleCount);
+  std::vector<float> heights(sampleCount);
+  for (int i = 0; i < border; ++i) {
+    for (int j = 0; j < border; ++j) {
+      const auto k = static_cast<std::size_t>((i * border) + j);
+      directions[k] =
+          cubeFaceDirection(id.face, low.x + ((j - 1) * step), low.y + ((i - 1) * step));
+      x[k] = static_cast<float>(directions[k].x);
+      y[k] = static_cast<float>(directions[k].y);
+      z[k] = static_cast<float>(directions[k].z);
+    }
+  }
+  // Without relief the chunk is a patch of the plain sphere
+  if (settings.heightScale != 0.0f) {
+    sampleTerrainNoise(x.data(), y.data(), z.data(), heights.data(), sampleCount, settings);
+  }
+
+  std::vector<glm::dvec3> positions(sampleCount);
+  for (std::size_t k = 0; k < sampleCount; ++k) {
+    positions[k] = directions[k] * (1.0 + (settings.heightScale * static_cast<double>(heights[k])));
+  }
+  const auto at = [&](int i, int j) -> const glm::dvec3 & {
+    return positions[static_cast<std::size_t>((i * border) + j)];
+  };
+
+  constexpr int middle = (TERRAIN_CHUNK_CELLS / 2) + 1;
+  out.id = id;
+  out.center = at(middle, middle);
+  out.boundingRadius = 0.0;
+  out.vertices.clear();
+  out.vertices.reserve(static_cast<std::size_t>(TERRAIN_CHUNK_VERTICES) * 6);
+  for (int i = 1; i <= TERRAIN_CHUNK_SIDE; ++i) {
+    for (int j = 1; j <= TERRAIN_CHUNK_SIDE; ++j) {
+      const glm::dvec3 &position = at(i, j);
+      glm::dvec3 normal = glm::normalize(
+          glm::cross(at(i, j + 1) - at(i, j - 1), at(i + 1, j) - at(i - 1, j)));
+      // Faces run in different directions, so orient every normal outward
+      if (glm::dot(normal, position) < 0.0) {
+        normal = -normal;
+      }
+
+      const glm::vec3 local(position - out.center);
+      out.vertices.insert(out.vertices.end(), {local.x, local.y, local.z,
+                                               static_cast<float>(normal.x),
+                                               static_cast<float>(normal.y),
+                                               static_cast<float>(normal.z)});
+      out.boundingRadius = std::max(out.boundingRadius, glm::length(position - out.center));
+    }
+  }
+}
+
+void shadeTerrainSurface(const TerrainSettings &settings, const std::vector<glm::vec3> &directions,
+                         std::vector<glm::u8vec4> &texels) {
+  // Height bands of the noise, which rarely leaves [-0.6, 0.6]
+  struct Band {
+    float height;
+    glm::vec3 color;
+  };
+  constexpr Band bands[] = {{-0.6f, {0.05f, 0.12f, 0.35f}}, {-0.02f, {0.15f, 0.35f, 0.6f}},
+                            {0.0f, {0.76f, 0.70f, 0.50f}},  {0.08f, {0.25f, 0.48f, 0.18f}},
+                            {0.25f, {0.42f, 0.37f, 0.30f}}, {0.4f, {0.95f, 0.95f, 0.97f}}};
+  constexpr int bandCount = static_cast<int>(std::size(bands));
+
+  const std::size_t count = directions.size();
+  std::vector<float> x(count);
+  std::vector<float> y(count);
+  std::vector<float> z(count);
+  std::vector<float> heights(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    x[i] = directions[i].x;
+    y[i] = directions[i].y;
+    z[i] = directions[i].z;
+  }
+  sampleTerrainNoise(x.data(), y.data(), z.data(), heights.data(), count, settings);
+
+  texels.resize(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    int band = 0;
+    while (band + 2 < bandCount && heights[i] > bands[band + 1].height) {
+      ++band;
+    }
+    const Band &low = bands[band];
+    const Band &high = bands[band + 1];
+    const float t = glm::clamp((heights[i] - low.height) / (high.height - low.height), 0.0f, 1.0f);
+    const glm::vec3 color = glm::mix(low.color, high.color, t);
+    texels[i] = glm::u8vec4(glm::round(color * 255.0f), 255);
+  }
+}
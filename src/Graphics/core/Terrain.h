@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_precision.hpp>
+#include <vector>
+
+// Procedural relief of a CubeSphere. Heights are fractions of the radius, so the same settings
+// give the same landscape at any size.
+struct TerrainSettings {
+  bool enabled = false;
+  float heightScale = 0.02f;  // largest relief over the base radius
+  float baseFrequency = 2.0f; // features per radius at the coarsest octave
+  int octaves = 16;
+  std::uint32_t seed = 1;
+
+  bool operator==(const TerrainSettings &) const = default;
+};
+
+// Grid cells along each edge of a chunk. Even, so every other edge vertex lies on the edge of a
+// neighbour one level coarser.
+constexpr int TERRAIN_CHUNK_CELLS = 16;
+constexpr int TERRAIN_CHUNK_SIDE = TERRAIN_CHUNK_CELLS + 1;
+constexpr int TERRAIN_CHUNK_VERTICES = TERRAIN_CHUNK_SIDE * TERRAIN_CHUNK_SIDE;
+constexpr int TERRAIN_MAX_LEVEL = 24;
+
+// Node of a cube face's quadtree: face 0-5 in CubeSphere's order (+X, -X, +Y, -Y, +Z, -Z) and
+// the cell (x, y) among the 2^level by 2^level at its level, x along the face's u axis.
+struct TerrainChunkId {
+  int face = 0;
+  int level = 0;
+  std::uint32_t x = 0;
+  std::uint32_t y = 0;
+
+  std::uint64_t pack() const;
+  static TerrainChunkId unpack(std::uint64_t key);
+
+  TerrainChunkId parent() const { return {face, level - 1, x >> 1, y >> 1}; }
+  TerrainChunkId child(int quadrant) const {
+    return {face, level + 1, (x << 1) | static_cast<std::uint32_t>(quadrant & 1),
+            (y << 1) | static_cast<std::uint32_t>(quadrant >> 1)};
+  }
+
+  // Face coordinates of the chunk's corners, in [-1, 1]
+  glm::dvec2 getMin() const;
+  glm::dvec2 getMax() const;
+
+  bool operator==(const TerrainChunkId &) const = default;
+};
+
+// Point on the surface of the unit cube for face coordinates (u, v), laid out as in
+// CubeSphere::buildVertices, and the inverse for any point away from the origin.
+glm::dvec3 cubeFacePoint(int face, double u, double v);
+void cubeFaceCoordinates(const glm::dvec3 &point, int &face, double &u, double &v);
+
+// Unit direction of face coordinates (u, v) under CubeSphere's cube-to-sphere mapping.
+// Coordinates past the face's edge continue onto the neighbouring face.
+glm::dvec3 cubeFaceDirection(int face, double u, double v);
+
+// Fractal sum of 3D gradient noise (Perlin 2002) at `count` points, in roughly [-1, 1]. Each
+// octave is one plain loop over the coordinate arrays with every branch written as a select, so
+// the compiler vectorizes it; the lattice is hashed instead of looked up in a table.
+void sampleTerrainNoise(const float *x, const float *y, const float *z, float *out,
+                        std::size_t count, const TerrainSettings &settings);
+
+// Geometry of one chunk in units of the radius: interleaved position and normal like MeshData,
+// with positions relative to `center` so they keep full precision however deep the chunk is.
+struct TerrainChunkData {
+  TerrainChunkId id;
+  glm::dvec3 center{0.0};
+  double boundingRadius = 0.0; // around `center`
+  std::vector<float> vertices;
+};
+
+void buildTerrainChunk(const TerrainSettings &settings, TerrainChunkId id, TerrainChunkData &out);
+
+// Colors of the terrain at unit directions, from sea floor to snow by height, for baking the
+// landscape into a surface map.
+void shadeTerrainSurface(const TerrainSettings &settings, const std::vector<glm::vec3> &directions,
+                         std::vector<glm::u8vec4> &texels);
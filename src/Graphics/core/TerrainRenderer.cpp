@@ -0,0 +1,465 @@
+#include "TerrainRenderer.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <utility>
+#include "GLStateCache.h"
+#include "Graphics/bodies/cubeSphere.h"
+#include "Graphics/shader.h"
+
+namespace {
+
+// Chunks kept in GPU memory (about 7 KB each), chunks drawn per body at most, and chunks
+// generated per background batch.
+constexpr int TERRAIN_POOL_CHUNKS = 4096;
+constexpr std::size_t TERRAIN_MAX_LEAVES = 1024;
+constexpr std::size_t TERRAIN_BATCH_CHUNKS = 32;
+
+constexpr int TERRAIN_VERTEX_FLOATS = 6;
+
+using LeafMap = std::unordered_map<std::uint64_t, bool>; // packed chunk id -> visible
+
+// The leaf just across the middle of one of a chunk's edges (-v, +u, +v, -u), which may lie on
+// the neighbouring face. False where the quadtree has no leaf there.
+bool findNeighbour(const LeafMap &leaves, const TerrainChunkId &id, int edge,
+                   TerrainChunkId &neighbour) {
+  const glm::dvec2 low = id.getMin();
+  const glm::dvec2 high = id.getMax();
+  const glm::dvec2 middle = (low + high) * 0.5;
+  const double margin = (high.x - low.x) * 1.0e-3;
+  glm::dvec2 across = middle;
+  switch (edge) {
+  case 0:
+    across.y = low.y - margin;
+    break;
+  case 1:
+    across.x = high.x + margin;
+    break;
+  case 2:
+    across.y = high.y + margin;
+    break;
+  default:
+    across.x = low.x - margin;
+    break;
+  }
+
+  int face = 0;
+  double u = 0.0;
+  double v = 0.0;
+  cubeFaceCoordinates(cubeFacePoint(id.face, across.x, across.y), face, u, v);
+  for (int level = 0; level <= TERRAIN_MAX_LEVEL; ++level) {
+    const double cells = static_cast<double>(std::uint64_t{1} << level);
+    const double last = cells - 1.0;
+    const auto cell = [&](double coordinate) {
+      return static_cast<std::uint32_t>(std::clamp(std::floor((coordinate + 1.0) * 0.5 * cells),
+                                                    0.0, last));
+    };
+    const TerrainChunkId candidate{face, level, cell(u), cell(v)};
+    if (leaves.contains(candidate.pack())) {
+      neighbour = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool isDescendant(const TerrainChunkId &chunk, const TerrainChunkId &ancestor) {
+  const int depth = chunk.level - ancestor.level;
+  return chunk.face == ancestor.face && depth > 0 && (chunk.x >> depth) == ancestor.x &&
+         (chunk.y >> depth) == ancestor.y;
+}
+
+} // namespace
+
+TerrainRenderer::TerrainRenderer(std::shared_ptr<Shader> terrainShader)
+    : shader(std::move(terrainShader)), pool(TERRAIN_POOL_CHUNKS), slots(TERRAIN_POOL_CHUNKS) {
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &VBO);
+  glGenBuffers(1, &EBO);
+
+  glBindVertexArray(VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  glBufferData(GL_ARRAY_BUFFER,
+               static_cast<GLsizeiptr>(TERRAIN_POOL_CHUNKS) * TERRAIN_CHUNK_VERTICES *
+                   TERRAIN_VERTEX_FLOATS * sizeof(float),
+               nullptr, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+  buildIndices();
+
+  // Same layout as Mesh: position then normal
+  constexpr GLsizei stride = TERRAIN_VERTEX_FLOATS * sizeof(float);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void *)0);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void *)(3 * sizeof(float)));
+  glEnableVertexAttribArray(1);
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+TerrainRenderer::~TerrainRenderer() {
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteBuffers(1, &VBO);
+  glDeleteBuffers(1, &EBO);
+}
+
+void TerrainRenderer::buildIndices() {
+  // One index list per combination of edges next to a coarser chunk. On those edges each odd
+  // vertex folds onto the even one before it, so the edge becomes the coarse chunk's straight
+  // segments and the triangles beside it a fan; the folded triangles are dropped.
+  constexpr int n = TERRAIN_CHUNK_CELLS;
+  std::vector<unsigned int> indices;
+  for (int stitch = 0; stitch < 16; ++stitch) {
+    const auto vertex = [stitch](int i, int j) {
+      if ((j & 1) != 0 && ((i == 0 && (stitch & 1) != 0) || (i == n && (stitch & 4) != 0))) {
+        --j;
+      } else if ((i & 1) != 0 &&
+                 ((j == n && (stitch & 2) != 0) || (j == 0 && (stitch & 8) != 0))) {
+        --i;
+      }
+      return static_cast<unsigned int>((i * TERRAIN_CHUNK_SIDE) + j);
+    };
+    const auto triangle = [&indices](unsigned int a, unsigned int b, unsigned int c) {
+      if (a != b && b != c && a != c) {
+        indices.insert(indices.end(), {a, b, c});
+      }
+    };
+
+    stitchOffsets[stitch] = static_cast<int>(indices.size());
+    for (int i = 0; i < n; ++i) {
+      for (int j = 0; j < n; ++j) {
+        // Same winding as CubeSphere::buildIndices
+        const unsigned int corner = vertex(i, j);
+        const unsigned int below = vertex(i + 1, j);
+        const unsigned int next = vertex(i, j + 1);
+        triangle(corner, below, next);
+        triangle(next, below, vertex(i + 1, j + 1));
+      }
+    }
+    stitchCounts[stitch] = static_cast<int>(indices.size()) - stitchOffsets[stitch];
+  }
+
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(),
+               GL_STATIC_DRAW);
+}
+
+void TerrainRenderer::begin(const glm::mat4 &viewMatrix, const glm::mat4 &projection,
+                            float viewportHeight, float pixelError, int levels,
+                            GLStateCache &state) {
+  pool.beginFrame();
+  view = glm::dmat4(viewMatrix);
+  cameraPosition = glm::dvec3(glm::inverse(view)[3]);
+  frustum = Frustum::fromViewProjection(projection * viewMatrix);
+  // projection[1][1] is cot(fov / 2), as in CullingPass::run
+  pixelScale = projection[1][1] * 0.5f * viewportHeight;
+  maxPixelError = std::max(pixelError, 0.1f);
+  maxLevel = std::clamp(levels, 0, TERRAIN_MAX_LEVEL);
+  draws.clear();
+  batch.clearRequests();
+  surfaces.begin();
+
+  state.bindArrayBuffer(VBO);
+  batch.collect([this](const Request &request, const TerrainChunkData &data) {
+    upload(request, data);
+  });
+}
+
+bool TerrainRenderer::add(const CubeSphere &body) {
+  Planet planet;
+  planet.id = body.getTerrainId();
+  planet.settings = body.getTerrain();
+  if (!planet.settings.enabled) {
+    planet.settings.heightScale = 0.0f;
+  }
+  planet.surface = body.getSurfaceMap();
+  const glm::dvec3 scale = glm::dvec3(body.getScale()) * static_cast<double>(body.getSize());
+  planet.model = glm::translate(glm::dmat4(1.0), glm::dvec3(body.getPosition())) *
+                 glm::mat4_cast(glm::dquat(body.getOrientation())) *
+                 glm::scale(glm::dmat4(1.0), scale);
+  planet.scale = glm::max(std::abs(scale.x), glm::max(std::abs(scale.y), std::abs(scale.z)));
+
+  // A point of the surface is hidden once it is farther than the tangent from the camera to the
+  // lowest ground plus the tangent from there to the highest peaks. Nothing is hidden from below
+  // the lowest ground.
+  const double relief = std::max(static_cast<double>(planet.settings.heightScale), 0.0);
+  const double lowest =
+      (1.0 - relief) * glm::min(std::abs(scale.x), glm::min(std::abs(scale.y), std::abs(scale.z)));
+  const double highest = (1.0 + relief) * planet.scale;
+  const double eye = glm::length(cameraPosition - glm::dvec3(body.getPosition()));
+  planet.horizon = eye > lowest ? std::sqrt((eye * eye) - (lowest * lowest)) +
+                                      std::sqrt((highest * highest) - (lowest * lowest))
+                                : std::numeric_limits<double>::infinity();
+
+  bool ready = true;
+  for (int face = 0; face < 6; ++face) {
+    if (!isResident(planet, {face, 0, 0, 0})) {
+      request(planet, {face, 0, 0, 0});
+      ready = false;
+    }
+  }
+  if (!ready) {
+    return false;
+  }
+
+  // Breadth first, so the chunk budget goes to the coarse levels of the whole body before any
+  // one region gets fine. Chunks outside the view are never split.
+  LeafMap leaves;
+  std::vector<TerrainChunkId> queue;
+  for (int face = 0; face < 6; ++face) {
+    queue.push_back({face, 0, 0, 0});
+  }
+  for (std::size_t head = 0; head < queue.size(); ++head) {
+    const TerrainChunkId id = queue[head];
+    const Slot &slot = *find(planet, id);
+    const bool visible = isVisible(planet, slot);
+    const std::size_t planned = leaves.size() + (queue.size() - head - 1);
+    if (visible && id.level < maxLevel && planned + 4 <= TERRAIN_MAX_LEAVES &&
+        (getPixelError(planet, slot, id.level) > maxPixelError ||
+         getTileLevel(planet, slot, id.level) > id.level)) {
+      if (hasResidentChildren(planet, id)) {
+        for (int quadrant = 0; quadrant < 4; ++quadrant) {
+          queue.push_back(id.child(quadrant));
+        }
+        continue;
+      }
+      for (int quadrant = 0; quadrant < 4; ++quadrant) {
+        request(planet, id.child(quadrant));
+      }
+    }
+    leaves.emplace(id.pack(), visible);
+  }
+  balance(planet, leaves);
+
+  const glm::mat3 normal = glm::transpose(glm::inverse(glm::mat3(planet.model)));
+  for (const auto &[key, visible] : leaves) {
+    if (!visible) {
+      continue;
+    }
+    const TerrainChunkId id = TerrainChunkId::unpack(key);
+    Draw draw;
+    draw.slot = pool.find({planet.id, key});
+    for (int edge = 0; edge < 4; ++edge) {
+      TerrainChunkId neighbour;
+      if (findNeighbour(leaves, id, edge, neighbour) && neighbour.level < id.level) {
+        draw.stitch |= 1 << edge;
+      }
+    }
+
+    // Composed in double and relative to the chunk, so the vertices keep their precision
+    // however large the body or close the camera
+    const glm::dmat4 chunkModel =
+        glm::translate(planet.model, slots[static_cast<std::size_t>(draw.slot)].center);
+    draw.model = glm::mat4(chunkModel);
+    draw.modelView = glm::mat4(view * chunkModel);
+    draw.normal = normal;
+    draw.color = body.getColor();
+    if (planet.surface) {
+      const Slot &slot = slots[static_cast<std::size_t>(draw.slot)];
+      surfaces.lookup(planet.surface, id, getTileLevel(planet, slot, id.level), draw.surface);
+    }
+    draws.push_back(draw);
+  }
+  return true;
+}
+
+void TerrainRenderer::balance(const Planet &planet, LeafMap &leaves) {
+  // A visible chunk may border chunks at most one level coarser. The coarse side is split where
+  // its children are resident; otherwise the fine side is merged back into its parent until they
+  // arrive. Hidden chunks are not drawn, so they never need stitching.
+  std::vector<std::uint64_t> work;
+  const auto queueVisible = [&] {
+    for (const auto &[key, visible] : leaves) {
+      if (visible) {
+        work.push_back(key);
+      }
+    }
+  };
+  queueVisible();
+
+  std::size_t steps = (leaves.size() * 16) + 64;
+  while (!work.empty() && steps-- > 0) {
+    const std::uint64_t key = work.back();
+    work.pop_back();
+    const auto leaf = leaves.find(key);
+    if (leaf == leaves.end() || !leaf->second) {
+      continue; // merged away or hidden
+    }
+
+    const TerrainChunkId id = TerrainChunkId::unpack(key);
+    for (int edge = 0; edge < 4; ++edge) {
+      TerrainChunkId coarse;
+      if (!findNeighbour(leaves, id, edge, coarse) || coarse.level >= id.level - 1 ||
+          !leaves.at(coarse.pack())) {
+        continue;
+      }
+
+      if (hasResidentChildren(planet, coarse)) {
+        leaves.erase(coarse.pack());
+        for (int quadrant = 0; quadrant < 4; ++quadrant) {
+          const TerrainChunkId child = coarse.child(quadrant);
+          const bool visible = isVisible(planet, *find(planet, child));
+          leaves.emplace(child.pack(), visible);
+          if (visible) {
+            work.push_back(child.pack());
+          }
+        }
+        work.push_back(key);
+      } else {
+        for (int quadrant = 0; quadrant < 4; ++quadrant) {
+          request(planet, coarse.child(quadrant));
+        }
+        // Every ancestor of a selected chunk was resident to be split
+        const TerrainChunkId parent = id.parent();
+        std::erase_if(leaves, [&](const auto &entry) {
+          return isDescendant(TerrainChunkId::unpack(entry.first), parent);
+        });
+        leaves.emplace(parent.pack(), isVisible(planet, *find(planet, parent)));
+        // The merged chunk can be too coarse for leaves already checked
+        work.clear();
+        queueVisible();
+      }
+      break;
+    }
+  }
+}
+
+const TerrainRenderer::Slot *TerrainRenderer::find(const Planet &planet, TerrainChunkId id) {
+  const int index = pool.find({planet.id, id.pack()});
+  return index < 0 ? nullptr : &slots[static_cast<std::size_t>(index)];
+}
+
+bool TerrainRenderer::isResident(const Planet &planet, TerrainChunkId id) const {
+  return pool.contains({planet.id, id.pack()});
+}
+
+bool TerrainRenderer::hasResidentChildren(const Planet &planet, TerrainChunkId id) const {
+  if (id.level >= TERRAIN_MAX_LEVEL) {
+    return false;
+  }
+  for (int quadrant = 0; quadrant < 4; ++quadrant) {
+    if (!isResident(planet, id.child(quadrant))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TerrainRenderer::request(const Planet &planet, TerrainChunkId id) {
+  const PageKey key{planet.id, id.pack()};
+  if (!pool.contains(key)) {
+    batch.request({key, planet.settings},
+                  [&key](const Request &entry) { return entry.key == key; });
+  }
+}
+
+bool TerrainRenderer::isVisible(const Planet &planet, const Slot &slot) const {
+  const glm::dvec3 world(planet.model * glm::dvec4(slot.center, 1.0));
+  const double worldRadius = slot.boundingRadius * planet.scale;
+  if (glm::length(world - cameraPosition) - worldRadius > planet.horizon) {
+    return false;
+  }
+
+  const glm::vec3 center(world);
+  const auto radius = static_cast<float>(worldRadius);
+  return std::all_of(std::begin(frustum.planes), std::end(frustum.planes),
+                     [&](const glm::vec4 &plane) {
+                       return glm::dot(glm::vec3(plane), center) + plane.w >= -radius;
+                     });
+}
+
+double TerrainRenderer::getDistance(const Planet &planet, const Slot &slot) const {
+  // To the nearest point of the bounding sphere
+  const glm::dvec3 center(planet.model * glm::dvec4(slot.center, 1.0));
+  const double radius = slot.boundingRadius * planet.scale;
+  return std::max(glm::length(center - cameraPosition) - radius, 1.0e-9);
+}
+
+float TerrainRenderer::getPixelError(const Planet &planet, const Slot &slot, int level) const {
+  if (level >= TERRAIN_MAX_LEVEL) {
+    return 0.0f;
+  }
+
+  // Geometric error against the next level, in units of the radius: the relief finer than the
+  // chunk's cells, whose fractal amplitude grows in proportion to the cell size, plus the sag
+  // of the sphere across a cell.
+  const double cell = 2.0 * slot.boundingRadius / TERRAIN_CHUNK_CELLS;
+  const double roughness =
+      2.0 * static_cast<double>(planet.settings.heightScale * planet.settings.baseFrequency);
+  const double error = cell * (roughness + (cell / 8.0)) * planet.scale;
+  return static_cast<float>(error * pixelScale / getDistance(planet, slot));
+}
+
+int TerrainRenderer::getTileLevel(const Planet &planet, const Slot &slot, int level) const {
+  if (!planet.surface) {
+    return -1;
+  }
+  // A tile spans its chunk with SURFACE_TILE_TEXELS texels, so each level down halves the
+  // texels across a chunk of this one's size. Texels stay at most a pixel wide.
+  const double pixels = std::max(
+      2.0 * slot.boundingRadius * planet.scale * pixelScale / getDistance(planet, slot), 1.0);
+  const auto finer = static_cast<int>(std::ceil(std::log2(pixels / SURFACE_TILE_TEXELS)));
+  return std::clamp(level + finer, 0, planet.surface->getLevels() - 1);
+}
+
+void TerrainRenderer::draw(GLStateCache &state) {
+  if (!draws.empty()) {
+    state.useProgram(shader->getID());
+    state.bindVertexArray(VAO);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, surfaces.getTexture());
+    shader->setInt("surfaceAtlas", 0);
+    for (const Draw &entry : draws) {
+      shader->setMat4("chunkModel", entry.model);
+      shader->setMat4("chunkModelView", entry.modelView);
+      shader->setMat3("normalMatrix", entry.normal);
+      shader->setVec3("objectColor", entry.color);
+      shader->setVec4("surfaceTransform", entry.surface);
+      glDrawElementsBaseVertex(
+          GL_TRIANGLES, stitchCounts[entry.stitch], GL_UNSIGNED_INT,
+          reinterpret_cast<void *>(stitchOffsets[entry.stitch] * sizeof(unsigned int)),
+          entry.slot * TERRAIN_CHUNK_VERTICES);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+  }
+  dispatch();
+  surfaces.dispatch();
+}
+
+void TerrainRenderer::dispatch() {
+  // Coarse chunks first: each stands in for everything below it
+  batch.dispatch(
+      [](const Request &entry) { return TerrainChunkId::unpack(entry.key.item).level; },
+      [](const Request &) { return std::size_t{1}; }, TERRAIN_BATCH_CHUNKS,
+      [](const Request &entry, TerrainChunkData &data) {
+        buildTerrainChunk(entry.settings, TerrainChunkId::unpack(entry.key.item), data);
+      });
+}
+
+void TerrainRenderer::upload(const Request &request, const TerrainChunkData &data) {
+  if (pool.contains(request.key)) {
+    return;
+  }
+  const int index = pool.acquire(request.key);
+  if (index < 0) {
+    return;
+  }
+
+  Slot &slot = slots[static_cast<std::size_t>(index)];
+  slot.center = data.center;
+  slot.boundingRadius = data.boundingRadius;
+
+  constexpr auto chunkBytes =
+      static_cast<GLsizeiptr>(TERRAIN_CHUNK_VERTICES * TERRAIN_VERTEX_FLOATS * sizeof(float));
+  glBufferSubData(GL_ARRAY_BUFFER, index * chunkBytes, chunkBytes, data.vertices.data());
+}
+
+std::size_t TerrainRenderer::getTriangleCount() const {
+  std::size_t triangles = 0;
+  for (const Draw &entry : draws) {
+    triangles += static_cast<std::size_t>(stitchCounts[entry.stitch]) / 3;
+  }
+  return triangles;
+}
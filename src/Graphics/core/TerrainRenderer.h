@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "Culling.h"
+#include "SurfaceMap.h"
+#include "Terrain.h"
+#include "VirtualTexture.h"
+#include "core/background_batch.h"
+#include "core/page_pool.h"
+
+class CubeSphere;
+class GLStateCache;
+class Shader;
+
+// Level-of-detail terrain for CubeSphere bodies. Each cube face is a quadtree of fixed-size
+// chunks that are split until a chunk's cells project to fewer than the allowed number of
+// pixels, so detail follows the camera from orbit down to the surface at a bounded triangle
+// count. Neighbouring chunks never differ by more than one level, and a chunk next to a coarser
+// one draws that edge with every other vertex collapsed, so the surface has no cracks.
+//
+// Chunk geometry is generated on the thread pool and kept in a fixed pool of slots in one vertex
+// buffer; the least recently drawn chunks are evicted first. Until a chunk's children are
+// resident the chunk itself is drawn, so detail streams in without holes.
+//
+// Bodies with a surface map are colored from it through a virtual texture. Each chunk asks for
+// the map tile whose texels are about a pixel on screen, and chunks are split further where the
+// map has more detail than their level shows.
+class TerrainRenderer {
+public:
+  explicit TerrainRenderer(std::shared_ptr<Shader> shader);
+  ~TerrainRenderer();
+
+  TerrainRenderer(const TerrainRenderer &) = delete;
+  TerrainRenderer &operator=(const TerrainRenderer &) = delete;
+
+  // Uploads the chunks generated since the last frame and starts selecting for this one.
+  void begin(const glm::mat4 &view, const glm::mat4 &projection, float viewportHeight,
+             float maxPixelError, int maxLevel, GLStateCache &state);
+
+  // Selects the chunks covering one body. Returns false while its six root chunks are still
+  // being generated, so the caller can draw the plain mesh meanwhile.
+  bool add(const CubeSphere &planet);
+
+  // Draws the selected chunks and hands the chunks found missing to the background builder.
+  void draw(GLStateCache &state);
+
+  std::size_t getChunkCount() const { return draws.size(); }
+  std::size_t getTriangleCount() const;
+  std::size_t getResidentCount() const { return pool.getResidentCount(); }
+  std::size_t getPendingCount() const { return batch.getPendingCount(); }
+  const VirtualTexture &getSurfaces() const { return surfaces; }
+
+private:
+  struct Slot {
+    glm::dvec3 center{0.0};
+    double boundingRadius = 0.0;
+  };
+
+  // Chunks of every body share the pool, so they are keyed by terrain id and packed chunk id
+  struct Request {
+    PageKey key;
+    TerrainSettings settings;
+  };
+
+  struct Draw {
+    int slot = 0;
+    int stitch = 0; // bit per edge next to a coarser chunk: -v, +u, +v, -u
+    glm::mat4 model{1.0f};
+    glm::mat4 modelView{1.0f};
+    glm::mat3 normal{1.0f};
+    glm::vec3 color{1.0f};
+    glm::vec4 surface{0.0f}; // atlas offset and scale, zero without a surface map
+  };
+
+  // What one body's selection works from
+  struct Planet {
+    std::uint32_t id = 0;
+    TerrainSettings settings; // flat where only the surface map is drawn
+    std::shared_ptr<const SurfaceMap> surface;
+    glm::dmat4 model{1.0};
+    double scale = 1.0;   // largest axis of the model matrix
+    double horizon = 0.0; // chunks farther from the camera are behind the body
+  };
+
+  void buildIndices();
+  const Slot *find(const Planet &planet, TerrainChunkId id);
+  bool isResident(const Planet &planet, TerrainChunkId id) const;
+  bool hasResidentChildren(const Planet &planet, TerrainChunkId id) const;
+  void request(const Planet &planet, TerrainChunkId id);
+  bool isVisible(const Planet &planet, const Slot &slot) const;
+  double getDistance(const Planet &planet, const Slot &slot) const;
+  float getPixelError(const Planet &planet, const Slot &slot, int level) const;
+  int getTileLevel(const Planet &planet, const Slot &slot, int level) const;
+  void balance(const Planet &planet, std::unordered_map<std::uint64_t, bool> &leaves);
+  void dispatch();
+  void upload(const Request &request, const TerrainChunkData &data);
+
+  std::shared_ptr<Shader> shader;
+  unsigned int VAO{}, VBO{}, EBO{};
+  std::array<int, 16> stitchOffsets{};
+  std::array<int, 16> stitchCounts{};
+
+  // Pool of chunk slots; a slot's vertices start at slot * TERRAIN_CHUNK_VERTICES
+  PagePool pool;
+  std::vector<Slot> slots;
+
+  // This frame's camera
+  glm::dmat4 view{1.0};
+  glm::dvec3 cameraPosition{0.0};
+  Frustum frustum{};
+  float pixelScale = 1.0f;
+  float maxPixelError = 4.0f;
+  int maxLevel = 16;
+
+  // Chunks found missing this frame, generated in the background
+  BackgroundBatch<Request, TerrainChunkData> batch;
+
+  std::vector<Draw> draws;
+  VirtualTexture surfaces;
+};
@@ -0,0 +1,171 @@
+#include "TrailRenderer.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include "GLStateCache.h"
+#include "Graphics/shader.h"
+
+namespace {
+
+// Below this distance a body counts as stationary and is not sampled.
+constexpr float MIN_SAMPLE_SPACING = 1e-5F;
+
+} // namespace
+
+// Every body's ring is stored twice over, in 2 * capacity slots: sample s goes to slots
+// s % capacity and s % capacity + capacity. The newest n samples are then always contiguous,
+// ending at slot s % capacity + capacity, and each trail is a single line strip.
+
+TrailRenderer::TrailRenderer(std::shared_ptr<Shader> trailShader) : shader(std::move(trailShader)) {
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &VBO);
+
+  glBindVertexArray(VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void *)0);
+  glEnableVertexAttribArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindVertexArray(0);
+}
+
+TrailRenderer::~TrailRenderer() {
+  for (auto *fence : fences) {
+    if (fence != nullptr) {
+      glDeleteSync(static_cast<GLsync>(fence));
+    }
+  }
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteBuffers(1, &VBO);
+}
+
+void TrailRenderer::clear() { trails.clear(); }
+
+void TrailRenderer::reset(std::size_t bodyCount, std::size_t length, GLStateCache &state) {
+  trails.assign(bodyCount, Trail{});
+  capacity = length;
+
+  // Fresh storage; the driver keeps the old one alive for frames still reading it.
+  state.bindArrayBuffer(VBO);
+  glBufferData(GL_ARRAY_BUFFER, bodyCount * 2 * capacity * sizeof(glm::vec4), nullptr,
+               GL_DYNAMIC_DRAW);
+}
+
+void TrailRenderer::waitForFrame(int frame) {
+  auto *&fence = fences[frame];
+  if (fence == nullptr) {
+    return;
+  }
+  const auto sync = static_cast<GLsync>(fence);
+  while (glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {
+  }
+  glDeleteSync(sync);
+  fence = nullptr;
+}
+
+std::size_t TrailRenderer::visibleSamples(const Trail &trail) const {
+  // A body takes at most one sample per frame, so holding back FRAMES_IN_FLIGHT slots keeps
+  // every slot written this frame out of the strips the GPU may still be drawing.
+  return std::min(trail.sampleCount, capacity - FRAMES_IN_FLIGHT);
+}
+
+void TrailRenderer::update(const std::vector<glm::vec3> &positions, float time,
+                           const TrailStyle &style, GLStateCache &state) {
+  const auto length = static_cast<std::size_t>(std::max(style.length, FRAMES_IN_FLIGHT + 2));
+  if (positions.size() != trails.size() || length != capacity) {
+    reset(positions.size(), length, state);
+  }
+
+  // Pick the bodies whose path has turned far enough, or moved far enough, since their last
+  // sample.
+  const float cosSampleAngle = std::cos(glm::radians(style.sampleAngle));
+  pending.clear();
+  for (std::size_t i = 0; i < trails.size(); ++i) {
+    Trail &trail = trails[i];
+    const glm::vec3 step = positions[i] - trail.lastSample;
+    const float distance = glm::length(step);
+    if (trail.sampleCount > 0 && distance < MIN_SAMPLE_SPACING) {
+      continue;
+    }
+    const glm::vec3 direction = trail.sampleCount > 0 ? step / distance : glm::vec3(0.0F);
+    const bool turned = trail.sampleCount > 1 && glm::dot(direction, trail.lastDirection) <
+                                                     cosSampleAngle;
+    if (trail.sampleCount > 1 && !turned && distance < style.maxSampleSpacing) {
+      continue;
+    }
+    trail.lastDirection = direction;
+    trail.lastSample = positions[i];
+    pending.push_back(i);
+  }
+
+  currentFrame = (currentFrame + 1) % FRAMES_IN_FLIGHT;
+  waitForFrame(currentFrame);
+  if (pending.empty()) {
+    return;
+  }
+  lastSampleTime = time;
+
+  // Map only the span of rings that changed, unsynchronized: the fence above and the slots
+  // held back in visibleSamples() keep these writes away from anything the GPU still reads.
+  const std::size_t ringBytes = 2 * capacity * sizeof(glm::vec4);
+  const std::size_t spanBegin = pending.front() * ringBytes;
+  const std::size_t spanEnd = (pending.back() + 1) * ringBytes;
+  state.bindArrayBuffer(VBO);
+  auto *mapped = static_cast<unsigned char *>(
+      glMapBufferRange(GL_ARRAY_BUFFER, spanBegin, spanEnd - spanBegin,
+                       GL_MAP_WRITE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+  if (mapped == nullptr) {
+    return;
+  }
+
+  for (const std::size_t i : pending) {
+    Trail &trail = trails[i];
+    const glm::vec4 sample(trail.lastSample, time);
+    const std::size_t slot = trail.sampleCount % capacity;
+    for (const std::size_t copy : {slot, slot + capacity}) {
+      const std::size_t offset = i * ringBytes + copy * sizeof(glm::vec4) - spanBegin;
+      *reinterpret_cast<glm::vec4 *>(mapped + offset) = sample;
+      glFlushMappedBufferRange(GL_ARRAY_BUFFER, offset, sizeof(glm::vec4));
+    }
+    ++trail.sampleCount;
+  }
+
+  glUnmapBuffer(GL_ARRAY_BUFFER);
+}
+
+void TrailRenderer::draw(float time, const TrailStyle &style, GLStateCache &state) {
+  firsts.clear();
+  counts.clear();
+  for (std::size_t i = 0; i < trails.size(); ++i) {
+    const std::size_t samples = visibleSamples(trails[i]);
+    if (samples < 2) {
+      continue;
+    }
+    const std::size_t newest = (trails[i].sampleCount - 1) % capacity + capacity;
+    firsts.push_back(static_cast<int>(i * 2 * capacity + newest + 1 - samples));
+    counts.push_back(static_cast<int>(samples));
+  }
+
+  if (!firsts.empty()) {
+    state.useProgram(shader->getID());
+    shader->setFloat("time", time);
+    shader->setFloat("fadeTime", style.fadeTime);
+    shader->setVec3("trailColor", style.color);
+
+    state.setBlend(true);
+    state.setWireframe(false);
+    state.bindVertexArray(VAO);
+    glMultiDrawArrays(GL_LINE_STRIP, firsts.data(), counts.data(),
+                      static_cast<GLsizei>(firsts.size()));
+  }
+
+  fences[currentFrame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+std::size_t TrailRenderer::getVertexCount() const {
+  std::size_t total = 0;
+  for (const int count : counts) {
+    total += count;
+  }
+  return total;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <limits>
+#include <memory>
+#include <vector>
+
+class GLStateCache;
+class Shader;
+
+struct TrailStyle {
+  int length = 128;               // samples kept per body
+  float sampleAngle = 2.0f;       // degrees of turn between samples
+  float maxSampleSpacing = 0.5f;  // scene units; also bounds the gap to the body
+  float fadeTime = 20.0f;         // seconds until a sample is fully transparent
+  glm::vec3 color{0.6f, 0.8f, 1.0f};
+
+  bool operator==(const TrailStyle &) const = default;
+};
+
+// Orbit trails for up to a few tens of thousands of bodies. Each body owns a fixed ring of
+// past positions, sampled when its path has turned by `sampleAngle` rather than every frame,
+// so straight stretches cost few samples and tight periapsis passes get many. All rings share
+// one vertex buffer and are drawn as line strips with a single glMultiDrawArrays. Each frame
+// writes only the samples that were just taken.
+class TrailRenderer {
+public:
+  explicit TrailRenderer(std::shared_ptr<Shader> shader);
+  ~TrailRenderer();
+
+  TrailRenderer(const TrailRenderer &) = delete;
+  TrailRenderer &operator=(const TrailRenderer &) = delete;
+
+  // Samples body i at positions[i]; a change in body count or trail length restarts all trails.
+  void update(const std::vector<glm::vec3> &positions, float time, const TrailStyle &style,
+              GLStateCache &state);
+  void draw(float time, const TrailStyle &style, GLStateCache &state);
+  void clear();
+
+  std::size_t getVertexCount() const;
+  std::size_t size() const { return trails.size(); }
+  // Whether the newest samples are still fading, so the trails change with time alone
+  bool isFading(float time, const TrailStyle &style) const {
+    return time - lastSampleTime < style.fadeTime;
+  }
+
+private:
+  struct Trail {
+    glm::vec3 lastSample{0.0f};
+    glm::vec3 lastDirection{0.0f};
+    std::size_t sampleCount = 0; // total samples taken; the newest is sampleCount - 1
+  };
+
+  // Slots reused while an earlier frame may still be drawing; strips stop short of them.
+  static constexpr int FRAMES_IN_FLIGHT = 3;
+
+  void reset(std::size_t bodyCount, std::size_t length, GLStateCache &state);
+  void waitForFrame(int frame);
+  std::size_t visibleSamples(const Trail &trail) const;
+
+  std::shared_ptr<Shader> shader;
+  unsigned int VAO{}, VBO{};
+  std::array<void *, FRAMES_IN_FLIGHT> fences{}; // GLsync handles
+  int currentFrame = 0;
+
+  std::size_t capacity = 0; // ring length per body
+  std::vector<Trail> trails;
+  std::vector<std::size_t> pending; // bodies sampled this frame
+  float lastSampleTime = -std::numeric_limits<float>::infinity();
+  std::vector<int> firsts;
+  std::vector<int> counts;
+};
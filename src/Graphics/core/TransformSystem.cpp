@@ -0,0 +1,122 @@
+#include "TransformSystem.h"
+#include "core/thread_pool.h"
+
+namespace {
+
+// Dirty blocks per parallel chunk; scenes below this are transformed on the calling thread.
+constexpr std::size_t TRANSFORM_GRAIN = 256;
+
+float safeReciprocal(float value) { return value != 0.0F ? 1.0F / value : 0.0F; }
+
+} // namespace
+
+void TransformSystem::resize(std::size_t newCount) {
+  count = newCount;
+  const std::size_t blocks = (count + TRANSFORM_LANES - 1) / TRANSFORM_LANES;
+  const std::size_t padded = blocks * TRANSFORM_LANES;
+
+  // Padding lanes hold an identity transform so the sweep never needs a remainder loop.
+  for (auto *component : {&px, &py, &pz, &qx, &qy, &qz}) {
+    component->resize(padded, 0.0F);
+  }
+  for (auto *component : {&qw, &sx, &sy, &sz}) {
+    component->resize(padded, 1.0F);
+  }
+  dirty.assign(blocks, 1);
+  models.resize(padded);
+  normals.resize(padded);
+}
+
+void TransformSystem::set(std::size_t i, const glm::vec3 &position, const glm::quat &rotation,
+                          const glm::vec3 &scale) {
+  if (px[i] == position.x && py[i] == position.y && pz[i] == position.z && qx[i] == rotation.x &&
+      qy[i] == rotation.y && qz[i] == rotation.z && qw[i] == rotation.w && sx[i] == scale.x &&
+      sy[i] == scale.y && sz[i] == scale.z) {
+    return;
+  }
+  px[i] = position.x;
+  py[i] = position.y;
+  pz[i] = position.z;
+  qx[i] = rotation.x;
+  qy[i] = rotation.y;
+  qz[i] = rotation.z;
+  qw[i] = rotation.w;
+  sx[i] = scale.x;
+  sy[i] = scale.y;
+  sz[i] = scale.z;
+  dirty[i / TRANSFORM_LANES] = 1;
+}
+
+std::size_t TransformSystem::update(ThreadPool &pool) {
+  dirtyBlocks.clear();
+  for (std::size_t block = 0; block < dirty.size(); ++block) {
+    if (dirty[block] != 0) {
+      dirtyBlocks.push_back(block);
+      dirty[block] = 0;
+    }
+  }
+
+  pool.parallelFor(dirtyBlocks.size(), TRANSFORM_GRAIN, [this](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      updateBlock(dirtyBlocks[i]);
+    }
+  });
+  return dirtyBlocks.size();
+}
+
+void TransformSystem::updateBlock(std::size_t block) {
+  const std::size_t first = block * TRANSFORM_LANES;
+
+  // Rotation matrix from the unit quaternion, then scaled columns for the model matrix and
+  // inversely scaled ones for the normal matrix: (R S)^-T = R S^-1 since R is orthonormal.
+  float r[9][TRANSFORM_LANES];
+  float scale[3][TRANSFORM_LANES];
+  float inverseScale[3][TRANSFORM_LANES];
+  for (std::size_t lane = 0; lane < TRANSFORM_LANES; ++lane) {
+    const std::size_t i = first + lane;
+    const float x = qx[i], y = qy[i], z = qz[i], w = qw[i];
+    const float xx = x * x, yy = y * y, zz = z * z;
+    const float xy = x * y, xz = x * z, yz = y * z;
+    const float wx = w * x, wy = w * y, wz = w * z;
+
+    r[0][lane] = 1.0F - (2.0F * (yy + zz));
+    r[1][lane] = 2.0F * (xy + wz);
+    r[2][lane] = 2.0F * (xz - wy);
+    r[3][lane] = 2.0F * (xy - wz);
+    r[4][lane] = 1.0F - (2.0F * (xx + zz));
+    r[5][lane] = 2.0F * (yz + wx);
+    r[6][lane] = 2.0F * (xz + wy);
+    r[7][lane] = 2.0F * (yz - wx);
+    r[8][lane] = 1.0F - (2.0F * (xx + yy));
+
+    scale[0][lane] = sx[i];
+    scale[1][lane] = sy[i];
+    scale[2][lane] = sz[i];
+    inverseScale[0][lane] = safeReciprocal(sx[i]);
+    inverseScale[1][lane] = safeReciprocal(sy[i]);
+    inverseScale[2][lane] = safeReciprocal(sz[i]);
+  }
+
+  for (std::size_t lane = 0; lane < TRANSFORM_LANES; ++lane) {
+    const std::size_t i = first + lane;
+    glm::mat4 &model = models[i];
+    NormalMatrix &normal = normals[i];
+    for (int column = 0; column < 3; ++column) {
+      const glm::vec3 axis(r[3 * column][lane], r[(3 * column) + 1][lane],
+                           r[(3 * column) + 2][lane]);
+      model[column] = glm::vec4(axis * scale[column][lane], 0.0F);
+      normal.columns[column] = glm::vec4(axis * inverseScale[column][lane], 0.0F);
+    }
+    model[3] = glm::vec4(px[i], py[i], pz[i], 1.0F);
+  }
+}
+
+void TransformSystem::compose(const glm::vec3 &position, const glm::quat &rotation,
+                              const glm::vec3 &scale, glm::mat4 &model, NormalMatrix &normal) {
+  const glm::mat3 r = glm::mat3_cast(rotation);
+  for (int column = 0; column < 3; ++column) {
+    model[column] = glm::vec4(r[column] * scale[column], 0.0F);
+    normal.columns[column] = glm::vec4(r[column] * safeReciprocal(scale[column]), 0.0F);
+  }
+  model[3] = glm::vec4(position, 1.0F);
+}
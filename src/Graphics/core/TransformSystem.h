@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+#include "RenderQueue.h"
+
+class ThreadPool;
+
+// Number of bodies transformed side by side; each one occupies a lane, so the inner loops of
+// the update sweep map directly onto SIMD registers.
+constexpr std::size_t TRANSFORM_LANES = 8;
+
+// Model and normal matrices for every scene object. Positions, rotations and scales are kept
+// structure-of-arrays. set() marks a body dirty only when one of them actually changes, and
+// update() recomputes the matrices of dirty blocks of TRANSFORM_LANES bodies, skipping blocks
+// that are entirely static.
+class TransformSystem {
+public:
+  // Resizing marks every body dirty.
+  void resize(std::size_t count);
+  std::size_t size() const { return count; }
+
+  void set(std::size_t i, const glm::vec3 &position, const glm::quat &rotation,
+           const glm::vec3 &scale);
+
+  // Recomputes the dirty bodies' matrices and returns how many blocks were swept.
+  std::size_t update(ThreadPool &pool);
+
+  const glm::mat4 &getModel(std::size_t i) const { return models[i]; }
+  const NormalMatrix &getNormal(std::size_t i) const { return normals[i]; }
+
+  // Single-body version of the sweep, for callers outside the batch.
+  static void compose(const glm::vec3 &position, const glm::quat &rotation,
+                      const glm::vec3 &scale, glm::mat4 &model, NormalMatrix &normal);
+
+private:
+  void updateBlock(std::size_t block);
+
+  std::size_t count = 0;
+  std::vector<float> px, py, pz;
+  std::vector<float> qx, qy, qz, qw;
+  std::vector<float> sx, sy, sz;
+  std::vector<std::uint8_t> dirty; // one flag per block
+  std::vector<glm::mat4> models;
+  std::vector<NormalMatrix> normals;
+  std::vector<std::size_t> dirtyBlocks;
+};
@@ -0,0 +1,115 @@
+#include "VirtualTexture.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr int VIRTUAL_TEXTURE_PAGE_COUNT = VIRTUAL_TEXTURE_PAGES * VIRTUAL_TEXTURE_PAGES;
+
+// Tiles read per background batch, about 1 MB
+constexpr std::size_t VIRTUAL_TEXTURE_BATCH_TILES = 16;
+
+} // namespace
+
+VirtualTexture::VirtualTexture() : pages(VIRTUAL_TEXTURE_PAGE_COUNT) {
+  // Tiles carry their own border, so plain bilinear filtering stays inside a page
+  glGenTextures(1, &atlas);
+  glBindTexture(GL_TEXTURE_2D, atlas);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, VIRTUAL_TEXTURE_TEXELS, VIRTUAL_TEXTURE_TEXELS, 0,
+               GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+VirtualTexture::~VirtualTexture() { glDeleteTextures(1, &atlas); }
+
+void VirtualTexture::begin() {
+  pages.beginFrame();
+  batch.clearRequests();
+
+  glBindTexture(GL_TEXTURE_2D, atlas);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  batch.collect([this](const Request &request, const std::vector<std::uint8_t> &texels) {
+    upload(request, texels);
+  });
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+bool VirtualTexture::lookup(const std::shared_ptr<const SurfaceMap> &map,
+                            const TerrainChunkId &chunk, int level, glm::vec4 &transform) {
+  // The tile wanted is the chunk's ancestor at `level`, or at the map's deepest level
+  const int wantedLevel = std::clamp(std::min(level, chunk.level), 0, map->getLevels() - 1);
+  const int wantedDepth = chunk.level - wantedLevel;
+  const TerrainChunkId wanted{chunk.face, wantedLevel, chunk.x >> wantedDepth,
+                              chunk.y >> wantedDepth};
+  if (map->getTile(wanted) != nullptr) {
+    request(map, wanted);
+  }
+
+  for (TerrainChunkId tile = wanted;; tile = tile.parent()) {
+    const int page = pages.find({map->getId(), tile.pack()});
+    if (page >= 0) {
+      // The chunk covers 2^-depth of the tile, at its cell within it
+      const int depth = chunk.level - tile.level;
+      const std::uint32_t mask = (std::uint32_t{1} << depth) - 1;
+      const double span = std::ldexp(1.0, -depth);
+      const glm::dvec2 cell(static_cast<double>(chunk.x & mask),
+                            static_cast<double>(chunk.y & mask));
+      const glm::dvec2 origin(((page % VIRTUAL_TEXTURE_PAGES) * SURFACE_TILE_STORED) +
+                                  SURFACE_TILE_BORDER,
+                              ((page / VIRTUAL_TEXTURE_PAGES) * SURFACE_TILE_STORED) +
+                                  SURFACE_TILE_BORDER);
+      const double scale = span * SURFACE_TILE_TEXELS / VIRTUAL_TEXTURE_TEXELS;
+      const glm::dvec2 offset = (origin / static_cast<double>(VIRTUAL_TEXTURE_TEXELS)) +
+                                (cell * scale);
+      transform = glm::vec4(offset.x, offset.y, scale, scale);
+      return true;
+    }
+    if (tile.level == 0) {
+      return false;
+    }
+    // Ancestors are streamed too, so a stand-in arrives before the tile itself
+    if (map->getTile(tile.parent()) != nullptr) {
+      request(map, tile.parent());
+    }
+  }
+}
+
+void VirtualTexture::request(const std::shared_ptr<const SurfaceMap> &map,
+                             const TerrainChunkId &tile) {
+  const PageKey key{map->getId(), tile.pack()};
+  if (!pages.contains(key)) {
+    batch.request({key, map}, [&key](const Request &entry) { return entry.key == key; });
+  }
+}
+
+void VirtualTexture::dispatch() {
+  // Coarse tiles first, as with terrain chunks. Copying out of the mapping is where the file
+  // is actually read, so it happens on the batch.
+  batch.dispatch(
+      [](const Request &entry) { return TerrainChunkId::unpack(entry.key.item).level; },
+      [](const Request &) { return std::size_t{1}; }, VIRTUAL_TEXTURE_BATCH_TILES,
+      [](const Request &entry, std::vector<std::uint8_t> &texels) {
+        const std::uint8_t *tile = entry.map->getTile(TerrainChunkId::unpack(entry.key.item));
+        texels.assign(tile, tile + SURFACE_TILE_BYTES);
+      });
+}
+
+void VirtualTexture::upload(const Request &request, const std::vector<std::uint8_t> &texels) {
+  if (pages.contains(request.key)) {
+    return;
+  }
+  const bool root = TerrainChunkId::unpack(request.key.item).level == 0;
+  const int index = pages.acquire(request.key, root);
+  if (index < 0) {
+    return;
+  }
+
+  glTexSubImage2D(GL_TEXTURE_2D, 0, (index % VIRTUAL_TEXTURE_PAGES) * SURFACE_TILE_STORED,
+                  (index / VIRTUAL_TEXTURE_PAGES) * SURFACE_TILE_STORED, SURFACE_TILE_STORED,
+                  SURFACE_TILE_STORED, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+}
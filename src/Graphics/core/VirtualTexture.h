@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include "SurfaceMap.h"
+#include "Terrain.h"
+#include "core/background_batch.h"
+#include "core/page_pool.h"
+
+// Pages along each edge of the atlas. The atlas holds 256 tiles (17 MB) whatever the size of the
+// maps being drawn.
+constexpr int VIRTUAL_TEXTURE_PAGES = 16;
+constexpr int VIRTUAL_TEXTURE_TEXELS = VIRTUAL_TEXTURE_PAGES * SURFACE_TILE_STORED;
+
+// Streams the tiles of surface maps into one fixed-size atlas texture. The renderer asks for the
+// tile each terrain chunk wants; resident tiles are found through a page table, missing ones are
+// read from the mapped file on a background batch, and meanwhile the chunk is drawn from the
+// finest tile above it that is resident. Pages are recycled least recently used first, and the
+// root tiles of a map only once nothing else is left, so a chunk always has something to draw.
+class VirtualTexture {
+public:
+  VirtualTexture();
+  ~VirtualTexture();
+
+  VirtualTexture(const VirtualTexture &) = delete;
+  VirtualTexture &operator=(const VirtualTexture &) = delete;
+
+  // Copies the tiles read since the last frame into the atlas.
+  void begin();
+
+  // Where `chunk` finds its texels in the atlas, as an offset (xy) and scale (zw) from the
+  // chunk's [0, 1] coordinates. `level` is the tile level wanted for it, at most the chunk's
+  // own. False until the map's root tile for the chunk's face is resident.
+  bool lookup(const std::shared_ptr<const SurfaceMap> &map, const TerrainChunkId &chunk, int level,
+              glm::vec4 &transform);
+
+  // Hands the tiles found missing this frame to the background loader.
+  void dispatch();
+
+  unsigned int getTexture() const { return atlas; }
+  std::size_t getResidentCount() const { return pages.getResidentCount(); }
+  std::size_t getPendingCount() const { return batch.getPendingCount(); }
+
+private:
+  // Keyed by map id and packed tile id. The map is held until its tile is loaded, even if the
+  // body drops it meanwhile.
+  struct Request {
+    PageKey key;
+    std::shared_ptr<const SurfaceMap> map;
+  };
+
+  void request(const std::shared_ptr<const SurfaceMap> &map, const TerrainChunkId &tile);
+  void upload(const Request &request, const std::vector<std::uint8_t> &texels);
+
+  unsigned int atlas{};
+
+  // Page table: tile -> page. A map's root tiles are pinned, so they are evicted last.
+  PagePool pages;
+
+  // Tiles found missing this frame, read in the background
+  BackgroundBatch<Request, std::vector<std::uint8_t>> batch;
+};
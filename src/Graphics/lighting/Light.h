@@ -19,6 +19,7 @@ public:
     float getDiffuseStrength() const { return diffuseStrength; }
     float getSpecularStrength() const { return specularStrength; }
     float getShininess() const { return shininess; }
+    float getRange() const { return range; }
 
     // Setters
     void setPosition(const glm::vec3& pos) { position = pos; }
@@ -28,6 +29,7 @@ public:
     void setDiffuseStrength(float strength) { diffuseStrength = strength; }
     void setSpecularStrength(float strength) { specularStrength = strength; }
     void setShininess(float shine) { shininess = shine; }
+    void setRange(float r) { range = r; }
 
 private:
     std::string name;
@@ -38,4 +40,5 @@ private:
     float diffuseStrength = 0.7f;
     float specularStrength = 0.5f;
     float shininess = 32.0f;
+    float range = 0.0f;  // distance at which the light has faded out; 0 reaches everywhere
 };
@@ -1,12 +1,75 @@
 #include "renderer.h"
 #include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 #include <glm/gtc/matrix_transform.hpp>
+#include <limits>
+#include <stdexcept>
 #include <vector>
 #include "GUI/gui.h"
+#include "Graphics/core/ImpostorRenderer.h"
+#include "Graphics/core/PathRenderer.h"
 #include "Graphics/core/RenderVisitor.h"
+#include "Graphics/bodies/cubeSphere.h"
+#include "Graphics/uniformBuffer.h"
+#include "Simulation/Kepler.h"
+#include "core/thread_pool.h"
 
 #include "GUI/Scene.h"
 
+// Not in the GL 4.1 headers; glClipControl is core in 4.5 and ARB_clip_control before that
+#ifndef GL_ZERO_TO_ONE
+#define GL_ZERO_TO_ONE 0x935F
+#endif
+
+namespace {
+
+// The projection has no far plane. Ranged lights are clustered out to CLUSTER_FAR, and the
+// logarithmic depth fallback spans NEAR_PLANE to LOG_DEPTH_FAR.
+constexpr float NEAR_PLANE = 0.1f;
+constexpr float CLUSTER_FAR = 1.0e4f;
+constexpr float LOG_DEPTH_FAR = 1.0e20f;
+
+// Inserted into every shader when glClipControl is missing. Reversed logarithmic depth: 1 at
+// the near plane and falling with the log of the distance, so precision is relative at every
+// scale. range is the Camera block's depthRange, declared after this.
+constexpr const char *LOG_DEPTH_PREAMBLE =
+    "#define LOG_DEPTH\n"
+    "float getLogDepth(float distance, vec4 range) {\n"
+    "    return clamp(1.0 - log(distance / range.x) * range.y, 0.0, 1.0);\n"
+    "}\n";
+
+using ClipControlProc = void (*)(GLenum origin, GLenum depth);
+
+// Reversed-Z perspective with the far plane at infinity: clip z is the near distance, so
+// depth is near / distance, 1 at the near plane and falling toward 0 far away. Floating-point
+// depth is densest near 0, which cancels the 1 / distance falloff.
+glm::mat4 reversedInfinitePerspective(float fovy, float aspect, float zNear) {
+  const float focal = 1.0f / std::tan(fovy * 0.5f);
+  glm::mat4 result(0.0f);
+  result[0][0] = focal / aspect;
+  result[1][1] = focal;
+  result[2][3] = -1.0f;
+  result[3][2] = zNear;
+  return result;
+}
+
+bool hasExtension(const char *name) {
+  GLint count = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+  for (GLint i = 0; i < count; ++i) {
+    const auto *extension = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, i));
+    if (extension != nullptr && std::strcmp(extension, name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
 Renderer::Renderer(Window &window) : window(window) {
   init();
 
@@ -24,11 +87,36 @@ Renderer::Renderer(Window &window) : window(window) {
 Renderer::~Renderer() {
   if (gridVAO != 0) {
     glDeleteVertexArrays(1, &gridVAO);
-    glDeleteBuffers(1, &gridVBO);
   }
 }
 
+void Renderer::initDepth() {
+  // With clip control, window depth is clip z / w as is and reversed-Z needs nothing else.
+  // Without it (macOS stops at GL 4.1), depth would be remapped to [0.5, 1] and lose most of its
+  // precision, so the shaders write logarithmic depth instead.
+  clipControl = false;
+  if (hasExtension("GL_ARB_clip_control")) {
+    const auto clipControlProc =
+        reinterpret_cast<ClipControlProc>(SDL_GL_GetProcAddress("glClipControl"));
+    if (clipControlProc != nullptr) {
+      clipControlProc(GL_LOWER_LEFT, GL_ZERO_TO_ONE);
+      clipControl = true;
+    }
+  }
+  Shader::setPreamble(clipControl ? "" : LOG_DEPTH_PREAMBLE);
+
+  // Nearer is larger, so depth clears to 0
+  glDepthFunc(GL_GREATER);
+  glClearDepth(0.0);
+}
+
 void Renderer::init() {
+  initDepth();
+  cameraBlock = std::make_unique<UniformBuffer>(CAMERA_BLOCK_BINDING, sizeof(CameraBlock));
+  lightsBlock = std::make_unique<UniformBuffer>(LIGHTS_BLOCK_BINDING, sizeof(LightsBlock));
+  gridBlock = std::make_unique<UniformBuffer>(GRID_BLOCK_BINDING, sizeof(GridBlock));
+  resolution = std::make_unique<ResolutionScaler>();
+
   // Create shaders
   const auto sphereShader = std::make_shared<Shader>(
       "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/sphere.vert",
@@ -43,66 +131,52 @@ void Renderer::init() {
   registerShader("Sphere", sphereShader);
   registerShader("CubeSphere", cubeSphereShader);
 
-  // Initialize grid
-  gridShader = std::make_unique<Shader>(
-      "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/grid.vert",
-      "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/grid.frag");
-  initGrid();
-}
-
-void Renderer::initGrid() {
-  // Delete existing grid buffers if they exist
-  if (gridVAO != 0) {
-    glDeleteVertexArrays(1, &gridVAO);
-    glDeleteBuffers(1, &gridVBO);
-  }
-
-  std::vector<float> vertices;
-  float halfSize = settings.gridSize * 0.5f;
-  float step = settings.gridSize / static_cast<float>(settings.gridDivisions);
+  impostors = std::make_unique<ImpostorRenderer>(std::make_shared<Shader>(
+      "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/impostor.vert",
+      "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/impostor.frag"));
 
-  // Create grid lines along X axis
-  for (int i = 0; i <= settings.gridDivisions; ++i) {
-    float x = -halfSize + (i * step);
-    vertices.push_back(x);
-    vertices.push_back(0.0F);
-    vertices.push_back(-halfSize);
+  terrain = std::make_unique<TerrainRenderer>(std::make_shared<Shader>(
+      "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/terrain.vert",
+      "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/terrain.frag"));
 
-    vertices.push_back(x);
-    vertices.push_back(0.0F);
-    vertices.push_back(halfSize);
+  // The default catalog is optional; without it the sky stays empty until one is loaded
+  stars = std::make_unique<StarRenderer>(std::make_shared<Shader>(
+      "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/star.vert",
+      "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/star.frag"));
+  try {
+    stars->setCatalog(std::make_shared<const StarCatalog>(
+        "/Users/redshifted/code/OrbitalSimulation/assets/stars.orbstar"));
+  } catch (const std::runtime_error &) {
   }
 
-  // Create grid lines along Z axis
-  for (int i = 0; i <= settings.gridDivisions; ++i) {
-    float z = -halfSize + i * step;
-    vertices.push_back(-halfSize);
-    vertices.push_back(0.0f);
-    vertices.push_back(z);
-
-    vertices.push_back(halfSize);
-    vertices.push_back(0.0f);
-    vertices.push_back(z);
-  }
+  particles = std::make_unique<ParticleRenderer>(std::make_shared<Shader>(
+      "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/particle.vert",
+      "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/particle.frag"));
 
-  glGenVertexArrays(1, &gridVAO);
-  glGenBuffers(1, &gridVBO);
+  trails = std::make_unique<TrailRenderer>(std::make_shared<Shader>(
+      "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/trail.vert",
+      "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/trail.frag"));
 
-  glBindVertexArray(gridVAO);
-  glBindBuffer(GL_ARRAY_BUFFER, gridVBO);
-  glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+  paths = std::make_unique<PathRenderer>(std::make_shared<Shader>(
+      "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/path.vert",
+      "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/path.frag"));
 
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
-  glEnableVertexAttribArray(0);
-
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  glBindVertexArray(0);
+  // Initialize grid
+  gridShader = std::make_unique<Shader>(
+      "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/grid.vert",
+      "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/grid.frag");
+  if (gridVAO == 0) {
+    glGenVertexArrays(1, &gridVAO);
+  }
+  wells = std::make_unique<GravityWellRenderer>(std::make_shared<Shader>(
+      "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/well.vert",
+      "/Users/redshifted/code/OrbitalSimulation/src/Graphics/shaders/well.frag"));
 }
 
 void Renderer::updateProjection() {
-  float aspectRatio = static_cast<float>(window.getWidth()) / window.getHeight();
+  float aspectRatio = static_cast<float>(window.getWidth()) / std::max(window.getHeight(), 1);
   projectionMatrix =
-      glm::perspective(glm::radians(settings.fieldOfView), aspectRatio, 0.1f, 100.0f);
+      reversedInfinitePerspective(glm::radians(settings.fieldOfView), aspectRatio, NEAR_PLANE);
   viewMatrix =
       glm::lookAt(settings.cameraPosition, settings.cameraTarget, glm::vec3(0.0f, 1.0f, 0.0f));
 
@@ -111,6 +185,23 @@ void Renderer::updateProjection() {
   }
 }
 
+void Renderer::uploadFrameBlocks() {
+  CameraBlock camera{};
+  camera.view = viewMatrix;
+  camera.projection = projectionMatrix;
+  camera.viewPosition = glm::vec4(glm::vec3(glm::inverse(viewMatrix)[3]), 1.0f);
+  camera.depthRange =
+      glm::vec4(NEAR_PLANE, 1.0f / std::log(LOG_DEPTH_FAR / NEAR_PLANE), 0.0f, 0.0f);
+  cameraBlock->update(camera);
+
+  // Fragments find their cluster from gl_FragCoord, which counts pixels of the scene target
+  LightsBlock block{};
+  lightClusters.update(lights, viewMatrix, projectionMatrix, NEAR_PLANE, CLUSTER_FAR,
+                       glm::vec2(sceneTarget.getWidth(), sceneTarget.getHeight()),
+                       getThreadPool(), block);
+  lightsBlock->update(block);
+}
+
 void Renderer::registerShader(const std::string &objectType,
                               const std::shared_ptr<Shader> &shader) const {
   if (renderVisitor) {
@@ -118,61 +209,285 @@ void Renderer::registerShader(const std::string &objectType,
   }
 }
 
-void Renderer::renderGrid() const {
+void Renderer::renderStars() {
+  if (!settings.showStars) {
+    return;
+  }
+  // Star sizes are window pixels; the scene target may have fewer
+  StarStyle style = settings.starStyle;
+  style.maxPointSize *= resolution->getScale();
+  stars->draw(viewMatrix, projectionMatrix, static_cast<float>(sceneTarget.getHeight()), style,
+              stateCache);
+}
+
+void Renderer::renderGrid(const gui::Scene &scene) {
   if (!settings.showGrid) return;
 
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-  gridShader->use();
-  gridShader->setMat4("projection", projectionMatrix);
-  gridShader->setMat4("view", viewMatrix);
-  gridShader->setMat4("model", glm::mat4(1.0f));
-  
-  // Set all grid uniforms
-  gridShader->setVec3("gridColor", settings.gridColor);
-  gridShader->setVec3("majorGridColor", settings.majorGridColor);
-  gridShader->setFloat("fadeDistance", settings.gridFadeDistance);
-  gridShader->setFloat("gridSize", settings.gridSize);
-  gridShader->setInt("gridDivisions", settings.gridDivisions);
-  gridShader->setFloat("majorGridSpacing", settings.majorGridSpacing);
-  gridShader->setFloat("minorLineWidth", settings.minorLineWidth);
-  gridShader->setFloat("majorLineWidth", settings.majorLineWidth);
-  gridShader->setFloat("gridOpacity", settings.gridOpacity);
-  gridShader->setBool("showAxisLines", settings.showAxisLines);
-  gridShader->setVec3("xAxisColor", settings.xAxisColor);
-  gridShader->setVec3("zAxisColor", settings.zAxisColor);
-
-  glBindVertexArray(gridVAO);
-  glDrawArrays(GL_LINES, 0, (settings.gridDivisions + 1) * 4);
-  glBindVertexArray(0);
-
-  glDisable(GL_BLEND);
+  // Every grid setting goes through one block; the shader finds the plane per pixel, so the
+  // cost does not depend on how large or fine the grid is
+  GridBlock grid{};
+  grid.inverseViewProjection = glm::inverse(projectionMatrix * viewMatrix);
+  grid.minorColor = glm::vec4(settings.gridColor, settings.gridOpacity);
+  grid.majorColor = glm::vec4(settings.majorGridColor, settings.majorGridSpacing);
+  grid.xAxisColor = glm::vec4(settings.xAxisColor, settings.showAxisLines ? 1.0f : 0.0f);
+  grid.zAxisColor = glm::vec4(settings.zAxisColor, 1.0f);
+  grid.lines = glm::vec4(settings.gridCellSize, settings.gridFadeDistance,
+                         settings.minorLineWidth * resolution->getScale(),
+                         settings.majorLineWidth * resolution->getScale());
+  gridBlock->update(grid);
+
+  // The deformed grid is real geometry out to the fade distance, shaded like the flat one
+  if (settings.showGravityWells) {
+    wells->update(scene.getBodies(), scene.getRevision(), scene.getCentralMu(),
+                  settings.cameraPosition, settings.gridFadeDistance,
+                  settings.gravityWellStyle);
+    wells->draw(stateCache);
+    return;
+  }
+
+  stateCache.setBlend(true);
+  stateCache.useProgram(gridShader->getID());
+  stateCache.bindVertexArray(gridVAO);
+  glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+bool Renderer::needsRender(const gui::Scene &scene) const {
+  int width = 0;
+  int height = 0;
+  SDL_GetWindowSizeInPixels(window.getSDLWindow(), &width, &height);
+  if (!sceneDrawn || !(settings == drawnSettings) || scene.getRevision() != drawnRevision ||
+      wireframeMode != drawnWireframe || width != drawnWidth || height != drawnHeight) {
+    return true;
+  }
+
+  // Work that lands over the next frames, or trails that fade with time alone
+  return predictor.isBusy() || terrain->getPendingCount() > 0 ||
+         terrain->getSurfaces().getPendingCount() > 0 ||
+         (settings.showStars && stars->getPendingCount() > 0) ||
+         (settings.showTrails && trails->isFading(elapsedSeconds(), settings.trailStyle)) ||
+         (isWellFieldSampled() && wells->isSampling());
+}
+
+void Renderer::present() {
+  int width = 0;
+  int height = 0;
+  SDL_GetWindowSizeInPixels(window.getSDLWindow(), &width, &height);
+  sceneTarget.present(width, height);
 }
 
 void Renderer::render(const gui::Scene &scene) {
+  // Drawable pixels, which differ from the window size on high-DPI displays
+  int width = 0;
+  int height = 0;
+  SDL_GetWindowSizeInPixels(window.getSDLWindow(), &width, &height);
+  const bool cameraChanged = !sceneDrawn || width != drawnWidth || height != drawnHeight ||
+                             settings.cameraPosition != drawnSettings.cameraPosition ||
+                             settings.cameraTarget != drawnSettings.cameraTarget ||
+                             settings.fieldOfView != drawnSettings.fieldOfView;
+  resolution->begin();
+  sceneTarget.bind(width, height, resolution->getScale());
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-  updateProjection();
-  renderGrid();
+  // ImGui and buffer uploads change GL state behind the cache's back
+  stateCache.invalidate();
+  stateCache.setWireframe(wireframeMode);
 
-  // Pass the lights to the RenderVisitor before rendering
-  renderVisitor->setLights(lights);
+  if (cameraChanged) {
+    updateProjection();
+  }
+  uploadFrameBlocks();
+  renderStars();
+  renderGrid(scene);
 
   // Render all objects in the scene
   renderScene(scene);
+  renderParticles(scene);
+  renderTrails(scene);
+  renderPredictions(scene);
+
+  // Leave a clean slate for the GUI pass, which draws straight into the default framebuffer
+  stateCache.bindVertexArray(0);
+  stateCache.setBlend(false);
+  stateCache.setWireframe(false);
+  sceneTarget.present(width, height);
+  resolution->end(settings.resolution);
+
+  sceneDrawn = true;
+  drawnSettings = settings;
+  drawnRevision = scene.getRevision();
+  drawnWireframe = wireframeMode;
+  drawnWidth = width;
+  drawnHeight = height;
 }
 
-void Renderer::renderScene(const gui::Scene &scene) const {
-  // Render each object in the scene using the visitor pattern
-  for (const auto &obj : scene.getObjects()) {
-    if (obj.object) {                     // Check if the Object3D pointer is valid
-      obj.object->accept(*renderVisitor); // Access the Object3D through the object member
+void Renderer::renderScene(const gui::Scene &scene) {
+  const auto &objects = scene.getObjects();
+
+  // Cull bounding spheres against the frustum in one batch and size them on screen
+  culling.clear();
+  for (const auto &obj : objects) {
+    if (obj.object) {
+      culling.add(obj.object->getPosition(), obj.object->getBoundingRadius());
+    } else {
+      culling.add(glm::vec3(0.0f), -std::numeric_limits<float>::infinity()); // never visible
+    }
+  }
+  culling.run(viewMatrix, projectionMatrix, static_cast<float>(sceneTarget.getHeight()),
+              getThreadPool());
+
+  // Model and normal matrices in one sweep; only objects that moved since last frame cost work
+  if (transforms.size() != objects.size()) {
+    transforms.resize(objects.size());
+  }
+  for (size_t i = 0; i < objects.size(); ++i) {
+    if (const auto &object = objects[i].object) {
+      transforms.set(i, object->getPosition(), object->getOrientation(),
+                     object->getScale() * object->getMeshScale());
+    }
+  }
+  transformBlocksUpdated = transforms.update(getThreadPool());
+
+  // Record a draw packet for each visible object at a detail level matching its screen size,
+  // then sort and submit them. The smallest bodies become impostors instead, and bodies with
+  // terrain or a surface map draw their own chunks once those are generated.
+  renderVisitor->begin();
+  impostors->clear();
+  terrain->begin(viewMatrix, projectionMatrix, static_cast<float>(sceneTarget.getHeight()),
+                 settings.terrainPixelError, settings.terrainMaxLevel, stateCache);
+  for (size_t i = 0; i < objects.size(); ++i) {
+    if (!culling.isVisible(i)) {
+      continue;
+    }
+    const auto &object = objects[i].object;
+    const float pixelRadius = culling.getPixelRadius(i);
+    if (settings.useImpostors && pixelRadius < settings.impostorPixelRadius) {
+      impostors->add(object->getPosition(), object->getBoundingRadius(), object->getColor());
+      continue;
+    }
+    const auto *planet = dynamic_cast<const CubeSphere *>(object.get());
+    if (planet != nullptr && (planet->getTerrain().enabled || planet->getSurfaceMap()) &&
+        terrain->add(*planet)) {
+      continue;
     }
+    renderVisitor->visit(object.get(), selectLevelOfDetail(pixelRadius), transforms.getModel(i),
+                         transforms.getNormal(i));
   }
+  renderVisitor->submit(stateCache);
+  terrain->draw(stateCache);
+  impostors->draw(stateCache);
+}
+
+void Renderer::renderParticles(const gui::Scene &scene) {
+  if (!settings.showParticles) {
+    return;
+  }
+  particles->update(scene.getBodies(), scene.getCentralMu(), settings.particleStyle,
+                    getThreadPool(), stateCache);
+  particles->draw(projectionMatrix, static_cast<float>(sceneTarget.getHeight()),
+                  settings.particleStyle, stateCache);
+}
+
+void Renderer::renderTrails(const gui::Scene &scene) {
+  if (!settings.showTrails) {
+    return;
+  }
+
+  // Trail samples are stamped with the time for fading
+  const float time = elapsedSeconds();
+
+  const auto &objects = scene.getObjects();
+  const auto &bodies = scene.getBodies();
+  const size_t bodyCount =
+      std::min(bodies.size(), static_cast<size_t>(std::max(settings.maxTrailBodies, 0)));
+  trailPositions.clear();
+  trailPositions.reserve(objects.size() + bodyCount);
+  for (const auto &obj : objects) {
+    trailPositions.push_back(obj.object ? obj.object->getPosition() : glm::vec3(0.0f));
+  }
+  for (size_t i = 0; i < bodyCount; ++i) {
+    trailPositions.emplace_back(bodies.position(i));
+  }
+
+  trails->update(trailPositions, time, settings.trailStyle, stateCache);
+  trails->draw(time, settings.trailStyle, stateCache);
+}
+
+void Renderer::renderPredictions(const gui::Scene &scene) {
+  if (!settings.showPredictions) {
+    if (predictionRequested) {
+      predictor.cancel();
+      predictionRequested = false;
+    }
+    return;
+  }
+
+  const auto &objects = scene.getObjects();
+  const auto &bodies = scene.getBodies();
+  PredictionRequest current;
+  current.sceneRevision = scene.getRevision();
+  current.settings = settings.prediction;
+  for (size_t i = 0; i < objects.size(); ++i) {
+    if (objects[i].object && (settings.predictAllBodies || objects[i].selected)) {
+      current.objects.push_back(i);
+    }
+  }
+  if (settings.predictAllBodies) {
+    current.bodyCount =
+        std::min(bodies.size(), static_cast<size_t>(std::max(settings.maxPredictedBodies, 0)));
+  }
+
+  // Hand the predictor a fresh snapshot whenever the scene, selection or settings change.
+  // Objects are on circular orbits about the origin, as in Scene::collectBodies().
+  if (!predictionRequested || !(current == lastPrediction)) {
+    const double mu = scene.getCentralMu();
+    sim::BodyStorage snapshot;
+    snapshot.reserve(current.objects.size() + current.bodyCount);
+    for (const size_t i : current.objects) {
+      const glm::dvec3 position(objects[i].object->getPosition());
+      snapshot.add(position, sim::circularVelocity(position, mu), 0.0,
+                   objects[i].object->getBoundingRadius());
+    }
+    for (size_t i = 0; i < current.bodyCount; ++i) {
+      snapshot.add(bodies.position(i), bodies.velocity(i), bodies.mass[i], bodies.radius[i]);
+    }
+    predictor.request(std::move(snapshot), mu, settings.prediction);
+    lastPrediction = std::move(current);
+    predictionRequested = true;
+  }
+
+  // Passes arrive coarse first; the previous paths stay up until the next one lands
+  if (predictor.takeLatest(predictedPaths)) {
+    paths->upload(predictedPaths, stateCache);
+  }
+  paths->draw(settings.predictionColor, stateCache);
+}
+
+float Renderer::elapsedSeconds() const {
+  return std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void Renderer::setWireframe(const bool enable) { wireframeMode = enable; }
+
+int Renderer::getDrawCallCount() const { return renderVisitor->getQueue().getDrawCallCount(); }
+
+size_t Renderer::getImpostorCount() const { return impostors->size(); }
+
+size_t Renderer::getTrailVertexCount() const {
+  return settings.showTrails ? trails->getVertexCount() : 0;
+}
+
+size_t Renderer::getPredictedPathCount() const {
+  return settings.showPredictions ? paths->getPathCount() : 0;
+}
+
+bool Renderer::isWellFieldSampled() const {
+  return settings.showGrid && settings.showGravityWells && wells->isFieldSampled();
+}
+
+size_t Renderer::getParticleCount() const {
+  return settings.showParticles ? particles->size() : 0;
 }
 
-void Renderer::setWireframe(const bool enable) {
-  wireframeMode = enable;
-  glPolygonMode(GL_FRONT_AND_BACK, enable ? GL_LINE : GL_FILL);
+size_t Renderer::getDrawPacketCount() const {
+  return renderVisitor->getQueue().getPacketCount();
 }
@@ -1,12 +1,25 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 #include <glm/glm.hpp>
 #include "core/window.h"
+#include "Graphics/core/Culling.h"
+#include "Graphics/core/GLStateCache.h"
+#include "Graphics/core/GravityWellRenderer.h"
+#include "Graphics/core/LightClusters.h"
+#include "Graphics/core/ResolutionScaler.h"
+#include "Graphics/core/SceneFramebuffer.h"
+#include "Graphics/core/StarRenderer.h"
+#include "Graphics/core/ParticleRenderer.h"
+#include "Graphics/core/TerrainRenderer.h"
+#include "Graphics/core/TrailRenderer.h"
+#include "Graphics/core/TransformSystem.h"
 #include "Graphics/shader.h"
+#include "Simulation/Prediction.h"
 
 // Forward declarations
 namespace gui {
@@ -14,6 +27,9 @@ namespace gui {
 }
 class RenderVisitor;
 class Light;
+class UniformBuffer;
+class ImpostorRenderer;
+class PathRenderer;
 
 class Renderer {
 public:
@@ -28,9 +44,19 @@ public:
         float specularStrength = 0.5f;
         float shininess = 32.0f;
         glm::vec3 backgroundColor{0.1f, 0.1f, 0.1f};
+
+        // The scene drops below window resolution while its GPU time runs over the target
+        ResolutionStyle resolution;
+
+        // Draw the scene only when something in it changed rather than every vsync
+        bool renderOnDemand = true;
+
+        // Star field behind the scene, streamed from the renderer's star catalog
+        bool showStars = true;
+        StarStyle starStyle;
+
         bool showGrid = true;
-        float gridSize = 20.0f;
-        int gridDivisions = 20;
+        float gridCellSize = 1.0f;  // spacing of the finest lines when viewed up close
         glm::vec3 gridColor{0.5f, 0.5f, 0.5f};
         float gridFadeDistance = 100.0f;
 
@@ -43,6 +69,38 @@ public:
         bool showAxisLines = true;
         glm::vec3 xAxisColor{0.8f, 0.2f, 0.2f};
         glm::vec3 zAxisColor{0.2f, 0.2f, 0.8f};
+
+        // Pull the grid down into the gravitational potential of the central and bulk masses
+        bool showGravityWells = false;
+        GravityWellStyle gravityWellStyle;
+
+        // Bodies smaller than this on screen (radius in pixels) are drawn as ray-cast impostors
+        bool useImpostors = true;
+        float impostorPixelRadius = 16.0f;
+
+        // Quadtree terrain of CubeSphere bodies: chunks split until their geometric error is
+        // at most this many pixels on screen, down to terrainMaxLevel
+        float terrainPixelError = 2.0f;
+        int terrainMaxLevel = 18;
+
+        // Bulk simulation bodies drawn as point sprites
+        bool showParticles = true;
+        ParticleStyle particleStyle;
+
+        // Orbit trails for the scene objects and the first maxTrailBodies bulk bodies
+        bool showTrails = true;
+        int maxTrailBodies = 10000;
+        TrailStyle trailStyle;
+
+        // Predicted trajectories of the selected objects, or of every object and the first
+        // maxPredictedBodies bulk bodies
+        bool showPredictions = true;
+        bool predictAllBodies = false;
+        int maxPredictedBodies = 2000;
+        sim::PredictionSettings prediction;
+        glm::vec3 predictionColor{1.0f, 0.8f, 0.3f};
+
+        bool operator==(const Settings&) const = default;
     };
 
     explicit Renderer(Window& window);
@@ -50,10 +108,19 @@ public:
 
     void init();
     void render(const gui::Scene& scene);  // Updated signature to match implementation
-    void renderScene(const gui::Scene& scene) const;  // Fixed namespace
-    void renderGrid() const;
-    void initGrid();
+    // Whether the scene would come out different from the one last drawn: the camera, the
+    // settings, the scene or the window changed, or something is still loading, refining or
+    // fading in. When it would not, present() shows the last one again without drawing it.
+    bool needsRender(const gui::Scene& scene) const;
+    void present();
+    void renderScene(const gui::Scene& scene);  // Fixed namespace
+    void renderStars();
+    void renderGrid(const gui::Scene& scene);
+    void renderParticles(const gui::Scene& scene);
+    void renderTrails(const gui::Scene& scene);
+    void renderPredictions(const gui::Scene& scene);
     void updateProjection();
+    void uploadFrameBlocks();
 
     void registerShader(const std::string& objectType, const std::shared_ptr<Shader> &shader) const;
     Settings& getSettings() { return settings; }
@@ -61,26 +128,99 @@ public:
     bool isWireframe() const { return wireframeMode; }
     void setWireframe(bool enable);
 
+    // Draw calls and packets of the last frame, for the performance window
+    int getDrawCallCount() const;
+    size_t getDrawPacketCount() const;
+    int getSkippedStateChanges() const { return stateCache.getSkippedChanges(); }
+    size_t getVisibleObjectCount() const { return culling.getVisibleCount(); }
+    size_t getTotalObjectCount() const { return culling.size(); }
+    size_t getImpostorCount() const;
+    size_t getTransformBlocksUpdated() const { return transformBlocksUpdated; }
+    size_t getParticleCount() const;
+    size_t getTrailVertexCount() const;
+    void clearTrails() { trails->clear(); }
+    size_t getPredictedPathCount() const;
+    bool isPredicting() const { return predictor.isBusy(); }
+    bool isWellFieldSampled() const;
+    // Reversed-Z through glClipControl, or the logarithmic depth fallback in the shaders
+    bool usesClipControl() const { return clipControl; }
+    // Size the scene was last drawn at and its GPU time, before scaling up to the window
+    int getSceneWidth() const { return sceneTarget.getWidth(); }
+    int getSceneHeight() const { return sceneTarget.getHeight(); }
+    float getResolutionScale() const { return resolution->getScale(); }
+    float getSceneGpuTime() const { return resolution->getFrameTime(); }
+    const LightClusters& getLightClusters() const { return lightClusters; }
+    const TerrainRenderer& getTerrain() const { return *terrain; }
+    StarRenderer& getStars() { return *stars; }
+    const StarRenderer& getStars() const { return *stars; }
+
     // Add light management methods
     std::vector<std::shared_ptr<Light>>& getLights() { return lights; }
     const std::vector<std::shared_ptr<Light>>& getLights() const { return lights; }
     void addLight(const std::shared_ptr<Light>& light) { lights.push_back(light); }
 
 private:
+    void initDepth();
+    float elapsedSeconds() const;
+
     Window& window;
     Settings settings;
+    SceneFramebuffer sceneTarget;
+    std::unique_ptr<ResolutionScaler> resolution;
+
+    // What the scene target was last drawn from
+    bool sceneDrawn = false;
+    Settings drawnSettings;
+    std::uint64_t drawnRevision = 0;
+    bool drawnWireframe = false;
+    int drawnWidth = 0;
+    int drawnHeight = 0;
+    bool clipControl = false;
     bool wireframeMode = false;
+    GLStateCache stateCache;
+    CullingPass culling;
+    TransformSystem transforms;
+    size_t transformBlocksUpdated = 0;
     std::unordered_map<std::string, std::shared_ptr<Shader>> shaders;
 
-    // Grid mesh data
+    // Procedural grid; the vertex array is empty since the pass generates its own triangle
     unsigned int gridVAO = 0;
-    unsigned int gridVBO = 0;
     std::shared_ptr<Shader> gridShader;
+    std::unique_ptr<UniformBuffer> gridBlock;
+    std::unique_ptr<GravityWellRenderer> wells;
 
     // View and projection matrices
     glm::mat4 viewMatrix{1.0f};
     glm::mat4 projectionMatrix{1.0f};
     std::unique_ptr<RenderVisitor> renderVisitor;
+    std::unique_ptr<ImpostorRenderer> impostors;
+    std::unique_ptr<TerrainRenderer> terrain;
+    std::unique_ptr<StarRenderer> stars;
+    std::unique_ptr<ParticleRenderer> particles;
+    std::unique_ptr<TrailRenderer> trails;
+    std::vector<glm::vec3> trailPositions;
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    // Background trajectory prediction and what the running request was made from
+    sim::TrajectoryPredictor predictor;
+    sim::PredictedPaths predictedPaths;
+    std::unique_ptr<PathRenderer> paths;
+    struct PredictionRequest {
+        std::uint64_t sceneRevision = 0;
+        std::vector<size_t> objects;
+        size_t bodyCount = 0;
+        sim::PredictionSettings settings;
+
+        bool operator==(const PredictionRequest&) const = default;
+    };
+    PredictionRequest lastPrediction;
+    bool predictionRequested = false;
+
+    // Camera and light blocks shared by every program, uploaded once per frame, and the
+    // per-cluster light lists the light block indexes into
+    std::unique_ptr<UniformBuffer> cameraBlock;
+    std::unique_ptr<UniformBuffer> lightsBlock;
+    LightClusters lightClusters;
 
     std::vector<std::shared_ptr<Light>> lights;  // Add lights vector
 };
@@ -1,8 +1,53 @@
 #include "shader.h"
+#include <filesystem>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <glm/gtc/type_ptr.hpp>
+#include <utility>
+#include <vector>
+#include "uniformBuffer.h"
+
+std::string Shader::preamble;
+
+void Shader::setPreamble(std::string text) {
+    preamble = std::move(text);
+}
+
+// Inserts the preamble after the first line, which has to stay the #version directive
+static std::string withPreamble(const std::string& code, const std::string& preamble) {
+    const size_t lineEnd = code.find('\n');
+    if (preamble.empty() || lineEnd == std::string::npos) {
+        return code;
+    }
+    return code.substr(0, lineEnd + 1) + preamble + code.substr(lineEnd + 1);
+}
+
+// Replaces each line of the form #include "name" with the named file, found next to the
+// shader. Includes do not nest.
+static std::string withIncludes(const std::string& code, const std::filesystem::path& path) {
+    static constexpr std::string_view directive = "#include \"";
+
+    std::string result;
+    std::istringstream lines(code);
+    std::string line;
+    while (std::getline(lines, line)) {
+        const size_t end = line.rfind('"');
+        if (line.compare(0, directive.size(), directive) != 0 || end < directive.size()) {
+            result += line;
+            result += '\n';
+            continue;
+        }
+        std::ifstream file;
+        file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        file.open(path.parent_path() /
+                  line.substr(directive.size(), end - directive.size()));
+        std::stringstream stream;
+        stream << file.rdbuf();
+        result += stream.str();
+    }
+    return result;
+}
 
 Shader::Shader(const char* vertexPath, const char* fragmentPath) {
     std::string vertexCode;
@@ -24,8 +69,8 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
         vShaderFile.close();
         fShaderFile.close();
 
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
+        vertexCode = withPreamble(withIncludes(vShaderStream.str(), vertexPath), preamble);
+        fragmentCode = withPreamble(withIncludes(fShaderStream.str(), fragmentPath), preamble);
     }
     catch(std::ifstream::failure& e) {
         std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
@@ -54,6 +99,65 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
 
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+
+    cacheUniformLocations();
+    bindSharedResources();
+}
+
+void Shader::cacheUniformLocations() {
+    int count = 0;
+    int maxLength = 0;
+    glGetProgramiv(programID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::vector<char> buffer(static_cast<size_t>(maxLength) + 1);
+    for (int i = 0; i < count; ++i) {
+        int length = 0;
+        int size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(programID, static_cast<GLuint>(i), static_cast<GLsizei>(buffer.size()),
+                           &length, &size, &type, buffer.data());
+        const std::string name(buffer.data(), static_cast<size_t>(length));
+        const int location = glGetUniformLocation(programID, name.c_str());
+        if (location < 0) {
+            continue; // Members of uniform blocks have no location
+        }
+        uniformLocations[name] = location;
+
+        // Arrays are reported as "name[0]"; also register the bare name and every element
+        if (size > 1 && name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+            const std::string base = name.substr(0, name.size() - 3);
+            uniformLocations[base] = location;
+            for (int element = 1; element < size; ++element) {
+                const std::string elementName = base + "[" + std::to_string(element) + "]";
+                uniformLocations[elementName] =
+                    glGetUniformLocation(programID, elementName.c_str());
+            }
+        }
+    }
+}
+
+void Shader::bindSharedResources() const {
+    for (const auto& block : SHARED_UNIFORM_BLOCKS) {
+        const GLuint index = glGetUniformBlockIndex(programID, block.name);
+        if (index != GL_INVALID_INDEX) {
+            glUniformBlockBinding(programID, index, block.binding);
+        }
+    }
+
+    // Sampler uniforms are program state, so setting them needs the program bound
+    glUseProgram(programID);
+    for (const auto& sampler : SHARED_SAMPLERS) {
+        const int location = getUniformLocation(sampler.name);
+        if (location != -1) {
+            glUniform1i(location, sampler.unit);
+        }
+    }
+}
+
+int Shader::getUniformLocation(std::string_view name) const {
+    const auto it = uniformLocations.find(name);
+    return it != uniformLocations.end() ? it->second : -1;
 }
 
 Shader::~Shader() {
@@ -64,24 +168,32 @@ void Shader::use() const {
     glUseProgram(programID);
 }
 
-void Shader::setBool(const std::string &name, bool value) const {
-    glUniform1i(glGetUniformLocation(programID, name.c_str()), (int)value);
+void Shader::setBool(std::string_view name, bool value) const {
+    glUniform1i(getUniformLocation(name), (int)value);
+}
+
+void Shader::setInt(std::string_view name, int value) const {
+    glUniform1i(getUniformLocation(name), value);
+}
+
+void Shader::setFloat(std::string_view name, float value) const {
+    glUniform1f(getUniformLocation(name), value);
 }
 
-void Shader::setInt(const std::string &name, int value) const {
-    glUniform1i(glGetUniformLocation(programID, name.c_str()), value);
+void Shader::setVec3(std::string_view name, const glm::vec3 &value) const {
+    glUniform3fv(getUniformLocation(name), 1, glm::value_ptr(value));
 }
 
-void Shader::setFloat(const std::string &name, float value) const {
-    glUniform1f(glGetUniformLocation(programID, name.c_str()), value);
+void Shader::setVec4(std::string_view name, const glm::vec4 &value) const {
+    glUniform4fv(getUniformLocation(name), 1, glm::value_ptr(value));
 }
 
-void Shader::setVec3(const std::string &name, const glm::vec3 &value) const {
-    glUniform3fv(glGetUniformLocation(programID, name.c_str()), 1, glm::value_ptr(value));
+void Shader::setMat3(std::string_view name, const glm::mat3 &mat) const {
+    glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(mat));
 }
 
-void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(programID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+void Shader::setMat4(std::string_view name, const glm::mat4 &mat) const {
+    glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(mat));
 }
 
 void Shader::checkCompileErrors(unsigned int shader, const std::string& type) {
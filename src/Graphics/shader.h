@@ -1,6 +1,9 @@
 #pragma once
 #include <glad/glad.h>
+#include <functional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <glm/glm.hpp>
 
 class Shader {
@@ -8,14 +11,42 @@ public:
     Shader(const char* vertexPath, const char* fragmentPath);
     ~Shader();
 
+    Shader(const Shader&) = delete;
+    Shader& operator=(const Shader&) = delete;
+
+    // Source inserted after the #version line of every shader compiled from now on, for
+    // defines that depend on what the driver supports.
+    static void setPreamble(std::string text);
+
     void use() const;
-    void setBool(const std::string &name, bool value) const;
-    void setInt(const std::string &name, int value) const;
-    void setFloat(const std::string &name, float value) const;
-    void setVec3(const std::string &name, const glm::vec3 &value) const;
-    void setMat4(const std::string &name, const glm::mat4 &mat) const;
+    unsigned int getID() const { return programID; }
+
+    // Locations are reflected once after linking; unknown names give -1, which GL ignores.
+    int getUniformLocation(std::string_view name) const;
+
+    void setBool(std::string_view name, bool value) const;
+    void setInt(std::string_view name, int value) const;
+    void setFloat(std::string_view name, float value) const;
+    void setVec3(std::string_view name, const glm::vec3 &value) const;
+    void setVec4(std::string_view name, const glm::vec4 &value) const;
+    void setMat3(std::string_view name, const glm::mat3 &mat) const;
+    void setMat4(std::string_view name, const glm::mat4 &mat) const;
 
 private:
+    // Lets the location map be searched with a string_view without building a std::string.
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const {
+            return std::hash<std::string_view>{}(name);
+        }
+    };
+
+    static std::string preamble;
+
     unsigned int programID;
+    std::unordered_map<std::string, int, NameHash, std::equal_to<>> uniformLocations;
+
     void checkCompileErrors(unsigned int shader, const std::string& type);
+    void cacheUniformLocations();
+    void bindSharedResources() const;
 };
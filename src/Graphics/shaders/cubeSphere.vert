@@ -2,21 +2,29 @@
 
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
+layout (location = 2) in mat4 instanceModel;  // per instance, locations 2-5
+layout (location = 6) in vec4 instanceColor;
+layout (location = 7) in mat3 instanceNormal;  // per instance, locations 7-9
 
 out vec3 FragPos;
+out vec3 Color;
 out vec3 Normal;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosition;
+    vec4 depthRange;  // near plane, 1 / ln(far / near) for logarithmic depth
+};
 
 void main() {
     // Calculate fragment position in world space
-    FragPos = vec3(model * vec4(aPos, 1.0));
+    FragPos = vec3(instanceModel * vec4(aPos, 1.0));
+    Color = instanceColor.rgb;
     
     // Transform normal to world space while handling non-uniform scaling
-    // The transpose(inverse(mat3(model))) corrects normal transformation under non-uniform scaling
-    Normal = normalize(mat3(transpose(inverse(model))) * aNormal);
+    // The normal matrix is the inverse transpose of mat3(model), precomputed on the CPU
+    Normal = normalize(instanceNormal * aNormal);
     
     // Transform vertex position to clip space
     gl_Position = projection * view * vec4(FragPos, 1.0);
@@ -1,60 +1,96 @@
 #version 410 core
 out vec4 FragColor;
 
-in vec3 FragPos;
-in float DistanceFromCamera;
-
-uniform vec3 gridColor;
-uniform vec3 majorGridColor;
-uniform float fadeDistance;
-uniform float gridSize;
-uniform int gridDivisions;
-uniform float majorGridSpacing;
-uniform float minorLineWidth;
-uniform float majorLineWidth;
-uniform float gridOpacity;
-uniform bool showAxisLines;
-uniform vec3 xAxisColor;
-uniform vec3 zAxisColor;
+in vec3 NearPoint;
+in vec3 FarPoint;
 
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosition;
+    vec4 depthRange;  // near plane, 1 / ln(far / near) for logarithmic depth
+};
+
+layout (std140) uniform Grid {
+    mat4 inverseViewProjection;
+    vec4 minorColor;  // a = opacity
+    vec4 majorColor;  // a = cells per major line
+    vec4 xAxisColor;  // a = 1 when axis lines are shown
+    vec4 zAxisColor;
+    vec4 lines;       // cell size, fade distance, minor width, major width (pixels)
+};
+
+// Minor lines closer together than this many pixels hand over to the next level
+const float MIN_CELL_PIXELS = 8.0;
+
+// Coverage of lines spaced `size` apart with the given width in pixels, antialiased
 float getGrid(vec2 coord, float size, float width) {
-    vec2 grid = abs(fract(coord / size - 0.5) - 0.5) / fwidth(coord / size);
-    return 1.0 - min(min(grid.x, grid.y), 1.0) * width;
+    vec2 derivative = fwidth(coord / size);
+    vec2 grid = abs(fract(coord / size - 0.5) - 0.5) / derivative;
+    return 1.0 - min(min(grid.x, grid.y) / max(width, 1e-3), 1.0);
 }
 
 void main() {
-    float cellSize = gridSize / float(gridDivisions);
+    // Intersect this pixel's view ray with the y = 0 plane
+    vec3 rayDir = FarPoint - NearPoint;
+    float t = -NearPoint.y / rayDir.y;
+    if (!(t > 0.0 && t <= 1.0)) {
+        discard;
+    }
+    vec3 FragPos = NearPoint + t * rayDir;
     vec2 coord = FragPos.xz;
-    
-    // Calculate fade based on distance
-    float fade = 1.0 - (DistanceFromCamera / fadeDistance);
-    fade = clamp(fade, 0.0, 1.0);
-    
-    // Minor grid
-    float minorGrid = getGrid(coord, cellSize, minorLineWidth);
-    
-    // Major grid
-    float majorGrid = getGrid(coord, cellSize * majorGridSpacing, majorLineWidth);
-    
-    // Combine grids
-    vec3 color = mix(gridColor, majorGridColor, majorGrid);
-    float alpha = max(minorGrid, majorGrid) * gridOpacity * fade;
-    
+
+    vec4 clip = projection * view * vec4(FragPos, 1.0);
+#ifdef LOG_DEPTH
+    gl_FragDepth = getLogDepth(clip.w, depthRange);
+#else
+    gl_FragDepth = clip.z / clip.w;
+#endif
+
+    float cellSize = lines.x;
+    float spacing = max(majorColor.a, 2.0);
+    float fade = clamp(1.0 - length(FragPos - viewPosition.xyz) / lines.y, 0.0, 1.0);
+
+    // Level of detail from the world size of a pixel; each level is `spacing` times coarser,
+    // and the fractional part crossfades the finest level out as the next takes over
+    vec2 footprint = fwidth(coord);
+    float pixelSize = max(footprint.x, footprint.y);
+    float lod = max(log(pixelSize * MIN_CELL_PIXELS / cellSize) / log(spacing), 0.0);
+    float level = floor(lod);
+    float blend = lod - level;
+    float size0 = cellSize * pow(spacing, level);
+    float size1 = size0 * spacing;
+    float size2 = size1 * spacing;
+
+    // Level 1 lines turn from major into minor as they become the finest level
+    float grid0 = getGrid(coord, size0, lines.z) * (1.0 - blend);
+    float grid1 = getGrid(coord, size1, mix(lines.w, lines.z, blend));
+    float grid2 = getGrid(coord, size2, lines.w);
+
+    float majorCoverage = max(grid1 * (1.0 - blend), grid2);
+    float minorCoverage = max(grid0, grid1 * blend);
+    vec3 color = mix(minorColor.rgb, majorColor.rgb,
+                     majorCoverage / max(majorCoverage + minorCoverage, 1e-4));
+    float alpha = max(max(grid0, grid1), grid2) * minorColor.a * fade;
+
     // Add axis lines
-    if (showAxisLines) {
-        float axisWidth = majorLineWidth * 2.0;
+    if (xAxisColor.a > 0.5) {
+        float axisWidth = lines.w * 2.0;
         float xAxis = 1.0 - smoothstep(0.0, fwidth(coord.y) * axisWidth, abs(coord.y));
         float zAxis = 1.0 - smoothstep(0.0, fwidth(coord.x) * axisWidth, abs(coord.x));
-        
+
         if (xAxis > 0.0) {
-            color = xAxisColor;
+            color = xAxisColor.rgb;
             alpha = max(alpha, xAxis * fade);
         }
         if (zAxis > 0.0) {
-            color = zAxisColor;
+            color = zAxisColor.rgb;
             alpha = max(alpha, zAxis * fade);
         }
     }
-    
+
+    if (alpha <= 0.0) {
+        discard;
+    }
     FragColor = vec4(color, alpha);
 }
@@ -1,19 +1,31 @@
 #version 410 core
-layout (location = 0) in vec3 aPos;
+// Full-screen pass: no vertex buffer, one triangle generated from gl_VertexID
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform Grid {
+    mat4 inverseViewProjection;
+    vec4 minorColor;  // a = opacity
+    vec4 majorColor;  // a = cells per major line
+    vec4 xAxisColor;  // a = 1 when axis lines are shown
+    vec4 zAxisColor;
+    vec4 lines;       // cell size, fade distance, minor width, major width (pixels)
+};
 
-out vec3 FragPos;
-out float DistanceFromCamera;
+out vec3 NearPoint;
+out vec3 FarPoint;
+
+vec3 unproject(vec2 ndc, float depth) {
+    vec4 point = inverseViewProjection * vec4(ndc, depth, 1.0);
+    return point.xyz / point.w;
+}
 
 void main() {
-    vec4 worldPos = model * vec4(aPos, 1.0);
-    FragPos = worldPos.xyz;
-    
-    vec4 viewPos = view * worldPos;
-    DistanceFromCamera = length(viewPos.xyz);
-    
-    gl_Position = projection * viewPos;
+    // (-1, -1), (3, -1), (-1, 3) covers the whole viewport
+    vec2 ndc = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;
+
+    // Reversed-Z with no far plane: depth 1 is the near plane, and 1e-6 a million near-plane
+    // distances out, well past any fade distance. Planes of constant depth map affinely to the
+    // screen, so these interpolate exactly.
+    NearPoint = unproject(ndc, 1.0);
+    FarPoint = unproject(ndc, 1e-6);
+    gl_Position = vec4(ndc, 0.0, 1.0);
 }
@@ -0,0 +1,75 @@
+#version 410 core
+out vec4 FragColor;
+
+in vec3 QuadPos;
+flat in vec3 SphereCenter;
+flat in float SphereRadius;
+flat in vec3 Color;
+
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosition;
+    vec4 depthRange;  // near plane, 1 / ln(far / near) for logarithmic depth
+};
+
+#include "lights.glsl"
+
+void main() {
+    // Intersect the view ray through this fragment with the sphere
+    vec3 rayDir = normalize(QuadPos);
+    float b = dot(rayDir, SphereCenter);
+    float c = dot(SphereCenter, SphereCenter) - SphereRadius * SphereRadius;
+    float discriminant = b * b - c;
+    if (discriminant < 0.0) {
+        discard;
+    }
+    vec3 FragPos = rayDir * (b - sqrt(discriminant));
+    vec3 norm = (FragPos - SphereCenter) / SphereRadius;
+
+    // Exact depth of the hit point, so impostors intersect meshes correctly
+    vec4 clip = projection * vec4(FragPos, 1.0);
+#ifdef LOG_DEPTH
+    gl_FragDepth = getLogDepth(clip.w, depthRange);
+#else
+    gl_FragDepth = clip.z / clip.w;
+#endif
+
+    // Same lighting model as sphere.frag, evaluated in view space
+    vec3 result = vec3(0.0);
+    vec3 viewDir = normalize(-FragPos);
+
+    // Calculate contribution from each light reaching this fragment's cluster
+    uvec2 cluster = getCluster(-FragPos.z);
+    int lightCount = int(clusterGrid.w) + int(cluster.y);
+    for(int k = 0; k < lightCount; k++) {
+        int i = getLightIndex(k, cluster);
+        vec4 position = texelFetch(lightData, 3 * i);
+        vec4 color = texelFetch(lightData, 3 * i + 1);
+        vec4 terms = texelFetch(lightData, 3 * i + 2);
+        vec3 lightColor = color.rgb;
+        vec3 lightPos = vec3(view * vec4(position.xyz, 1.0));
+
+        // ambient
+        vec3 ambient = terms.x * lightColor;
+
+        // diffuse
+        vec3 toLight = lightPos - FragPos;
+        vec3 lightDir = normalize(toLight);
+        float diff = max(dot(norm, lightDir), 0.0);
+        vec3 diffuse = terms.y * diff * lightColor;
+
+        // specular
+        vec3 reflectDir = reflect(-lightDir, norm);
+        float spec = pow(max(dot(viewDir, reflectDir), 0.0), terms.w);
+        vec3 specular = terms.z * spec * lightColor;
+
+        // combine and apply light intensity
+        result += (ambient + diffuse + specular) * color.a *
+                  getAttenuation(length(toLight), position.w);
+    }
+
+    // Apply final color
+    result *= Color;
+    FragColor = vec4(result, 1.0);
+}
@@ -0,0 +1,34 @@
+#version 410 core
+layout (location = 0) in vec2 aCorner;          // quad corner in [-1, 1]
+layout (location = 1) in vec4 instanceSphere;   // per instance: world center, radius
+layout (location = 2) in vec4 instanceColor;
+
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosition;
+    vec4 depthRange;  // near plane, 1 / ln(far / near) for logarithmic depth
+};
+
+out vec3 QuadPos;
+flat out vec3 SphereCenter;
+flat out float SphereRadius;
+flat out vec3 Color;
+
+void main() {
+    // Everything is done in view space, where the camera sits at the origin
+    vec3 center = vec3(view * vec4(instanceSphere.xyz, 1.0));
+    float radius = instanceSphere.w;
+
+    // Grow the quad to the silhouette cone's width at the center's depth, and again by
+    // 1 / cos of the off-axis angle, so the projected sphere always fits inside it
+    float distance2 = dot(center, center);
+    float grow = inversesqrt(max(1.0 - radius * radius / distance2, 1e-4));
+    grow *= sqrt(distance2) / max(-center.z, radius);
+
+    QuadPos = center + vec3(aCorner * radius * grow, 0.0);
+    SphereCenter = center;
+    SphereRadius = radius;
+    Color = instanceColor.rgb;
+    gl_Position = projection * vec4(QuadPos, 1.0);
+}
@@ -0,0 +1,38 @@
+// Clustered light lookup shared by the lit fragment shaders, pulled in with #include
+
+layout (std140) uniform Lights {
+    vec4 clusterGrid;   // clusters in x, y and z, number of unbounded lights
+    vec4 clusterDepth;  // near distance, z slices per e-fold of distance
+    vec4 viewport;      // width and height in pixels
+};
+
+// Three texels per light: position and range, color and intensity, then
+// ambient, diffuse, specular strength and shininess
+uniform samplerBuffer lightData;
+uniform usamplerBuffer lightClusters;  // first list entry and light count per cluster
+uniform usamplerBuffer lightIndices;
+
+// List range of the cluster holding this fragment
+uvec2 getCluster(float viewDepth) {
+    ivec3 grid = ivec3(clusterGrid.xyz);
+    ivec2 tile = ivec2(gl_FragCoord.xy / viewport.xy * clusterGrid.xy);
+    int slice = int(floor(log(viewDepth / clusterDepth.x) * clusterDepth.y));
+    ivec3 cell = clamp(ivec3(tile, slice), ivec3(0), grid - 1);
+    return texelFetch(lightClusters, (cell.z * grid.y + cell.y) * grid.x + cell.x).xy;
+}
+
+// The unbounded lights come first, then the ranged ones listed for the cluster
+int getLightIndex(int k, uvec2 cluster) {
+    int unbounded = int(clusterGrid.w);
+    return k < unbounded ? k : int(texelFetch(lightIndices, int(cluster.x) + k - unbounded).r);
+}
+
+// Ranged lights fade smoothly to nothing at their range
+float getAttenuation(float distance, float range) {
+    if (range <= 0.0) {
+        return 1.0;
+    }
+    float ratio = distance / range;
+    float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+    return window * window;
+}
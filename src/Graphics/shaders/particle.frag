@@ -0,0 +1,46 @@
+#version 410 core
+out vec4 FragColor;
+
+in vec3 Color;
+in vec3 ViewPos;
+
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosition;
+    vec4 depthRange;  // near plane, 1 / ln(far / near) for logarithmic depth
+};
+
+#include "lights.glsl"
+
+void main() {
+    // Round sprite: drop the corners and shade the disc as a sphere seen head-on
+    vec2 disc = gl_PointCoord * 2.0 - 1.0;
+    disc.y = -disc.y;
+    float r2 = dot(disc, disc);
+    if (r2 > 1.0) {
+        discard;
+    }
+    vec3 norm = vec3(disc, sqrt(1.0 - r2));
+
+    // Ambient and diffuse only; specular highlights are lost at a few pixels anyway
+    vec3 result = vec3(0.0);
+    uvec2 cluster = getCluster(-ViewPos.z);
+    int lightCount = int(clusterGrid.w) + int(cluster.y);
+    for (int k = 0; k < lightCount; k++) {
+        int i = getLightIndex(k, cluster);
+        vec4 position = texelFetch(lightData, 3 * i);
+        vec4 color = texelFetch(lightData, 3 * i + 1);
+        vec4 terms = texelFetch(lightData, 3 * i + 2);
+        vec3 toLight = vec3(view * vec4(position.xyz, 1.0)) - ViewPos;
+        float diff = max(dot(norm, normalize(toLight)), 0.0);
+        result += (terms.x + terms.y * diff) * color.rgb * color.a *
+                  getAttenuation(length(toLight), position.w);
+    }
+
+    FragColor = vec4(result * Color, 1.0);
+
+#ifdef LOG_DEPTH
+    gl_FragDepth = getLogDepth(1.0 / gl_FragCoord.w, depthRange);
+#endif
+}
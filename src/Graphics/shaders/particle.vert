@@ -0,0 +1,41 @@
+#version 410 core
+layout (location = 0) in vec4 aParticle;  // world position, radius
+layout (location = 1) in float aValue;    // color map input in [0, 1]
+
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosition;
+    vec4 depthRange;  // near plane, 1 / ln(far / near) for logarithmic depth
+};
+
+uniform float pointScale;     // projection[1][1] * viewport height / 2
+uniform float minPointSize;
+uniform int colorMode;        // ParticleColorMode; 0 = uniform color
+uniform vec3 uniformColor;
+
+out vec3 Color;
+out vec3 ViewPos;
+
+// Dark blue -> cyan -> yellow -> red, matching ColorMap in PorkchopWindow.cpp
+vec3 colorMap(float t) {
+    t = clamp(t, 0.0, 1.0);
+    if (t < 0.33) {
+        return mix(vec3(0.05, 0.1, 0.4), vec3(0.05, 0.7, 0.9), t / 0.33);
+    }
+    if (t < 0.66) {
+        return mix(vec3(0.05, 0.7, 0.9), vec3(0.95, 0.9, 0.1), (t - 0.33) / 0.33);
+    }
+    return mix(vec3(0.95, 0.9, 0.1), vec3(0.95, 0.1, 0.1), (t - 0.66) / 0.34);
+}
+
+void main() {
+    vec4 viewPos = view * vec4(aParticle.xyz, 1.0);
+    ViewPos = viewPos.xyz;
+    Color = colorMode == 0 ? uniformColor : colorMap(aValue);
+
+    // Projected diameter in pixels, never smaller than minPointSize so distant bodies stay visible
+    float depth = max(-viewPos.z, 1e-4);
+    gl_PointSize = max(2.0 * aParticle.w * pointScale / depth, minPointSize);
+    gl_Position = projection * viewPos;
+}
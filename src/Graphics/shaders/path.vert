@@ -0,0 +1,17 @@
+#version 410 core
+layout (location = 0) in vec4 aSample;  // world position, fraction of the prediction span
+
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosition;
+    vec4 depthRange;  // near plane, 1 / ln(far / near) for logarithmic depth
+};
+
+out float Alpha;
+
+void main() {
+    // Fade toward the end of the prediction, where it is least certain
+    Alpha = 1.0 - 0.8 * aSample.w;
+    gl_Position = projection * view * vec4(aSample.xyz, 1.0);
+}
@@ -1,16 +1,24 @@
 #version 410 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
+layout (location = 2) in mat4 instanceModel;  // per instance, locations 2-5
+layout (location = 6) in vec4 instanceColor;
+layout (location = 7) in mat3 instanceNormal;  // per instance, locations 7-9
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosition;
+    vec4 depthRange;  // near plane, 1 / ln(far / near) for logarithmic depth
+};
 
 out vec3 Normal;
 out vec3 FragPos;
+out vec3 Color;
 
 void main() {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    FragPos = vec3(instanceModel * vec4(aPos, 1.0));
+    Color = instanceColor.rgb;
+    Normal = instanceNormal * aNormal;
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
@@ -0,0 +1,15 @@
+#version 410 core
+out vec4 FragColor;
+
+in vec3 Color;
+in float Intensity;
+
+void main() {
+    // Soft round point, brightest at the center
+    vec2 disc = gl_PointCoord * 2.0 - 1.0;
+    float r2 = dot(disc, disc);
+    if (r2 > 1.0) {
+        discard;
+    }
+    FragColor = vec4(Color, Intensity * exp(-2.0 * r2));
+}
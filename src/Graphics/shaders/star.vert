@@ -0,0 +1,47 @@
+#version 410 core
+layout (location = 0) in vec3 aDirection;  // unit vector toward the star
+layout (location = 1) in float aMagnitude;
+layout (location = 2) in float aColorIndex; // B-V
+
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosition;
+    vec4 depthRange;  // near plane, 1 / ln(far / near) for logarithmic depth
+};
+
+uniform float magnitudeLimit;  // faintest magnitude drawn this frame
+uniform float brightness;
+uniform float maxPointSize;
+
+out vec3 Color;
+out float Intensity;
+
+// Blackbody tint by B-V, from blue-white O stars to orange-red M stars
+vec3 starColor(float bv) {
+    bv = clamp(bv, -0.4, 2.0);
+    if (bv < 0.0) {
+        return mix(vec3(0.61, 0.71, 1.0), vec3(0.85, 0.88, 1.0), (bv + 0.4) / 0.4);
+    }
+    if (bv < 0.6) {
+        return mix(vec3(0.85, 0.88, 1.0), vec3(1.0, 0.96, 0.91), bv / 0.6);
+    }
+    if (bv < 1.4) {
+        return mix(vec3(1.0, 0.96, 0.91), vec3(1.0, 0.78, 0.55), (bv - 0.6) / 0.8);
+    }
+    return mix(vec3(1.0, 0.78, 0.55), vec3(1.0, 0.6, 0.4), (bv - 1.4) / 0.6);
+}
+
+void main() {
+    // Flux relative to a star at the limit, by Pogson's ratio of 100 per five magnitudes. Faint
+    // stars dim a single pixel; brighter ones saturate it and then grow with their flux.
+    float energy = 0.2 * brightness * pow(10.0, 0.4 * (magnitudeLimit - aMagnitude));
+    Intensity = min(energy, 1.0);
+    Color = starColor(aColorIndex);
+    gl_PointSize = clamp(1.5 * sqrt(energy), 1.5, maxPointSize);
+
+    // Stars are at infinity, so only the rotation of the view moves them. Any depth inside the
+    // clip volume will do; the pass draws without depth testing.
+    vec4 clip = projection * vec4(mat3(view) * aDirection, 1.0);
+    gl_Position = vec4(clip.xy, 0.5 * clip.w, clip.w);
+}
@@ -0,0 +1,66 @@
+#version 410 core
+out vec4 FragColor;
+
+in vec3 Normal;
+in vec3 FragPos;
+in vec3 Color;
+in vec2 SurfaceUV;
+
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosition;
+    vec4 depthRange;  // near plane, 1 / ln(far / near) for logarithmic depth
+};
+
+uniform sampler2D surfaceAtlas;
+uniform vec4 surfaceTransform;
+
+#include "lights.glsl"
+
+void main() {
+    vec3 result = vec3(0.0);
+    vec3 norm = normalize(Normal);
+    vec3 viewDir = normalize(viewPosition.xyz - FragPos);
+
+    // Calculate contribution from each light reaching this fragment's cluster
+    uvec2 cluster = getCluster(-(view * vec4(FragPos, 1.0)).z);
+    int lightCount = int(clusterGrid.w) + int(cluster.y);
+    for(int k = 0; k < lightCount; k++) {
+        int i = getLightIndex(k, cluster);
+        vec4 position = texelFetch(lightData, 3 * i);
+        vec4 color = texelFetch(lightData, 3 * i + 1);
+        vec4 terms = texelFetch(lightData, 3 * i + 2);
+        vec3 lightColor = color.rgb;
+
+        // ambient
+        vec3 ambient = terms.x * lightColor;
+
+        // diffuse
+        vec3 toLight = position.xyz - FragPos;
+        vec3 lightDir = normalize(toLight);
+        float diff = max(dot(norm, lightDir), 0.0);
+        vec3 diffuse = terms.y * diff * lightColor;
+
+        // specular
+        vec3 reflectDir = reflect(-lightDir, norm);
+        float spec = pow(max(dot(viewDir, reflectDir), 0.0), terms.w);
+        vec3 specular = terms.z * spec * lightColor;
+
+        // combine and apply light intensity
+        result += (ambient + diffuse + specular) * color.a *
+                  getAttenuation(length(toLight), position.w);
+    }
+
+    // Apply final color, tinted by the surface map where the body has one
+    vec3 albedo = Color;
+    if (surfaceTransform.z > 0.0) {
+        albedo *= texture(surfaceAtlas, SurfaceUV).rgb;
+    }
+    result *= albedo;
+    FragColor = vec4(result, 1.0);
+
+#ifdef LOG_DEPTH
+    gl_FragDepth = getLogDepth(1.0 / gl_FragCoord.w, depthRange);
+#endif
+}
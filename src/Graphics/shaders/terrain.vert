@@ -0,0 +1,39 @@
+#version 410 core
+
+layout (location = 0) in vec3 aPos;     // relative to the chunk's center
+layout (location = 1) in vec3 aNormal;
+
+out vec3 FragPos;
+out vec3 Color;
+out vec3 Normal;
+out vec2 SurfaceUV;
+
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosition;
+    vec4 depthRange;  // near plane, 1 / ln(far / near) for logarithmic depth
+};
+
+uniform mat4 chunkModel;
+// View and model composed on the CPU in double, so the camera-relative position stays exact
+// close to the surface of a large body
+uniform mat4 chunkModelView;
+uniform mat3 normalMatrix;
+uniform vec3 objectColor;
+// Where the chunk's surface map texels are in the atlas: offset, then scale; no map when zero
+uniform vec4 surfaceTransform;
+
+const int CHUNK_SIDE = 17;  // TERRAIN_CHUNK_SIDE
+
+void main() {
+    FragPos = vec3(chunkModel * vec4(aPos, 1.0));
+    Color = objectColor;
+    Normal = normalize(normalMatrix * aNormal);
+    // The pool is drawn with a base vertex per chunk, so the vertex's place in its grid follows
+    // from its id
+    int local = gl_VertexID % (CHUNK_SIDE * CHUNK_SIDE);
+    vec2 chunkUV = vec2(local % CHUNK_SIDE, local / CHUNK_SIDE) / float(CHUNK_SIDE - 1);
+    SurfaceUV = surfaceTransform.xy + chunkUV * surfaceTransform.zw;
+    gl_Position = projection * (chunkModelView * vec4(aPos, 1.0));
+}
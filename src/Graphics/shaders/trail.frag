@@ -0,0 +1,21 @@
+#version 410 core
+out vec4 FragColor;
+
+in float Alpha;
+
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosition;
+    vec4 depthRange;  // near plane, 1 / ln(far / near) for logarithmic depth
+};
+
+uniform vec3 trailColor;
+
+void main() {
+    FragColor = vec4(trailColor, Alpha * Alpha);
+
+#ifdef LOG_DEPTH
+    gl_FragDepth = getLogDepth(1.0 / gl_FragCoord.w, depthRange);
+#endif
+}
@@ -0,0 +1,21 @@
+#version 410 core
+layout (location = 0) in vec4 aSample;  // world position, time it was taken
+
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosition;
+    vec4 depthRange;  // near plane, 1 / ln(far / near) for logarithmic depth
+};
+
+uniform float time;
+uniform float fadeTime;
+
+out float Alpha;
+
+void main() {
+    // Older samples fade out, so the trail tapers toward its tail
+    float age = clamp((time - aSample.w) / fadeTime, 0.0, 1.0);
+    Alpha = 1.0 - age;
+    gl_Position = projection * view * vec4(aSample.xyz, 1.0);
+}
@@ -0,0 +1,47 @@
+#version 410 core
+layout (location = 0) in vec2 aLocal;  // [-1, 1], rings widening away from the center
+
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosition;
+    vec4 depthRange;  // near plane, 1 / ln(far / near) for logarithmic depth
+};
+
+layout (std140) uniform Wells {
+    vec4 bodies[32];  // position, mass
+    vec4 surface;     // mesh center x and z, mesh half extent, depth scale
+    vec4 field;       // body count, softening, max depth, 1 when sampled
+    vec4 region;      // sampled center x and z, half extent, unused
+};
+
+uniform sampler2D potentialMap;
+
+out vec2 PlaneCoord;
+out vec3 FragPos;
+
+float getPotential(vec2 coord) {
+    vec3 point = vec3(coord.x, 0.0, coord.y);
+    float softening2 = field.y * field.y;
+    float potential = 0.0;
+    for (int i = 0; i < int(field.x); ++i) {
+        vec3 offset = bodies[i].xyz - point;
+        potential -= bodies[i].w * inversesqrt(dot(offset, offset) + softening2);
+    }
+
+    // The sampled grid has its outermost samples on the region's edges
+    if (field.w > 0.5) {
+        float resolution = float(textureSize(potentialMap, 0).x);
+        vec2 grid = (coord - region.xy) / (2.0 * region.z) + 0.5;
+        vec2 uv = (grid * (resolution - 1.0) + 0.5) / resolution;
+        potential += texture(potentialMap, uv).r;
+    }
+    return potential;
+}
+
+void main() {
+    PlaneCoord = surface.xy + aLocal * surface.z;
+    float depth = max(surface.w * getPotential(PlaneCoord), -field.z);
+    FragPos = vec3(PlaneCoord.x, depth, PlaneCoord.y);
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
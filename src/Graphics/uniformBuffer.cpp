@@ -0,0 +1,18 @@
+#include "uniformBuffer.h"
+#include <glad/glad.h>
+
+UniformBuffer::UniformBuffer(unsigned int binding, std::size_t size) {
+  glGenBuffers(1, &bufferID);
+  glBindBuffer(GL_UNIFORM_BUFFER, bufferID);
+  glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  glBindBufferBase(GL_UNIFORM_BUFFER, binding, bufferID);
+}
+
+UniformBuffer::~UniformBuffer() { glDeleteBuffers(1, &bufferID); }
+
+void UniformBuffer::update(const void *data, std::size_t size) const {
+  glBindBuffer(GL_UNIFORM_BUFFER, bufferID);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, static_cast<GLsizeiptr>(size), data);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+// Binding points of the std140 blocks shared by every program. GL 4.1 has no layout(binding)
+// qualifier, so Shader assigns these at link time by block name.
+constexpr unsigned int CAMERA_BLOCK_BINDING = 0;
+constexpr unsigned int LIGHTS_BLOCK_BINDING = 1;
+constexpr unsigned int GRID_BLOCK_BINDING = 2;
+constexpr unsigned int WELLS_BLOCK_BINDING = 3;
+
+// Lights past this many are ignored. They live in buffer textures, so this only bounds memory.
+constexpr int MAX_LIGHTS = 1024;
+// Must match the array size of the Wells block in well.vert.
+constexpr int MAX_WELL_BODIES = 32;
+
+struct UniformBlockBinding {
+  const char *name;
+  unsigned int binding;
+};
+
+inline constexpr UniformBlockBinding SHARED_UNIFORM_BLOCKS[] = {
+    {"Camera", CAMERA_BLOCK_BINDING},
+    {"Lights", LIGHTS_BLOCK_BINDING},
+    {"Grid", GRID_BLOCK_BINDING},
+    {"Wells", WELLS_BLOCK_BINDING},
+};
+
+// Texture units of the samplers shared by every program, assigned at link time by name in the
+// same way. Unit 0 is left to the textures of individual passes.
+constexpr int LIGHT_DATA_TEXTURE_UNIT = 1;
+constexpr int LIGHT_CLUSTERS_TEXTURE_UNIT = 2;
+constexpr int LIGHT_INDICES_TEXTURE_UNIT = 3;
+
+struct SharedSampler {
+  const char *name;
+  int unit;
+};
+
+inline constexpr SharedSampler SHARED_SAMPLERS[] = {
+    {"lightData", LIGHT_DATA_TEXTURE_UNIT},
+    {"lightClusters", LIGHT_CLUSTERS_TEXTURE_UNIT},
+    {"lightIndices", LIGHT_INDICES_TEXTURE_UNIT},
+};
+
+// std140 mirror of `uniform Camera`.
+struct CameraBlock {
+  glm::mat4 view;
+  glm::mat4 projection;
+  glm::vec4 viewPosition; // w unused
+  glm::vec4 depthRange;   // near plane, 1 / ln(far / near) for logarithmic depth, unused
+};
+
+// One light as stored in the lightData buffer texture, three RGBA32F texels each.
+struct LightData {
+  glm::vec4 position; // w = range, or 0 for a light that reaches everywhere
+  glm::vec4 color;    // a = intensity
+  glm::vec4 terms;    // ambient, diffuse, specular strength, shininess
+};
+
+// std140 mirror of `uniform Lights`. The lights and the per-cluster lists are in buffer
+// textures; this block says how a fragment finds its cluster.
+struct LightsBlock {
+  glm::vec4 clusterGrid;  // clusters in x, y and z, number of unbounded lights
+  glm::vec4 clusterDepth; // near distance, z slices per e-fold of distance, unused
+  glm::vec4 viewport;     // width and height in pixels, unused
+};
+
+// std140 mirror of `uniform Grid`, every setting of the procedural ground grid.
+struct GridBlock {
+  glm::mat4 inverseViewProjection;
+  glm::vec4 minorColor; // a = opacity
+  glm::vec4 majorColor; // a = cells per major line
+  glm::vec4 xAxisColor; // a = 1 when axis lines are shown
+  glm::vec4 zAxisColor;
+  glm::vec4 lines; // cell size, fade distance, minor width, major width (pixels)
+};
+
+// std140 mirror of `uniform Wells`: the masses the deformed grid sums directly, and where the
+// sampled potential texture lies for the rest.
+struct WellsBlock {
+  glm::vec4 bodies[MAX_WELL_BODIES]; // position, mass (G = 1)
+  glm::vec4 surface;                 // mesh center x and z, mesh half extent, depth scale
+  glm::vec4 field;                   // body count, softening, max depth, 1 when sampled
+  glm::vec4 region;                  // sampled center x and z, half extent, unused
+};
+
+static_assert(sizeof(CameraBlock) == 160, "CameraBlock must match the std140 layout");
+static_assert(sizeof(LightsBlock) == 48, "LightsBlock must match the std140 layout");
+static_assert(sizeof(GridBlock) == 144, "GridBlock must match the std140 layout");
+static_assert(sizeof(WellsBlock) == (16 * MAX_WELL_BODIES) + 48,
+              "WellsBlock must match the std140 layout");
+
+// Uniform buffer object permanently attached to one binding point.
+class UniformBuffer {
+public:
+  UniformBuffer(unsigned int binding, std::size_t size);
+  ~UniformBuffer();
+
+  UniformBuffer(const UniformBuffer &) = delete;
+  UniformBuffer &operator=(const UniformBuffer &) = delete;
+
+  void update(const void *data, std::size_t size) const;
+
+  template <typename Block> void update(const Block &block) const {
+    update(&block, sizeof(Block));
+  }
+
+private:
+  unsigned int bufferID = 0;
+};
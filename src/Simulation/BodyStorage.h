@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace sim {
+
+// Structure-of-arrays body state, so batch kernels can stream each component contiguously.
+struct BodyStorage {
+  std::vector<double> x, y, z;
+  std::vector<double> vx, vy, vz;
+  std::vector<double> mass;
+  std::vector<double> radius;
+
+  std::size_t size() const { return x.size(); }
+  bool empty() const { return x.empty(); }
+
+  void resize(std::size_t count) {
+    for (auto *component : {&x, &y, &z, &vx, &vy, &vz, &mass, &radius}) {
+      component->resize(count, 0.0);
+    }
+  }
+
+  void reserve(std::size_t count) {
+    for (auto *component : {&x, &y, &z, &vx, &vy, &vz, &mass, &radius}) {
+      component->reserve(count);
+    }
+  }
+
+  void clear() { resize(0); }
+
+  std::size_t add(const glm::dvec3 &position, const glm::dvec3 &velocity, double bodyMass,
+                  double bodyRadius) {
+    x.push_back(position.x);
+    y.push_back(position.y);
+    z.push_back(position.z);
+    vx.push_back(velocity.x);
+    vy.push_back(velocity.y);
+    vz.push_back(velocity.z);
+    mass.push_back(bodyMass);
+    radius.push_back(bodyRadius);
+    return size() - 1;
+  }
+
+  void append(const BodyStorage &other) {
+    x.insert(x.end(), other.x.begin(), other.x.end());
+    y.insert(y.end(), other.y.begin(), other.y.end());
+    z.insert(z.end(), other.z.begin(), other.z.end());
+    vx.insert(vx.end(), other.vx.begin(), other.vx.end());
+    vy.insert(vy.end(), other.vy.begin(), other.vy.end());
+    vz.insert(vz.end(), other.vz.begin(), other.vz.end());
+    mass.insert(mass.end(), other.mass.begin(), other.mass.end());
+    radius.insert(radius.end(), other.radius.begin(), other.radius.end());
+  }
+
+  glm::dvec3 position(std::size_t i) const { return {x[i], y[i], z[i]}; }
+  glm::dvec3 velocity(std::size_t i) const { return {vx[i], vy[i], vz[i]}; }
+
+  void setPosition(std::size_t i, const glm::dvec3 &p) {
+    x[i] = p.x;
+    y[i] = p.y;
+    z[i] = p.z;
+  }
+
+  void setVelocity(std::size_t i, const glm::dvec3 &v) {
+    vx[i] = v.x;
+    vy[i] = v.y;
+    vz[i] = v.z;
+  }
+};
+
+} // namespace sim
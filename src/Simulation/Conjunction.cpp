@@ -0,0 +1,343 @@
+#include "Simulation/Conjunction.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include "Simulation/Kepler.h"
+#include "core/thread_pool.h"
+
+namespace sim {
+
+namespace {
+
+constexpr std::size_t PROPAGATE_GRAIN = 1024;
+constexpr std::size_t HASH_GRAIN = 256;
+constexpr std::size_t REFINE_GRAIN = 64;
+
+// Boxes spanning more cells than this are tested against every box instead of being binned
+constexpr double MAX_BOX_CELLS = 512.0;
+constexpr int REFINE_ITERATIONS = 12;
+
+using CandidatePair = std::pair<std::uint32_t, std::uint32_t>;
+
+// Axis-aligned box around a body's motion over one sample interval, grown by half the threshold
+// so two boxes are disjoint only if the bodies stay at least a threshold apart.
+struct SweptBox {
+  double minX, maxX;
+  double minY, maxY;
+  double minZ, maxZ;
+};
+
+void sampleStates(const BodyStorage &initial, double time, double mu, BodyStorage &out,
+                  ThreadPool &pool) {
+  out.resize(initial.size());
+  pool.parallelFor(initial.size(), PROPAGATE_GRAIN, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      const OrbitState state =
+          propagateKepler({initial.position(i), initial.velocity(i)}, time, mu);
+      out.setPosition(i, state.position);
+      out.setVelocity(i, state.velocity);
+    }
+  });
+}
+
+void buildSweptBoxes(const BodyStorage &from, const BodyStorage &to, double step, double mu,
+                     double threshold, std::vector<SweptBox> &boxes, std::vector<double> &sags,
+                     ThreadPool &pool) {
+  boxes.resize(from.size());
+  sags.resize(from.size());
+  pool.parallelFor(from.size(), PROPAGATE_GRAIN, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      // The arc strays from its chord by at most |a| h^2 / 8; double it for safety.
+      const double r = std::min(glm::length(from.position(i)), glm::length(to.position(i)));
+      sags[i] = r > 0.0 ? (mu / (r * r)) * step * step * 0.25 : 0.0;
+      const double pad = (threshold * 0.5) + sags[i];
+      boxes[i] = {std::min(from.x[i], to.x[i]) - pad, std::max(from.x[i], to.x[i]) + pad,
+                  std::min(from.y[i], to.y[i]) - pad, std::max(from.y[i], to.y[i]) + pad,
+                  std::min(from.z[i], to.z[i]) - pad, std::max(from.z[i], to.z[i]) + pad};
+    }
+  });
+}
+
+// Closest distance between the chords of two bodies' motion over an interval, measured in the
+// relative frame. The true paths stay within their sags of the chords.
+bool chordsApproach(const BodyStorage &from, const BodyStorage &to,
+                    const std::vector<double> &sags, double threshold, std::uint32_t i,
+                    std::uint32_t j) {
+  const glm::dvec3 start = from.position(j) - from.position(i);
+  const glm::dvec3 delta = (to.position(j) - to.position(i)) - start;
+  const double delta2 = glm::dot(delta, delta);
+  const double s = delta2 > 0.0 ? std::clamp(-glm::dot(start, delta) / delta2, 0.0, 1.0) : 0.0;
+  return glm::length(start + (s * delta)) <= threshold + sags[i] + sags[j];
+}
+
+// Uniform grid cell key; 21 bits per axis, offset so negative coordinates stay positive. Only
+// indices in [-CELL_OFFSET, CELL_OFFSET) have a key of their own.
+constexpr std::int64_t CELL_OFFSET = std::int64_t{1} << 20;
+
+std::uint64_t cellKey(std::int64_t ix, std::int64_t iy, std::int64_t iz) {
+  return (static_cast<std::uint64_t>(ix + CELL_OFFSET) << 42) |
+         (static_cast<std::uint64_t>(iy + CELL_OFFSET) << 21) |
+         static_cast<std::uint64_t>(iz + CELL_OFFSET);
+}
+
+struct CellRange {
+  std::int64_t x0, x1;
+  std::int64_t y0, y1;
+  std::int64_t z0, z1;
+
+  // Whether every cell has a key and there are few enough of them to bin
+  bool isBinnable() const {
+    const auto keyed = [](std::int64_t low, std::int64_t high) {
+      return low >= -CELL_OFFSET && high < CELL_OFFSET;
+    };
+    const double cells = static_cast<double>(x1 - x0 + 1) * static_cast<double>(y1 - y0 + 1) *
+                         static_cast<double>(z1 - z0 + 1);
+    return keyed(x0, x1) && keyed(y0, y1) && keyed(z0, z1) && cells <= MAX_BOX_CELLS;
+  }
+  std::size_t count() const {
+    return static_cast<std::size_t>((x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1));
+  }
+};
+
+bool boxesOverlap(const SweptBox &a, const SweptBox &b) {
+  return a.minX <= b.maxX && b.minX <= a.maxX && a.minY <= b.maxY && b.minY <= a.maxY &&
+         a.minZ <= b.maxZ && b.minZ <= a.maxZ;
+}
+
+// Time-swept spatial hash: every swept box is binned into the grid cells it touches, and only
+// boxes sharing a cell are tested against each other. A pair is reported only from the cell
+// holding the low corner of the two boxes' overlap, so each pair appears once. Boxes too large
+// or too far out to bin are tested against every box instead. Overlapping pairs must also pass
+// `filter` to be kept.
+template <typename Filter>
+std::vector<CandidatePair> spatialHashPairs(const std::vector<SweptBox> &boxes, ThreadPool &pool,
+                                            const Filter &filter) {
+  // Size cells to the typical box so most bodies land in a handful of cells; the few large
+  // boxes (fast or close-in bodies) span more cells, up to MAX_BOX_CELLS.
+  std::vector<double> extents(boxes.size());
+  for (std::size_t i = 0; i < boxes.size(); ++i) {
+    const SweptBox &b = boxes[i];
+    extents[i] = std::max({b.maxX - b.minX, b.maxY - b.minY, b.maxZ - b.minZ});
+  }
+  const auto percentile = extents.begin() + static_cast<std::ptrdiff_t>(extents.size() * 9 / 10);
+  std::nth_element(extents.begin(), percentile, extents.end());
+  const double invCell = 1.0 / std::max(*percentile, 1.0e-12);
+
+  // Clamped just past the keyed range, so far-out boxes are caught without overflowing
+  const auto toCell = [invCell](double v) {
+    const auto limit = static_cast<double>(CELL_OFFSET);
+    return static_cast<std::int64_t>(std::clamp(std::floor(v * invCell), -limit - 1.0, limit));
+  };
+  const auto rangeOf = [&toCell](const SweptBox &b) {
+    return CellRange{toCell(b.minX), toCell(b.maxX), toCell(b.minY),
+                     toCell(b.maxY), toCell(b.minZ), toCell(b.maxZ)};
+  };
+
+  // Count, prefix-sum and fill the (cell, body) entries.
+  std::vector<std::size_t> offsets(boxes.size() + 1, 0);
+  std::vector<char> oversized(boxes.size(), 0);
+  pool.parallelFor(boxes.size(), PROPAGATE_GRAIN, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      const CellRange r = rangeOf(boxes[i]);
+      oversized[i] = r.isBinnable() ? 0 : 1;
+      offsets[i + 1] = oversized[i] != 0 ? 0 : r.count();
+    }
+  });
+  std::vector<std::uint32_t> unbinned;
+  for (std::size_t i = 0; i < boxes.size(); ++i) {
+    offsets[i + 1] += offsets[i];
+    if (oversized[i] != 0) {
+      unbinned.push_back(static_cast<std::uint32_t>(i));
+    }
+  }
+
+  std::vector<std::pair<std::uint64_t, std::uint32_t>> entries(offsets.back());
+  pool.parallelFor(boxes.size(), PROPAGATE_GRAIN, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      if (oversized[i] != 0) {
+        continue;
+      }
+      const CellRange r = rangeOf(boxes[i]);
+      std::size_t slot = offsets[i];
+      for (std::int64_t ix = r.x0; ix <= r.x1; ++ix) {
+        for (std::int64_t iy = r.y0; iy <= r.y1; ++iy) {
+          for (std::int64_t iz = r.z0; iz <= r.z1; ++iz) {
+            entries[slot++] = {cellKey(ix, iy, iz), static_cast<std::uint32_t>(i)};
+          }
+        }
+      }
+    }
+  });
+  std::sort(entries.begin(), entries.end());
+
+  std::vector<std::size_t> runs;
+  for (std::size_t e = 0; e < entries.size(); ++e) {
+    if (e == 0 || entries[e].first != entries[e - 1].first) {
+      runs.push_back(e);
+    }
+  }
+  runs.push_back(entries.size());
+
+  const std::size_t cellCount = runs.size() - 1;
+  const std::size_t chunks = (cellCount + HASH_GRAIN - 1) / HASH_GRAIN;
+  std::vector<std::vector<CandidatePair>> perChunk(chunks);
+  pool.parallelFor(cellCount, HASH_GRAIN, [&](std::size_t begin, std::size_t end) {
+    auto &found = perChunk[begin / HASH_GRAIN];
+    for (std::size_t cell = begin; cell < end; ++cell) {
+      const std::uint64_t key = entries[runs[cell]].first;
+      for (std::size_t p = runs[cell]; p < runs[cell + 1]; ++p) {
+        const SweptBox &a = boxes[entries[p].second];
+        for (std::size_t q = p + 1; q < runs[cell + 1]; ++q) {
+          const SweptBox &b = boxes[entries[q].second];
+          if (!boxesOverlap(a, b)) {
+            continue;
+          }
+          const std::uint64_t owner =
+              cellKey(toCell(std::max(a.minX, b.minX)), toCell(std::max(a.minY, b.minY)),
+                      toCell(std::max(a.minZ, b.minZ)));
+          const std::uint32_t i = std::min(entries[p].second, entries[q].second);
+          const std::uint32_t j = std::max(entries[p].second, entries[q].second);
+          if (owner == key && filter(i, j)) {
+            found.emplace_back(i, j);
+          }
+        }
+      }
+    }
+  });
+
+  // Unbinned boxes against all others; a pair of two of them comes from the lower index only
+  std::vector<std::vector<CandidatePair>> perUnbinned(unbinned.size());
+  pool.parallelFor(unbinned.size(), 1, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t u = begin; u < end; ++u) {
+      const std::uint32_t i = unbinned[u];
+      for (std::uint32_t j = 0; j < boxes.size(); ++j) {
+        if (j == i || (oversized[j] != 0 && j < i) || !boxesOverlap(boxes[i], boxes[j])) {
+          continue;
+        }
+        if (filter(std::min(i, j), std::max(i, j))) {
+          perUnbinned[u].emplace_back(std::min(i, j), std::max(i, j));
+        }
+      }
+    }
+  });
+
+  std::vector<CandidatePair> candidates;
+  for (auto &found : perChunk) {
+    candidates.insert(candidates.end(), found.begin(), found.end());
+  }
+  for (auto &found : perUnbinned) {
+    candidates.insert(candidates.end(), found.begin(), found.end());
+  }
+  return candidates;
+}
+
+// Newton iteration on d/dt |dr|^2 = 0 over [0, step] from the states at the interval start.
+// Returns false if the closest approach belongs to a neighbouring interval.
+bool refinePair(const OrbitState &first, const OrbitState &second, double step, double mu,
+                bool firstInterval, bool lastInterval, Conjunction &result) {
+  const auto relativeAt = [&](double t, glm::dvec3 &dr, glm::dvec3 &dv, glm::dvec3 &da) {
+    const OrbitState a = propagateKepler(first, t, mu);
+    const OrbitState b = propagateKepler(second, t, mu);
+    dr = b.position - a.position;
+    dv = b.velocity - a.velocity;
+    const double ra = glm::length(a.position);
+    const double rb = glm::length(b.position);
+    da = -mu * ((b.position / (rb * rb * rb)) - (a.position / (ra * ra * ra)));
+  };
+
+  // Start from the straight-line closest approach.
+  glm::dvec3 dr = second.position - first.position;
+  glm::dvec3 dv = second.velocity - first.velocity;
+  const double dv2 = glm::dot(dv, dv);
+  double t = dv2 > 0.0 ? std::clamp(-glm::dot(dr, dv) / dv2, 0.0, step) : 0.0;
+
+  glm::dvec3 da;
+  for (int i = 0; i < REFINE_ITERATIONS; ++i) {
+    relativeAt(t, dr, dv, da);
+    const double slope = glm::dot(dr, dv);
+    const double curvature = glm::dot(dv, dv) + glm::dot(dr, da);
+    if (curvature <= 0.0) {
+      break;
+    }
+    const double next = std::clamp(t - (slope / curvature), 0.0, step);
+    const bool done = std::abs(next - t) < 1.0e-10 * step;
+    t = next;
+    if (done) {
+      break;
+    }
+  }
+  relativeAt(t, dr, dv, da);
+
+  const double edge = 1.0e-9 * step;
+  if ((t <= edge && !firstInterval) || (t >= step - edge && !lastInterval)) {
+    return false;
+  }
+  result.time = t;
+  result.distance = glm::length(dr);
+  result.relativeSpeed = glm::length(dv);
+  return true;
+}
+
+} // namespace
+
+ConjunctionReport screenConjunctions(const BodyStorage &bodies, const ConjunctionSpec &spec,
+                                     ThreadPool &pool) {
+  ConjunctionReport report;
+  if (bodies.size() < 2 || spec.endTime <= spec.startTime || spec.sampleStep <= 0.0) {
+    return report;
+  }
+
+  const auto intervals =
+      static_cast<std::size_t>(std::ceil((spec.endTime - spec.startTime) / spec.sampleStep));
+  report.samples = intervals + 1;
+
+  BodyStorage current;
+  BodyStorage next;
+  std::vector<SweptBox> boxes;
+  std::vector<double> sags;
+  sampleStates(bodies, spec.startTime, spec.mu, current, pool);
+
+  for (std::size_t k = 0; k < intervals; ++k) {
+    const double start = spec.startTime + (static_cast<double>(k) * spec.sampleStep);
+    const double end = std::min(start + spec.sampleStep, spec.endTime);
+    const double step = end - start;
+    sampleStates(bodies, end, spec.mu, next, pool);
+
+    buildSweptBoxes(current, next, step, spec.mu, spec.threshold, boxes, sags, pool);
+    const std::vector<CandidatePair> candidates =
+        spatialHashPairs(boxes, pool, [&](std::uint32_t i, std::uint32_t j) {
+          return chordsApproach(current, next, sags, spec.threshold, i, j);
+        });
+    report.candidatePairs += candidates.size();
+
+    const std::size_t chunks = (candidates.size() + REFINE_GRAIN - 1) / REFINE_GRAIN;
+    std::vector<std::vector<Conjunction>> perChunk(chunks);
+    pool.parallelFor(candidates.size(), REFINE_GRAIN, [&](std::size_t begin, std::size_t stop) {
+      auto &found = perChunk[begin / REFINE_GRAIN];
+      for (std::size_t c = begin; c < stop; ++c) {
+        const auto [i, j] = candidates[c];
+        Conjunction conjunction;
+        if (refinePair({current.position(i), current.velocity(i)},
+                       {current.position(j), current.velocity(j)}, step, spec.mu, k == 0,
+                       k + 1 == intervals, conjunction) &&
+            conjunction.distance < spec.threshold) {
+          conjunction.first = i;
+          conjunction.second = j;
+          conjunction.time += start;
+          found.push_back(conjunction);
+        }
+      }
+    });
+    for (auto &found : perChunk) {
+      report.conjunctions.insert(report.conjunctions.end(), found.begin(), found.end());
+    }
+
+    std::swap(current, next);
+  }
+
+  std::sort(report.conjunctions.begin(), report.conjunctions.end(),
+            [](const Conjunction &a, const Conjunction &b) { return a.time < b.time; });
+  return report;
+}
+
+} // namespace sim
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Simulation/BodyStorage.h"
+
+class ThreadPool;
+
+namespace sim {
+
+struct ConjunctionSpec {
+  double mu = 1.0;
+  double startTime = 0.0;
+  double endTime = 10.0;
+  // Trajectories are sampled at this interval for the broad phase.
+  double sampleStep = 0.05;
+  // Report approaches closer than this distance.
+  double threshold = 0.05;
+};
+
+struct Conjunction {
+  std::uint32_t first = 0;
+  std::uint32_t second = 0;
+  double time = 0.0;
+  double distance = 0.0;
+  double relativeSpeed = 0.0;
+};
+
+struct ConjunctionReport {
+  std::vector<Conjunction> conjunctions;
+  // Pairs that survived the broad phase and were refined.
+  std::size_t candidatePairs = 0;
+  std::size_t samples = 0;
+};
+
+// Finds every pair of bodies that passes within spec.threshold during the time window. Each
+// sample interval is screened with a spatial hash over the bodies' swept bounding boxes and a
+// chord-distance test, then candidate pairs are refined to their time of closest approach on
+// the two-body trajectories.
+// Conjunctions are returned sorted by time.
+ConjunctionReport screenConjunctions(const BodyStorage &bodies, const ConjunctionSpec &spec,
+                                     ThreadPool &pool);
+
+} // namespace sim
@@ -0,0 +1,288 @@
+#include "Simulation/Ensemble.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include "core/thread_pool.h"
+
+namespace sim {
+
+namespace {
+using LaneArray = double[ENSEMBLE_MAX_BODIES][ENSEMBLE_LANES];
+
+// Positions, velocities, masses and radii
+constexpr std::size_t BLOCK_QUANTITIES = 8;
+} // namespace
+
+Ensemble::Ensemble(std::size_t bodyCount) : bodyCount(bodyCount) {
+  if (bodyCount == 0 || bodyCount > ENSEMBLE_MAX_BODIES) {
+    throw std::invalid_argument("Ensemble body count must be between 1 and " +
+                                std::to_string(ENSEMBLE_MAX_BODIES));
+  }
+}
+
+void Ensemble::addMember(const EnsembleSystem &system) {
+  if (system.getBodyCount() != bodyCount || system.positions.size() != bodyCount ||
+      system.velocities.size() != bodyCount || system.radii.size() != bodyCount) {
+    throw std::invalid_argument("Ensemble member does not match the ensemble body count");
+  }
+
+  const std::size_t blockValues = BLOCK_QUANTITIES * bodyCount * ENSEMBLE_LANES;
+  const std::size_t lane = memberCount % ENSEMBLE_LANES;
+  if (lane == 0) {
+    packed.resize(packed.size() + blockValues);
+  }
+  double *block = packed.data() + ((memberCount / ENSEMBLE_LANES) * blockValues) + lane;
+  const auto store = [block, this](std::size_t quantity, std::size_t body, double value) {
+    block[((quantity * bodyCount) + body) * ENSEMBLE_LANES] = value;
+  };
+  for (std::size_t i = 0; i < bodyCount; ++i) {
+    store(0, i, system.positions[i].x);
+    store(1, i, system.positions[i].y);
+    store(2, i, system.positions[i].z);
+    store(3, i, system.velocities[i].x);
+    store(4, i, system.velocities[i].y);
+    store(5, i, system.velocities[i].z);
+    store(6, i, system.masses[i]);
+    store(7, i, system.radii[i]);
+  }
+  ++memberCount;
+}
+
+std::size_t Ensemble::getMemberBytes(std::size_t bodyCount) {
+  return (BLOCK_QUANTITIES * bodyCount * sizeof(double)) + sizeof(EnsembleMemberResult);
+}
+
+void Ensemble::loadBlock(std::size_t index, Block &block) const {
+  const std::size_t blockValues = BLOCK_QUANTITIES * bodyCount * ENSEMBLE_LANES;
+  const double *source = packed.data() + (index * blockValues);
+  LaneArray *const quantities[BLOCK_QUANTITIES] = {
+      &block.px, &block.py, &block.pz, &block.vx, &block.vy, &block.vz, &block.mass, &block.radius};
+
+  // The unused lanes of the last block repeat its first member so that they stay numerically
+  // well-behaved; their results are never recorded.
+  const std::size_t used = std::min(ENSEMBLE_LANES, memberCount - (index * ENSEMBLE_LANES));
+  for (std::size_t q = 0; q < BLOCK_QUANTITIES; ++q) {
+    for (std::size_t i = 0; i < bodyCount; ++i) {
+      const double *row = source + (((q * bodyCount) + i) * ENSEMBLE_LANES);
+      for (std::size_t l = 0; l < ENSEMBLE_LANES; ++l) {
+        (*quantities[q])[i][l] = row[l < used ? l : 0];
+      }
+    }
+  }
+}
+
+void Ensemble::clear() {
+  packed.clear();
+  results.clear();
+  memberCount = 0;
+}
+
+void Ensemble::run(const EnsembleSettings &settings, ThreadPool &pool) {
+  results.assign(memberCount, EnsembleMemberResult{});
+  const std::size_t blockCount = (memberCount + ENSEMBLE_LANES - 1) / ENSEMBLE_LANES;
+  pool.parallelFor(blockCount, 1, [this, &settings](std::size_t begin, std::size_t end) {
+    Block block;
+    for (std::size_t b = begin; b < end; ++b) {
+      loadBlock(b, block);
+      integrateBlock(block, b * ENSEMBLE_LANES, settings);
+    }
+  });
+}
+
+void Ensemble::computeAccelerations(const Block &block, LaneArray &ax, LaneArray &ay,
+                                    LaneArray &az, double (&overlap)[ENSEMBLE_LANES],
+                                    double (&pair)[ENSEMBLE_LANES],
+                                    const EnsembleSettings &settings) const {
+  const double g = settings.gravitationalConstant;
+  const double eps2 = settings.softening * settings.softening;
+
+  for (std::size_t i = 0; i < bodyCount; ++i) {
+    std::fill(std::begin(ax[i]), std::end(ax[i]), 0.0);
+    std::fill(std::begin(ay[i]), std::end(ay[i]), 0.0);
+    std::fill(std::begin(az[i]), std::end(az[i]), 0.0);
+  }
+  std::fill(std::begin(overlap), std::end(overlap), 0.0);
+  std::fill(std::begin(pair), std::end(pair), 0.0);
+
+  for (std::size_t i = 0; i < bodyCount; ++i) {
+    for (std::size_t j = i + 1; j < bodyCount; ++j) {
+      const auto pairCode = static_cast<double>((i * ENSEMBLE_MAX_BODIES) + j);
+      for (std::size_t l = 0; l < ENSEMBLE_LANES; ++l) {
+        const double dx = block.px[j][l] - block.px[i][l];
+        const double dy = block.py[j][l] - block.py[i][l];
+        const double dz = block.pz[j][l] - block.pz[i][l];
+        const double d2 = (dx * dx) + (dy * dy) + (dz * dz);
+        const double r2 = d2 + eps2;
+        const double invR3 = g / (r2 * std::sqrt(r2));
+        const double si = block.mass[j][l] * invR3;
+        const double sj = block.mass[i][l] * invR3;
+        ax[i][l] += dx * si;
+        ay[i][l] += dy * si;
+        az[i][l] += dz * si;
+        ax[j][l] -= dx * sj;
+        ay[j][l] -= dy * sj;
+        az[j][l] -= dz * sj;
+
+        // Written as selects so the loop stays branch-free.
+        const double reach = block.radius[i][l] + block.radius[j][l];
+        const double depth = (reach * reach) - d2;
+        const bool deeper = depth > overlap[l];
+        overlap[l] = deeper ? depth : overlap[l];
+        pair[l] = deeper ? pairCode : pair[l];
+      }
+    }
+  }
+}
+
+void Ensemble::recordCollisions(const double (&overlap)[ENSEMBLE_LANES],
+                                const double (&pair)[ENSEMBLE_LANES], std::size_t firstMember,
+                                double time, bool (&finished)[ENSEMBLE_LANES]) {
+  for (std::size_t l = 0; l < ENSEMBLE_LANES; ++l) {
+    if (!finished[l] && overlap[l] > 0.0) {
+      const auto code = static_cast<int>(pair[l]);
+      const auto bodies = static_cast<int>(ENSEMBLE_MAX_BODIES);
+      results[firstMember + l] = {EnsembleOutcome::Collision, time, code / bodies, code % bodies};
+      finished[l] = true;
+    }
+  }
+}
+
+void Ensemble::checkEjections(const Block &block, std::size_t firstMember, double time,
+                              const EnsembleSettings &settings, bool (&finished)[ENSEMBLE_LANES]) {
+  // A body far from the centre of mass with positive energy relative to the rest is ejected.
+  double totalMass[ENSEMBLE_LANES] = {};
+  double cx[ENSEMBLE_LANES] = {};
+  double cy[ENSEMBLE_LANES] = {};
+  double cz[ENSEMBLE_LANES] = {};
+  double cvx[ENSEMBLE_LANES] = {};
+  double cvy[ENSEMBLE_LANES] = {};
+  double cvz[ENSEMBLE_LANES] = {};
+  for (std::size_t i = 0; i < bodyCount; ++i) {
+    for (std::size_t l = 0; l < ENSEMBLE_LANES; ++l) {
+      const double m = block.mass[i][l];
+      totalMass[l] += m;
+      cx[l] += m * block.px[i][l];
+      cy[l] += m * block.py[i][l];
+      cz[l] += m * block.pz[i][l];
+      cvx[l] += m * block.vx[i][l];
+      cvy[l] += m * block.vy[i][l];
+      cvz[l] += m * block.vz[i][l];
+    }
+  }
+  for (std::size_t l = 0; l < ENSEMBLE_LANES; ++l) {
+    const double invMass = totalMass[l] > 0.0 ? 1.0 / totalMass[l] : 0.0;
+    cx[l] *= invMass;
+    cy[l] *= invMass;
+    cz[l] *= invMass;
+    cvx[l] *= invMass;
+    cvy[l] *= invMass;
+    cvz[l] *= invMass;
+  }
+
+  const double ejection2 = settings.ejectionRadius * settings.ejectionRadius;
+  for (std::size_t i = 0; i < bodyCount; ++i) {
+    double energy[ENSEMBLE_LANES];
+    for (std::size_t l = 0; l < ENSEMBLE_LANES; ++l) {
+      const double dx = block.px[i][l] - cx[l];
+      const double dy = block.py[i][l] - cy[l];
+      const double dz = block.pz[i][l] - cz[l];
+      const double dvx = block.vx[i][l] - cvx[l];
+      const double dvy = block.vy[i][l] - cvy[l];
+      const double dvz = block.vz[i][l] - cvz[l];
+      const double r2 = (dx * dx) + (dy * dy) + (dz * dz);
+      const double v2 = (dvx * dvx) + (dvy * dvy) + (dvz * dvz);
+      const double specific = (0.5 * v2) - (settings.gravitationalConstant *
+                                            (totalMass[l] - block.mass[i][l]) / std::sqrt(r2));
+      // Only bodies outside the ejection radius can qualify.
+      energy[l] = r2 > ejection2 ? specific : -1.0;
+    }
+    for (std::size_t l = 0; l < ENSEMBLE_LANES; ++l) {
+      if (!finished[l] && energy[l] > 0.0) {
+        results[firstMember + l] = {EnsembleOutcome::Ejection, time, static_cast<int>(i), -1};
+        finished[l] = true;
+      }
+    }
+  }
+}
+
+void Ensemble::integrateBlock(Block &block, std::size_t firstMember,
+                              const EnsembleSettings &settings) {
+  bool finished[ENSEMBLE_LANES];
+  for (std::size_t l = 0; l < ENSEMBLE_LANES; ++l) {
+    finished[l] = firstMember + l >= memberCount;
+  }
+
+  alignas(64) LaneArray ax;
+  alignas(64) LaneArray ay;
+  alignas(64) LaneArray az;
+  double overlap[ENSEMBLE_LANES];
+  double pair[ENSEMBLE_LANES];
+  computeAccelerations(block, ax, ay, az, overlap, pair, settings);
+  recordCollisions(overlap, pair, firstMember, 0.0, finished);
+
+  const auto allFinished = [&finished] {
+    return std::all_of(std::begin(finished), std::end(finished), [](bool f) { return f; });
+  };
+
+  // Kick-drift-kick leapfrog; every lane keeps stepping after its event, it is simply ignored.
+  const double dt = settings.timeStep;
+  const double halfDt = 0.5 * dt;
+  const auto steps = static_cast<long long>(std::ceil(settings.endTime / dt));
+  const int checkInterval = std::max(settings.checkInterval, 1);
+  for (long long step = 1; step <= steps && !allFinished(); ++step) {
+    for (std::size_t i = 0; i < bodyCount; ++i) {
+      for (std::size_t l = 0; l < ENSEMBLE_LANES; ++l) {
+        block.vx[i][l] += ax[i][l] * halfDt;
+        block.vy[i][l] += ay[i][l] * halfDt;
+        block.vz[i][l] += az[i][l] * halfDt;
+        block.px[i][l] += block.vx[i][l] * dt;
+        block.py[i][l] += block.vy[i][l] * dt;
+        block.pz[i][l] += block.vz[i][l] * dt;
+      }
+    }
+
+    computeAccelerations(block, ax, ay, az, overlap, pair, settings);
+
+    for (std::size_t i = 0; i < bodyCount; ++i) {
+      for (std::size_t l = 0; l < ENSEMBLE_LANES; ++l) {
+        block.vx[i][l] += ax[i][l] * halfDt;
+        block.vy[i][l] += ay[i][l] * halfDt;
+        block.vz[i][l] += az[i][l] * halfDt;
+      }
+    }
+
+    const double time = static_cast<double>(step) * dt;
+    recordCollisions(overlap, pair, firstMember, time, finished);
+    if (step % checkInterval == 0 || step == steps) {
+      checkEjections(block, firstMember, time, settings, finished);
+    }
+  }
+
+  for (std::size_t l = 0; l < ENSEMBLE_LANES; ++l) {
+    if (!finished[l]) {
+      results[firstMember + l] = {EnsembleOutcome::Stable, settings.endTime, -1, -1};
+    }
+  }
+}
+
+EnsembleSystem Ensemble::perturb(const EnsembleSystem &base, double positionSigma,
+                                 double velocitySigma, std::uint64_t seed, std::uint64_t member) {
+  std::mt19937_64 rng(seed ^ (member * 0x9E3779B97F4A7C15ULL));
+  std::normal_distribution<double> noise(0.0, 1.0);
+  const auto jitter = [&rng, &noise](double sigma) {
+    return glm::dvec3(noise(rng), noise(rng), noise(rng)) * sigma;
+  };
+
+  EnsembleSystem system = base;
+  for (auto &position : system.positions) {
+    position += jitter(positionSigma);
+  }
+  for (auto &velocity : system.velocities) {
+    velocity += jitter(velocitySigma);
+  }
+  return system;
+}
+
+} // namespace sim
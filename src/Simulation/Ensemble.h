@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+class ThreadPool;
+
+namespace sim {
+
+// Number of ensemble members integrated side by side in one block. Each member occupies one
+// lane, so the innermost loops run over lanes and map directly onto SIMD registers.
+constexpr std::size_t ENSEMBLE_LANES = 8;
+constexpr std::size_t ENSEMBLE_MAX_BODIES = 10;
+
+enum class EnsembleOutcome : std::uint8_t { Stable, Ejection, Collision };
+
+// Initial conditions of a single small system.
+struct EnsembleSystem {
+  std::vector<glm::dvec3> positions;
+  std::vector<glm::dvec3> velocities;
+  std::vector<double> masses;
+  std::vector<double> radii;
+
+  std::size_t getBodyCount() const { return masses.size(); }
+};
+
+struct EnsembleSettings {
+  double gravitationalConstant = 1.0;
+  double timeStep = 1.0e-3;
+  double endTime = 100.0;
+  double softening = 1.0e-4;
+  // A body further than this from the system's centre of mass and on an unbound trajectory
+  // counts as ejected.
+  double ejectionRadius = 20.0;
+  // Ejection checks run every this many steps; collisions are checked on every step.
+  int checkInterval = 16;
+};
+
+struct EnsembleMemberResult {
+  EnsembleOutcome outcome = EnsembleOutcome::Stable;
+  // Time of the first ejection or collision, or the end time for stable members.
+  double stabilityTime = 0.0;
+  // Bodies involved in the event (bodyB is -1 for ejections).
+  int bodyA = -1;
+  int bodyB = -1;
+};
+
+// Many independent realisations of the same N-body setup, stored array-of-structures-of-arrays:
+// blocks of ENSEMBLE_LANES members, each block holding one array per quantity per body. Blocks
+// are packed to the ensemble's body count and unpacked into a full Block while integrated.
+class Ensemble {
+public:
+  explicit Ensemble(std::size_t bodyCount);
+
+  void addMember(const EnsembleSystem &system);
+  void clear();
+
+  std::size_t getBodyCount() const { return bodyCount; }
+  std::size_t getMemberCount() const { return memberCount; }
+
+  // Integrates every member to settings.endTime (or until its first event) and fills results.
+  void run(const EnsembleSettings &settings, ThreadPool &pool);
+
+  const std::vector<EnsembleMemberResult> &getResults() const { return results; }
+
+  // Memory one member takes, initial conditions and result, for sizing runs.
+  static std::size_t getMemberBytes(std::size_t bodyCount);
+
+  // Copy of `base` with Gaussian noise added to every position and velocity component.
+  static EnsembleSystem perturb(const EnsembleSystem &base, double positionSigma,
+                                double velocitySigma, std::uint64_t seed, std::uint64_t member);
+
+private:
+  // Working copy of one block, on the integrating thread's stack.
+  struct alignas(64) Block {
+    double px[ENSEMBLE_MAX_BODIES][ENSEMBLE_LANES];
+    double py[ENSEMBLE_MAX_BODIES][ENSEMBLE_LANES];
+    double pz[ENSEMBLE_MAX_BODIES][ENSEMBLE_LANES];
+    double vx[ENSEMBLE_MAX_BODIES][ENSEMBLE_LANES];
+    double vy[ENSEMBLE_MAX_BODIES][ENSEMBLE_LANES];
+    double vz[ENSEMBLE_MAX_BODIES][ENSEMBLE_LANES];
+    double mass[ENSEMBLE_MAX_BODIES][ENSEMBLE_LANES];
+    double radius[ENSEMBLE_MAX_BODIES][ENSEMBLE_LANES];
+  };
+
+  void loadBlock(std::size_t index, Block &block) const;
+  void integrateBlock(Block &block, std::size_t firstMember, const EnsembleSettings &settings);
+  // Also reports, per lane, the deepest overlap between two bodies and the pair involved, so
+  // collisions are caught on every step at no extra pair loop.
+  void computeAccelerations(const Block &block, double (&ax)[ENSEMBLE_MAX_BODIES][ENSEMBLE_LANES],
+                            double (&ay)[ENSEMBLE_MAX_BODIES][ENSEMBLE_LANES],
+                            double (&az)[ENSEMBLE_MAX_BODIES][ENSEMBLE_LANES],
+                            double (&overlap)[ENSEMBLE_LANES], double (&pair)[ENSEMBLE_LANES],
+                            const EnsembleSettings &settings) const;
+  void recordCollisions(const double (&overlap)[ENSEMBLE_LANES],
+                        const double (&pair)[ENSEMBLE_LANES], std::size_t firstMember, double time,
+                        bool (&finished)[ENSEMBLE_LANES]);
+  void checkEjections(const Block &block, std::size_t firstMember, double time,
+                      const EnsembleSettings &settings, bool (&finished)[ENSEMBLE_LANES]);
+
+  std::size_t bodyCount;
+  std::size_t memberCount = 0;
+  // Per block, each quantity for each body as ENSEMBLE_LANES consecutive values
+  std::vector<double> packed;
+  std::vector<EnsembleMemberResult> results;
+};
+
+} // namespace sim
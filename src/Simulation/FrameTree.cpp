@@ -0,0 +1,209 @@
+#include "Simulation/FrameTree.h"
+#include <algorithm>
+#include "Simulation/Kepler.h"
+
+namespace sim {
+
+namespace {
+
+constexpr std::uint32_t NO_SLOT = std::numeric_limits<std::uint32_t>::max();
+
+} // namespace
+
+FrameTree::NodeId FrameTree::add(const glm::dvec3 &position, const glm::dquat &orientation) {
+  const auto id = static_cast<NodeId>(slotOf.size());
+  const auto slot = static_cast<std::uint32_t>(nodes.size());
+  // A new root goes last, which keeps the depth-first order intact.
+  nodes.push_back({id, NO_PARENT, FrameType::Barycentric, slot + 1, position, orientation,
+                   position, orientation});
+  slotOf.push_back(slot);
+  return id;
+}
+
+void FrameTree::remove(NodeId id) {
+  const NodeId parent = getParent(id);
+  for (const auto &node : std::vector<Node>(nodes)) {
+    if (node.parent == id) {
+      setParent(node.id, parent, node.type);
+    }
+  }
+  nodes.erase(nodes.begin() + slotOf[id]);
+  slotOf[id] = NO_SLOT;
+  // Slots after the removed one have shifted, so restore the lookup right away.
+  rebuild();
+}
+
+void FrameTree::clear() {
+  nodes.clear();
+  slotOf.clear();
+  dirtyNodes.clear();
+  structureChanged = false;
+}
+
+bool FrameTree::isDescendant(NodeId id, NodeId ancestor) const {
+  for (NodeId node = getParent(id); node != NO_PARENT; node = getParent(node)) {
+    if (node == ancestor) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool FrameTree::setParent(NodeId id, NodeId parent, FrameType type) {
+  if (parent != NO_PARENT && (parent == id || isDescendant(parent, id))) {
+    return false;
+  }
+
+  Node &node = nodes[slotOf[id]];
+  const Frame oldFrame = parentFrame(node);
+  const glm::dvec3 worldPosition = oldFrame.origin + (oldFrame.rotation * node.localPosition);
+  const glm::dquat worldOrientation = oldFrame.rotation * node.localOrientation;
+
+  node.parent = parent;
+  node.type = type;
+  const Frame newFrame = parentFrame(node);
+  const glm::dquat inverse = glm::conjugate(newFrame.rotation);
+  node.localPosition = inverse * (worldPosition - newFrame.origin);
+  node.localOrientation = inverse * worldOrientation;
+
+  structureChanged = true;
+  markDirty(id);
+  return true;
+}
+
+void FrameTree::setLocalPosition(NodeId id, const glm::dvec3 &position) {
+  nodes[slotOf[id]].localPosition = position;
+  markDirty(id);
+}
+
+void FrameTree::setLocalOrientation(NodeId id, const glm::dquat &orientation) {
+  nodes[slotOf[id]].localOrientation = orientation;
+  markDirty(id);
+}
+
+void FrameTree::setWorldPosition(NodeId id, const glm::dvec3 &position) {
+  Node &node = nodes[slotOf[id]];
+  const Frame frame = parentFrame(node);
+  node.localPosition = glm::conjugate(frame.rotation) * (position - frame.origin);
+  markDirty(id);
+}
+
+void FrameTree::setWorldOrientation(NodeId id, const glm::dquat &orientation) {
+  Node &node = nodes[slotOf[id]];
+  node.localOrientation = glm::conjugate(parentFrame(node).rotation) * orientation;
+  markDirty(id);
+}
+
+FrameTree::Frame FrameTree::parentFrame(const Node &node) const {
+  if (node.parent == NO_PARENT) {
+    return {glm::dvec3(0.0), glm::dquat(1, 0, 0, 0)};
+  }
+  const Node &parent = nodes[slotOf[node.parent]];
+
+  switch (node.type) {
+  case FrameType::Barycentric:
+    break;
+  case FrameType::BodyFixed:
+    return {parent.worldPosition, parent.worldOrientation};
+  case FrameType::Rotating: {
+    // Roots orbit the central mass at the origin.
+    const glm::dvec3 primary = parent.parent == NO_PARENT
+                                   ? glm::dvec3(0.0)
+                                   : nodes[slotOf[parent.parent]].worldPosition;
+    glm::dvec3 radial = parent.worldPosition - primary;
+    radial -= glm::dot(radial, SCENE_UP) * SCENE_UP;
+    const double length = glm::length(radial);
+    if (length <= 0.0) {
+      break;
+    }
+    const glm::dvec3 x = radial / length;
+    const glm::dmat3 axes(x, SCENE_UP, glm::cross(x, SCENE_UP));
+    return {parent.worldPosition, glm::quat_cast(axes)};
+  }
+  }
+  return {parent.worldPosition, glm::dquat(1, 0, 0, 0)};
+}
+
+void FrameTree::markDirty(NodeId id) { dirtyNodes.push_back(id); }
+
+const std::vector<FrameTree::NodeId> &FrameTree::update() {
+  updated.clear();
+  if (structureChanged) {
+    rebuild();
+  }
+
+  dirtySlots.clear();
+  for (const NodeId id : dirtyNodes) {
+    if (id < slotOf.size() && slotOf[id] != NO_SLOT) {
+      dirtySlots.push_back(slotOf[id]);
+    }
+  }
+  dirtyNodes.clear();
+  std::sort(dirtySlots.begin(), dirtySlots.end());
+
+  // Each dirty node's subtree is the slot range that follows it, and parents come first, so
+  // one forward pass over those ranges sees every parent already up to date.
+  std::uint32_t covered = 0;
+  for (const std::uint32_t first : dirtySlots) {
+    if (first < covered) {
+      continue;
+    }
+    const std::uint32_t end = nodes[first].subtreeEnd;
+    for (std::uint32_t slot = first; slot < end; ++slot) {
+      Node &node = nodes[slot];
+      const Frame frame = parentFrame(node);
+      node.worldPosition = frame.origin + (frame.rotation * node.localPosition);
+      node.worldOrientation = frame.rotation * node.localOrientation;
+      updated.push_back(node.id);
+    }
+    covered = end;
+  }
+  return updated;
+}
+
+void FrameTree::rebuild() {
+  structureChanged = false;
+  std::vector<Node> previous = std::move(nodes);
+  nodes.clear();
+  nodes.reserve(previous.size());
+
+  std::vector<std::uint32_t> previousSlot(slotOf.size(), NO_SLOT);
+  for (std::uint32_t i = 0; i < previous.size(); ++i) {
+    previousSlot[previous[i].id] = i;
+  }
+  std::vector<std::vector<std::uint32_t>> children(previous.size());
+  std::vector<std::uint32_t> stack;
+  for (std::uint32_t i = previous.size(); i-- > 0;) {
+    if (previous[i].parent == NO_PARENT) {
+      stack.push_back(i);
+    } else {
+      children[previousSlot[previous[i].parent]].push_back(i);
+    }
+  }
+
+  // Depth-first preorder, keeping siblings in their previous relative order (both lists above
+  // are filled back to front, so the first sibling ends up on top of the stack).
+  std::fill(slotOf.begin(), slotOf.end(), NO_SLOT);
+  while (!stack.empty()) {
+    const std::uint32_t i = stack.back();
+    stack.pop_back();
+    slotOf[previous[i].id] = static_cast<std::uint32_t>(nodes.size());
+    nodes.push_back(previous[i]);
+    stack.insert(stack.end(), children[i].begin(), children[i].end());
+  }
+
+  // Subtree sizes, accumulated from the leaves up.
+  for (auto &node : nodes) {
+    node.subtreeEnd = 1;
+  }
+  for (std::uint32_t slot = nodes.size(); slot-- > 0;) {
+    if (nodes[slot].parent != NO_PARENT) {
+      nodes[slotOf[nodes[slot].parent]].subtreeEnd += nodes[slot].subtreeEnd;
+    }
+  }
+  for (std::uint32_t slot = 0; slot < nodes.size(); ++slot) {
+    nodes[slot].subtreeEnd += slot;
+  }
+}
+
+} // namespace sim
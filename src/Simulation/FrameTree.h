@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <limits>
+#include <vector>
+
+namespace sim {
+
+// How a child's local coordinates relate to its parent.
+enum class FrameType : std::uint8_t {
+  // Centered on the parent with fixed axes (a moon's offset from its planet).
+  Barycentric,
+  // Centered on the parent and turning with its orientation (a lander on a rotating planet).
+  BodyFixed,
+  // Centered on the parent, with +X pointing away from the grandparent in the plane
+  // perpendicular to SCENE_UP (the synodic frame; a craft parked at a Lagrange point).
+  Rotating,
+};
+
+// Hierarchy of reference frames (planet -> moon -> spacecraft) in double precision. Nodes are
+// stored flattened in depth-first order, so each subtree is one contiguous slot range and every
+// parent precedes its children. update() recomputes world transforms only for the subtrees of
+// nodes changed since the last call, in a single forward pass over those ranges.
+class FrameTree {
+public:
+  using NodeId = std::uint32_t;
+  static constexpr NodeId NO_PARENT = std::numeric_limits<NodeId>::max();
+
+  // New root node. Ids stay valid until the node is removed.
+  NodeId add(const glm::dvec3 &position, const glm::dquat &orientation = glm::dquat(1, 0, 0, 0));
+  // Children are handed to the removed node's parent, keeping their world transforms.
+  void remove(NodeId id);
+  void clear();
+
+  // Moves the node under `parent` (or to the root with NO_PARENT), re-expressing it in the new
+  // frame so its world transform is unchanged. Fails if `parent` is the node or a descendant.
+  bool setParent(NodeId id, NodeId parent, FrameType type);
+  NodeId getParent(NodeId id) const { return nodes[slotOf[id]].parent; }
+  FrameType getFrameType(NodeId id) const { return nodes[slotOf[id]].type; }
+  bool isDescendant(NodeId id, NodeId ancestor) const;
+
+  void setLocalPosition(NodeId id, const glm::dvec3 &position);
+  void setLocalOrientation(NodeId id, const glm::dquat &orientation);
+  const glm::dvec3 &getLocalPosition(NodeId id) const { return nodes[slotOf[id]].localPosition; }
+  const glm::dquat &getLocalOrientation(NodeId id) const {
+    return nodes[slotOf[id]].localOrientation;
+  }
+
+  // World-space edits, converted through the parent's transform as of the last update().
+  void setWorldPosition(NodeId id, const glm::dvec3 &position);
+  void setWorldOrientation(NodeId id, const glm::dquat &orientation);
+  const glm::dvec3 &getWorldPosition(NodeId id) const { return nodes[slotOf[id]].worldPosition; }
+  const glm::dquat &getWorldOrientation(NodeId id) const {
+    return nodes[slotOf[id]].worldOrientation;
+  }
+
+  // Propagates pending changes and returns the ids whose world transform was recomputed.
+  const std::vector<NodeId> &update();
+
+  std::size_t size() const { return nodes.size(); }
+
+private:
+  struct Node {
+    NodeId id;
+    NodeId parent;
+    FrameType type;
+    std::uint32_t subtreeEnd; // one past the node's last descendant
+    glm::dvec3 localPosition;
+    glm::dquat localOrientation;
+    glm::dvec3 worldPosition;
+    glm::dquat worldOrientation;
+  };
+
+  struct Frame {
+    glm::dvec3 origin;
+    glm::dquat rotation;
+  };
+
+  Frame parentFrame(const Node &node) const;
+  void markDirty(NodeId id);
+  void rebuild();
+
+  std::vector<Node> nodes;           // depth-first order
+  std::vector<std::uint32_t> slotOf; // by id
+  std::vector<NodeId> dirtyNodes;
+  std::vector<std::uint32_t> dirtySlots;
+  std::vector<NodeId> updated;
+  bool structureChanged = false;
+};
+
+} // namespace sim
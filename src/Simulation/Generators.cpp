@@ -0,0 +1,314 @@
+#include "Simulation/Generators.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
+#include "Simulation/OrbitalElements.h"
+#include "Simulation/Philox.h"
+#include "core/thread_pool.h"
+
+namespace sim {
+
+namespace {
+
+constexpr std::size_t GRAIN = 4096;
+constexpr double TWO_PI = 2.0 * std::numbers::pi;
+// Plummer spheres have no edge; drop the outermost 0.1% of the mass instead of placing a few
+// bodies at absurd distances.
+constexpr double PLUMMER_MASS_CUTOFF = 0.999;
+constexpr int MAX_REJECTIONS = 256;
+
+struct GeneratedBody {
+  glm::dvec3 position{0.0};
+  glm::dvec3 velocity{0.0};
+  double mass = 0.0;
+  double radius = 0.0;
+};
+
+glm::dvec3 isotropicDirection(PhiloxStream &rng) {
+  const double cosTheta = rng.uniform(-1.0, 1.0);
+  const double sinTheta = std::sqrt(1.0 - (cosTheta * cosTheta));
+  const double phi = TWO_PI * rng.uniform();
+  return {sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta};
+}
+
+glm::dvec3 gaussianVector(PhiloxStream &rng) { return {rng.normal(), rng.normal(), rng.normal()}; }
+
+double rayleigh(PhiloxStream &rng, double scale) {
+  return scale * std::sqrt(-2.0 * std::log(rng.uniform()));
+}
+
+double bodyCount(const GeneratorSpec &spec) {
+  return static_cast<double>(std::max<std::size_t>(spec.count, 1));
+}
+
+// Resizes `out` once, then fills the new tail in parallel. Bodies are written in place, so no
+// thread ever touches another's slice.
+template <typename Sample>
+void generate(const GeneratorSpec &spec, BodyStorage &out, ThreadPool &pool,
+              const Sample &sample) {
+  const std::size_t offset = out.size();
+  out.resize(offset + spec.count);
+  pool.parallelFor(spec.count, GRAIN, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t k = begin; k < end; ++k) {
+      PhiloxStream rng(spec.seed, k);
+      const GeneratedBody body = sample(rng);
+      const std::size_t i = offset + k;
+      out.setPosition(i, spec.center + body.position);
+      out.setVelocity(i, spec.velocity + body.velocity);
+      out.mass[i] = body.mass;
+      out.radius[i] = body.radius;
+    }
+  });
+}
+
+// Tabulated King model in units of the core radius: potential W and enclosed mass against
+// radius, out to the tidal radius where W reaches zero.
+struct KingProfile {
+  std::vector<double> radius;
+  std::vector<double> potential;
+  std::vector<double> mass;
+};
+
+double kingDensity(double w) {
+  if (w <= 0.0) {
+    return 0.0;
+  }
+  return (std::exp(w) * std::erf(std::sqrt(w))) -
+         (std::sqrt(4.0 * w / std::numbers::pi) * (1.0 + (2.0 * w / 3.0)));
+}
+
+KingProfile buildKingProfile(double w0) {
+  const double centralDensity = kingDensity(w0);
+  // Poisson's equation in ln(r): state is (W, dW/dr, m) with m' = r^2 rho / rho0.
+  struct Step {
+    double w, slope, mass;
+  };
+  const auto derivative = [&](double r, const Step &s) {
+    const double density = kingDensity(s.w) / centralDensity;
+    return Step{r * s.slope, r * ((-2.0 * s.slope / r) - (9.0 * density)), r * r * r * density};
+  };
+
+  KingProfile profile;
+  double r = 1.0e-4;
+  Step state{w0 - (1.5 * r * r), -3.0 * r, r * r * r / 3.0}; // series solution near the centre
+  profile.radius.push_back(0.0);
+  profile.potential.push_back(w0);
+  profile.mass.push_back(0.0);
+
+  constexpr double LOG_STEP = 2.0e-3;
+  while (state.w > 0.0 && r < 1.0e4) {
+    const auto advance = [](const Step &s, const Step &d, double h) {
+      return Step{s.w + (h * d.w), s.slope + (h * d.slope), s.mass + (h * d.mass)};
+    };
+    const double rMid = r * std::exp(0.5 * LOG_STEP);
+    const double rNext = r * std::exp(LOG_STEP);
+    const Step k1 = derivative(r, state);
+    const Step k2 = derivative(rMid, advance(state, k1, 0.5 * LOG_STEP));
+    const Step k3 = derivative(rMid, advance(state, k2, 0.5 * LOG_STEP));
+    const Step k4 = derivative(rNext, advance(state, k3, LOG_STEP));
+    const Step slope{(k1.w + (2.0 * k2.w) + (2.0 * k3.w) + k4.w) / 6.0,
+                     (k1.slope + (2.0 * k2.slope) + (2.0 * k3.slope) + k4.slope) / 6.0,
+                     (k1.mass + (2.0 * k2.mass) + (2.0 * k3.mass) + k4.mass) / 6.0};
+    const Step next = advance(state, slope, LOG_STEP);
+
+    if (next.w <= 0.0) {
+      // Interpolate the tidal radius where the potential crosses zero.
+      const double t = state.w / (state.w - next.w);
+      profile.radius.push_back(r + (t * (rNext - r)));
+      profile.potential.push_back(0.0);
+      profile.mass.push_back(state.mass + (t * (next.mass - state.mass)));
+      break;
+    }
+    state = next;
+    r = rNext;
+    profile.radius.push_back(r);
+    profile.potential.push_back(state.w);
+    profile.mass.push_back(state.mass);
+  }
+  return profile;
+}
+
+// Inverts the tabulated enclosed mass: returns the radius and potential at mass fraction u.
+std::pair<double, double> sampleKingRadius(const KingProfile &profile, double u) {
+  const double target = u * profile.mass.back();
+  const auto upper = std::upper_bound(profile.mass.begin(), profile.mass.end(), target);
+  const std::size_t hi =
+      std::clamp<std::size_t>(upper - profile.mass.begin(), 1, profile.mass.size() - 1);
+  const std::size_t lo = hi - 1;
+  const double span = profile.mass[hi] - profile.mass[lo];
+  const double t = span > 0.0 ? (target - profile.mass[lo]) / span : 0.0;
+  return {profile.radius[lo] + (t * (profile.radius[hi] - profile.radius[lo])),
+          profile.potential[lo] + (t * (profile.potential[hi] - profile.potential[lo]))};
+}
+
+// Enclosed-mass fraction of an exponential disk at x scale lengths.
+double diskMassFraction(double x) { return 1.0 - ((1.0 + x) * std::exp(-x)); }
+
+} // namespace
+
+void generatePlummer(const PlummerSpec &spec, BodyStorage &out, ThreadPool &pool) {
+  const double a = spec.scaleRadius;
+  const double escapeScale = std::sqrt(2.0 * spec.totalMass / a);
+  const double bodyMass = spec.totalMass / bodyCount(spec);
+
+  generate(spec, out, pool, [&](PhiloxStream &rng) {
+    const double massFraction = PLUMMER_MASS_CUTOFF * rng.uniform();
+    const double r = a / std::sqrt((1.0 / std::cbrt(massFraction * massFraction)) - 1.0);
+
+    // Speed as a fraction q of the local escape speed, from g(q) = q^2 (1 - q^2)^3.5 whose
+    // maximum is just under 0.1.
+    double q = 0.0;
+    for (int attempt = 0; attempt < MAX_REJECTIONS; ++attempt) {
+      q = rng.uniform();
+      const double y = 1.0 - (q * q);
+      if (0.1 * rng.uniform() < q * q * y * y * y * std::sqrt(y)) {
+        break;
+      }
+    }
+    const double speed = q * escapeScale / std::sqrt(std::sqrt(1.0 + (r * r / (a * a))));
+
+    GeneratedBody body;
+    body.position = isotropicDirection(rng) * r;
+    body.velocity = isotropicDirection(rng) * speed;
+    body.mass = bodyMass;
+    body.radius = spec.bodyRadius;
+    return body;
+  });
+}
+
+void generateKing(const KingSpec &spec, BodyStorage &out, ThreadPool &pool) {
+  const KingProfile profile = buildKingProfile(spec.centralPotential);
+  // Velocity scale from M = 4 pi rho0 r0^3 m and r0^2 = 9 sigma^2 / (4 pi G rho0).
+  const double sigma =
+      std::sqrt(spec.totalMass / (9.0 * spec.coreRadius * profile.mass.back()));
+  const double bodyMass = spec.totalMass / bodyCount(spec);
+
+  generate(spec, out, pool, [&](PhiloxStream &rng) {
+    const auto [r, w] = sampleKingRadius(profile, rng.uniform());
+
+    // Speed x = v / sigma from the lowered Maxwellian x^2 (exp(W - x^2 / 2) - 1) on
+    // [0, sqrt(2W)], by rejection against a constant envelope.
+    const double xMax = std::sqrt(2.0 * w);
+    const double envelope = std::min(2.0 * std::exp(w - 1.0), 2.0 * w * std::expm1(w));
+    double x = 0.0;
+    for (int attempt = 0; attempt < MAX_REJECTIONS; ++attempt) {
+      x = xMax * rng.uniform();
+      if (envelope * rng.uniform() < x * x * std::expm1(w - (0.5 * x * x))) {
+        break;
+      }
+    }
+
+    GeneratedBody body;
+    body.position = isotropicDirection(rng) * (r * spec.coreRadius);
+    body.velocity = isotropicDirection(rng) * (x * sigma);
+    body.mass = bodyMass;
+    body.radius = spec.bodyRadius;
+    return body;
+  });
+}
+
+void generateExponentialDisk(const ExponentialDiskSpec &spec, BodyStorage &out,
+                             ThreadPool &pool) {
+  // Tabulate the radial mass fraction once; each body inverts it by table lookup plus two
+  // Newton steps.
+  constexpr std::size_t TABLE_SIZE = 1024;
+  const double xMax = spec.outerRadius;
+  const double totalFraction = diskMassFraction(xMax);
+  std::vector<double> table(TABLE_SIZE + 1);
+  for (std::size_t j = 0; j <= TABLE_SIZE; ++j) {
+    table[j] = diskMassFraction(xMax * static_cast<double>(j) / TABLE_SIZE);
+  }
+  const double bodyMass = spec.diskMass / bodyCount(spec);
+
+  generate(spec, out, pool, [&](PhiloxStream &rng) {
+    const double target = rng.uniform() * totalFraction;
+    const auto upper = std::upper_bound(table.begin(), table.end(), target);
+    const std::size_t hi = std::clamp<std::size_t>(upper - table.begin(), 1, TABLE_SIZE);
+    const double t = (target - table[hi - 1]) / (table[hi] - table[hi - 1]);
+    double x = xMax * (static_cast<double>(hi - 1) + t) / TABLE_SIZE;
+    for (int iteration = 0; iteration < 2; ++iteration) {
+      const double slope = x * std::exp(-x);
+      if (slope > 0.0) {
+        x = std::clamp(x - ((diskMassFraction(x) - target) / slope), 0.0, xMax);
+      }
+    }
+
+    const double radius = std::max(x * spec.scaleLength, 1.0e-9);
+    const double height = spec.scaleHeight * std::atanh((2.0 * rng.uniform()) - 1.0);
+    const double phi = TWO_PI * rng.uniform();
+    const double enclosed = spec.diskMass * diskMassFraction(x) / totalFraction;
+    const double circular = std::sqrt((spec.centralMu + enclosed) / radius);
+
+    // Prograde about SCENE_UP: at phi = 0 the body sits on +X and moves towards -Z.
+    GeneratedBody body;
+    body.position = {radius * std::cos(phi), height, -radius * std::sin(phi)};
+    body.velocity = glm::dvec3(-std::sin(phi), 0.0, -std::cos(phi)) * circular +
+                    gaussianVector(rng) * (spec.velocityDispersion * circular);
+    body.mass = bodyMass;
+    body.radius = spec.bodyRadius;
+    return body;
+  });
+}
+
+void generateKeplerianRing(const KeplerianRingSpec &spec, BodyStorage &out, ThreadPool &pool) {
+  const double inner2 = spec.innerRadius * spec.innerRadius;
+  const double outer2 = spec.outerRadius * spec.outerRadius;
+  const double bodyMass = spec.totalMass / bodyCount(spec);
+
+  generate(spec, out, pool, [&](PhiloxStream &rng) {
+    // Uniform surface density between the edges.
+    const double a = std::sqrt(rng.uniform(inner2, outer2));
+    const double e = std::min(rayleigh(rng, spec.eccentricityScale), 0.99);
+    const double inclination = rayleigh(rng, spec.inclinationScale);
+    const double node = TWO_PI * rng.uniform();
+    const double periapsis = TWO_PI * rng.uniform();
+
+    // Uniform in mean anomaly so bodies are spread evenly in time along their orbits.
+    const double meanAnomaly = TWO_PI * rng.uniform();
+    double eccentricAnomaly = meanAnomaly + (e * std::sin(meanAnomaly));
+    for (int iteration = 0; iteration < 6; ++iteration) {
+      eccentricAnomaly -= (eccentricAnomaly - (e * std::sin(eccentricAnomaly)) - meanAnomaly) /
+                          (1.0 - (e * std::cos(eccentricAnomaly)));
+    }
+    const double trueAnomaly =
+        2.0 * std::atan2(std::sqrt(1.0 + e) * std::sin(0.5 * eccentricAnomaly),
+                         std::sqrt(1.0 - e) * std::cos(0.5 * eccentricAnomaly));
+
+    const OrbitState state =
+        keplerianToState(a, e, inclination, node, periapsis, trueAnomaly, spec.hostMu);
+    return GeneratedBody{state.position, state.velocity, bodyMass, spec.bodyRadius};
+  });
+}
+
+void generateDebrisCloud(const DebrisCloudSpec &spec, BodyStorage &out, ThreadPool &pool) {
+  // Masses are drawn relative to the largest fragment, then scaled so the expected total equals
+  // the parent mass.
+  const double b = spec.massExponent;
+  const double minMass = 1.0 / spec.massRange;
+  const double tailMin = std::pow(minMass, -b);
+  const double tailSpan = tailMin - 1.0;
+  const double meanMass = std::abs(b - 1.0) < 1.0e-9
+                              ? std::log(spec.massRange) / tailSpan
+                              : b / (1.0 - b) * (1.0 - std::pow(minMass, 1.0 - b)) / tailSpan;
+  const double count = bodyCount(spec);
+  const double massScale = spec.parentMass / (count * meanMass);
+  // Fragments start inside a sphere of roughly the parent's volume.
+  const double parentRadius = spec.bodyRadius * std::cbrt(count);
+
+  generate(spec, out, pool, [&](PhiloxStream &rng) {
+    const double relativeMass = std::pow(tailMin - (rng.uniform() * tailSpan), -1.0 / b);
+    const double speed = spec.deltaV * std::pow(relativeMass, -spec.velocityExponent) *
+                         std::exp(spec.deltaVSpread * rng.normal());
+    const glm::dvec3 direction = isotropicDirection(rng);
+
+    GeneratedBody body;
+    body.position = direction * (parentRadius * std::cbrt(rng.uniform()));
+    body.velocity = direction * speed;
+    body.mass = relativeMass * massScale;
+    body.radius = spec.bodyRadius * std::cbrt(relativeMass / meanMass);
+    return body;
+  });
+}
+
+} // namespace sim
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "Simulation/BodyStorage.h"
+
+class ThreadPool;
+
+namespace sim {
+
+// Settings shared by every generator. Positions and velocities are relative to `center` and
+// `velocity`; masses are in units where G = 1, so a body's mass is also its gravitational
+// parameter.
+struct GeneratorSpec {
+  std::size_t count = 10000;
+  std::uint64_t seed = 1;
+  glm::dvec3 center{0.0};
+  glm::dvec3 velocity{0.0};
+  double bodyRadius = 0.005;
+};
+
+// Plummer sphere in virial equilibrium (Aarseth, Henon & Wielen 1974).
+struct PlummerSpec : GeneratorSpec {
+  double totalMass = 1.0;
+  double scaleRadius = 1.0;
+};
+
+// King (1966) lowered isothermal cluster. `centralPotential` is the dimensionless depth W0;
+// larger values give more concentrated clusters.
+struct KingSpec : GeneratorSpec {
+  double totalMass = 1.0;
+  double coreRadius = 0.5;
+  double centralPotential = 6.0;
+};
+
+// Thin exponential disk in the plane perpendicular to SCENE_UP, on near-circular prograde
+// orbits about a central mass plus the disk mass enclosed at each radius.
+struct ExponentialDiskSpec : GeneratorSpec {
+  double diskMass = 0.1;
+  double centralMu = 1.0;
+  double scaleLength = 1.0;
+  double scaleHeight = 0.05;
+  double outerRadius = 5.0; // truncation, in scale lengths
+  double velocityDispersion = 0.05; // fraction of the local circular speed
+};
+
+// Ring of test particles on Keplerian orbits about a host with gravitational parameter
+// `hostMu`, placed at `center` and moving with `velocity`. Eccentricities and inclinations are
+// Rayleigh distributed with the given scales.
+struct KeplerianRingSpec : GeneratorSpec {
+  double hostMu = 1.0;
+  double innerRadius = 1.5;
+  double outerRadius = 2.0;
+  double eccentricityScale = 0.01;
+  double inclinationScale = 0.005; // radians
+  double totalMass = 0.0;
+};
+
+// Fragments of a body that broke up at `center` while moving with `velocity`. Fragment masses
+// follow a truncated power law N(>m) ~ m^-massExponent, smaller fragments leave faster, and
+// directions are isotropic.
+struct DebrisCloudSpec : GeneratorSpec {
+  double parentMass = 1.0e-6;
+  double massRange = 1.0e4; // largest over smallest fragment mass
+  double massExponent = 0.8;
+  double deltaV = 0.05; // typical ejection speed of the largest fragment
+  double deltaVSpread = 0.4; // log-normal sigma
+  double velocityExponent = 0.25;
+};
+
+// Each generator appends `count` bodies to `out`, filling them in parallel. Body k draws its
+// random numbers from a Philox stream keyed by (seed, k), so the result is identical for any
+// thread count.
+void generatePlummer(const PlummerSpec &spec, BodyStorage &out, ThreadPool &pool);
+void generateKing(const KingSpec &spec, BodyStorage &out, ThreadPool &pool);
+void generateExponentialDisk(const ExponentialDiskSpec &spec, BodyStorage &out,
+                             ThreadPool &pool);
+void generateKeplerianRing(const KeplerianRingSpec &spec, BodyStorage &out, ThreadPool &pool);
+void generateDebrisCloud(const DebrisCloudSpec &spec, BodyStorage &out, ThreadPool &pool);
+
+} // namespace sim
@@ -0,0 +1,87 @@
+#include "Simulation/Kepler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+double stumpffC(double z) {
+  if (z > 1.0e-6) {
+    return (1.0 - std::cos(std::sqrt(z))) / z;
+  }
+  if (z < -1.0e-6) {
+    return (std::cosh(std::sqrt(-z)) - 1.0) / -z;
+  }
+  return (1.0 / 2.0) - (z / 24.0) + (z * z / 720.0);
+}
+
+double stumpffS(double z) {
+  if (z > 1.0e-6) {
+    const double sz = std::sqrt(z);
+    return (sz - std::sin(sz)) / (sz * sz * sz);
+  }
+  if (z < -1.0e-6) {
+    const double sz = std::sqrt(-z);
+    return (std::sinh(sz) - sz) / (sz * sz * sz);
+  }
+  return (1.0 / 6.0) - (z / 120.0) + (z * z / 5040.0);
+}
+
+OrbitState propagateKepler(const OrbitState &state, double dt, double mu) {
+  const glm::dvec3 &r0 = state.position;
+  const glm::dvec3 &v0 = state.velocity;
+  const double r0Norm = glm::length(r0);
+  const double sqrtMu = std::sqrt(mu);
+  const double vr0 = glm::dot(r0, v0) / r0Norm;
+  // Reciprocal of the semi-major axis; negative for hyperbolic orbits.
+  const double alpha = (2.0 / r0Norm) - (glm::dot(v0, v0) / mu);
+
+  // Solve the universal Kepler equation for chi with Newton's method.
+  double chi = sqrtMu * std::abs(alpha) * dt;
+  for (int i = 0; i < 50; ++i) {
+    const double chi2 = chi * chi;
+    const double z = alpha * chi2;
+    const double c = stumpffC(z);
+    const double s = stumpffS(z);
+    const double f = (r0Norm * vr0 / sqrtMu * chi2 * c) +
+                     ((1.0 - alpha * r0Norm) * chi2 * chi * s) + (r0Norm * chi) - (sqrtMu * dt);
+    const double df = (r0Norm * vr0 / sqrtMu * chi * (1.0 - alpha * chi2 * s)) +
+                      ((1.0 - alpha * r0Norm) * chi2 * c) + r0Norm;
+    const double step = f / df;
+    chi -= step;
+    if (std::abs(step) < 1.0e-12 * std::max(1.0, std::abs(chi))) {
+      break;
+    }
+  }
+
+  // Lagrange coefficients.
+  const double chi2 = chi * chi;
+  const double z = alpha * chi2;
+  const double c = stumpffC(z);
+  const double s = stumpffS(z);
+  const double f = 1.0 - (chi2 / r0Norm * c);
+  const double g = dt - (chi2 * chi / sqrtMu * s);
+
+  OrbitState result;
+  result.position = (f * r0) + (g * v0);
+  const double rNorm = glm::length(result.position);
+  const double fDot = sqrtMu / (rNorm * r0Norm) * ((alpha * chi2 * chi * s) - chi);
+  const double gDot = 1.0 - (chi2 / rNorm * c);
+  result.velocity = (fDot * r0) + (gDot * v0);
+  return result;
+}
+
+glm::dvec3 circularVelocity(const glm::dvec3 &position, double mu) {
+  const double r = glm::length(position);
+  if (r <= 0.0) {
+    return glm::dvec3(0.0);
+  }
+  // Direction of travel for counter-clockwise motion about SCENE_UP.
+  glm::dvec3 direction = glm::cross(SCENE_UP, position);
+  const double length = glm::length(direction);
+  if (length <= 0.0) {
+    return glm::dvec3(0.0);
+  }
+  return direction / length * std::sqrt(mu / r);
+}
+
+} // namespace sim
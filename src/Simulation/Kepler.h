@@ -0,0 +1,27 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace sim {
+
+// Scene "up" axis; the grid lies in the plane perpendicular to it and prograde motion is
+// counter-clockwise seen from +Y.
+constexpr glm::dvec3 SCENE_UP{0.0, 1.0, 0.0};
+
+struct OrbitState {
+  glm::dvec3 position{0.0};
+  glm::dvec3 velocity{0.0};
+};
+
+// Stumpff functions C(z) and S(z) used by the universal-variable formulation.
+double stumpffC(double z);
+double stumpffS(double z);
+
+// Two-body propagation of `state` by `dt` about a central body with gravitational parameter mu.
+// Valid for elliptic, parabolic and hyperbolic orbits.
+OrbitState propagateKepler(const OrbitState &state, double dt, double mu);
+
+// Velocity of a prograde circular orbit through `position` about the origin.
+glm::dvec3 circularVelocity(const glm::dvec3 &position, double mu);
+
+} // namespace sim
@@ -0,0 +1,166 @@
+#include "Simulation/Lambert.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include "Simulation/Kepler.h"
+
+namespace sim {
+
+namespace {
+
+constexpr int MAX_ITERATIONS = 35;
+constexpr double TOLERANCE = 1.0e-10;
+
+// Gauss hypergeometric 2F1(3, 1, 5/2, x), used by the time-of-flight equation near x = 1.
+double hypergeometricF(double x) {
+  if (x >= 1.0) {
+    return INFINITY;
+  }
+  double result = 1.0;
+  double term = 1.0;
+  for (int i = 0; i < 1000; ++i) {
+    term *= (3.0 + i) * (1.0 + i) / (2.5 + i) * x / (i + 1.0);
+    const double previous = result;
+    result += term;
+    if (result == previous) {
+      break;
+    }
+  }
+  return result;
+}
+
+double computeY(double x, double lambda) {
+  return std::sqrt(1.0 - (lambda * lambda * (1.0 - (x * x))));
+}
+
+double computePsi(double x, double y, double lambda) {
+  if (x >= -1.0 && x < 1.0) {
+    return std::acos((x * y) + (lambda * (1.0 - (x * x))));
+  }
+  if (x > 1.0) {
+    return std::asinh((y - (x * lambda)) * std::sqrt((x * x) - 1.0));
+  }
+  return 0.0;
+}
+
+// Non-dimensional time of flight as a function of x, minus the target T0.
+double timeOfFlightEquation(double x, double y, double t0, double lambda) {
+  double t;
+  if (x > std::sqrt(0.6) && x < std::sqrt(1.4)) {
+    // Battin's series avoids the cancellation around the parabolic case.
+    const double eta = y - (lambda * x);
+    const double s1 = (1.0 - lambda - (x * eta)) * 0.5;
+    const double q = 4.0 / 3.0 * hypergeometricF(s1);
+    t = ((eta * eta * eta * q) + (4.0 * lambda * eta)) * 0.5;
+  } else {
+    const double psi = computePsi(x, y, lambda);
+    const double oneMinusX2 = 1.0 - (x * x);
+    t = ((psi / std::sqrt(std::abs(oneMinusX2))) - x + (lambda * y)) / oneMinusX2;
+  }
+  return t - t0;
+}
+
+double initialGuess(double t, double lambda) {
+  const double t0 = std::acos(lambda) + (lambda * std::sqrt(1.0 - (lambda * lambda)));
+  const double t1 = 2.0 * (1.0 - (lambda * lambda * lambda)) / 3.0;
+  if (t >= t0) {
+    return std::pow(t0 / t, 2.0 / 3.0) - 1.0;
+  }
+  if (t < t1) {
+    return (2.5 * t1 / t * (t1 - t) / (1.0 - std::pow(lambda, 5.0))) + 1.0;
+  }
+  return std::exp(std::log(2.0) * std::log(t / t0) / std::log(t1 / t0)) - 1.0;
+}
+
+// Householder iteration (third order) on the time-of-flight equation.
+bool solveForX(double t0, double lambda, double &x) {
+  x = initialGuess(t0, lambda);
+  const double lambda2 = lambda * lambda;
+  const double lambda3 = lambda2 * lambda;
+  const double lambda5 = lambda3 * lambda2;
+  for (int i = 0; i < MAX_ITERATIONS; ++i) {
+    const double y = computeY(x, lambda);
+    const double f = timeOfFlightEquation(x, y, t0, lambda);
+    const double t = f + t0;
+    const double oneMinusX2 = 1.0 - (x * x);
+    const double d1 = ((3.0 * t * x) - 2.0 + (2.0 * lambda3 * x / y)) / oneMinusX2;
+    const double d2 =
+        ((3.0 * t) + (5.0 * x * d1) + (2.0 * (1.0 - lambda2) * lambda3 / (y * y * y))) /
+        oneMinusX2;
+    const double d3 = ((7.0 * x * d2) + (8.0 * d1) -
+                       (6.0 * (1.0 - lambda2) * lambda5 * x / std::pow(y, 5.0))) /
+                      oneMinusX2;
+    const double next = x - (f * ((d1 * d1) - (f * d2 / 2.0)) /
+                             ((d1 * ((d1 * d1) - (f * d2))) + (d3 * f * f / 6.0)));
+    if (!std::isfinite(next)) {
+      return false;
+    }
+    if (std::abs(next - x) < TOLERANCE) {
+      x = next;
+      return true;
+    }
+    x = next;
+  }
+  return false;
+}
+
+} // namespace
+
+LambertSolution solveLambert(const glm::dvec3 &r1, const glm::dvec3 &r2, double timeOfFlight,
+                             double mu, bool prograde) {
+  LambertSolution solution;
+  const double r1Norm = glm::length(r1);
+  const double r2Norm = glm::length(r2);
+  const glm::dvec3 chord = r2 - r1;
+  const double c = glm::length(chord);
+  if (timeOfFlight <= 0.0 || mu <= 0.0 || r1Norm <= 0.0 || r2Norm <= 0.0 || c <= 0.0) {
+    return solution;
+  }
+
+  const double s = (r1Norm + r2Norm + c) * 0.5;
+  const glm::dvec3 ir1 = r1 / r1Norm;
+  const glm::dvec3 ir2 = r2 / r2Norm;
+  glm::dvec3 ih = glm::cross(ir1, ir2);
+  const double ihNorm = glm::length(ih);
+  // Collinear endpoints leave the plane undefined; fall back to the scene plane.
+  ih = ihNorm > 1.0e-12 ? ih / ihNorm : SCENE_UP;
+
+  double lambda = std::sqrt(1.0 - std::min(1.0, c / s));
+  glm::dvec3 it1;
+  glm::dvec3 it2;
+  if (glm::dot(ih, SCENE_UP) < 0.0) {
+    lambda = -lambda;
+    it1 = glm::cross(ir1, ih);
+    it2 = glm::cross(ir2, ih);
+  } else {
+    it1 = glm::cross(ih, ir1);
+    it2 = glm::cross(ih, ir2);
+  }
+  if (!prograde) {
+    lambda = -lambda;
+    it1 = -it1;
+    it2 = -it2;
+  }
+
+  const double t = std::sqrt(2.0 * mu / (s * s * s)) * timeOfFlight;
+  double x = 0.0;
+  if (!solveForX(t, lambda, x)) {
+    return solution;
+  }
+  const double y = computeY(x, lambda);
+
+  const double gamma = std::sqrt(mu * s / 2.0);
+  const double rho = (r1Norm - r2Norm) / c;
+  const double sigma = std::sqrt(std::max(0.0, 1.0 - (rho * rho)));
+  const double radial1 = gamma * (((lambda * y) - x) - (rho * ((lambda * y) + x))) / r1Norm;
+  const double radial2 = -gamma * (((lambda * y) - x) + (rho * ((lambda * y) + x))) / r2Norm;
+  const double tangential1 = gamma * sigma * (y + (lambda * x)) / r1Norm;
+  const double tangential2 = gamma * sigma * (y + (lambda * x)) / r2Norm;
+
+  solution.departureVelocity = (radial1 * ir1) + (tangential1 * it1);
+  solution.arrivalVelocity = (radial2 * ir2) + (tangential2 * it2);
+  solution.converged = true;
+  return solution;
+}
+
+} // namespace sim
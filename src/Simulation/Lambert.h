@@ -0,0 +1,19 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace sim {
+
+struct LambertSolution {
+  glm::dvec3 departureVelocity{0.0};
+  glm::dvec3 arrivalVelocity{0.0};
+  bool converged = false;
+};
+
+// Zero-revolution solution of Lambert's problem with Izzo's algorithm (2015): the orbit about a
+// central body of gravitational parameter mu that goes from r1 to r2 in timeOfFlight. Prograde
+// transfers circle SCENE_UP counter-clockwise.
+LambertSolution solveLambert(const glm::dvec3 &r1, const glm::dvec3 &r2, double timeOfFlight,
+                             double mu, bool prograde = true);
+
+} // namespace sim
@@ -0,0 +1,243 @@
+#include "Simulation/OrbitalElements.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include "core/thread_pool.h"
+
+namespace sim {
+
+namespace {
+
+constexpr std::size_t GRAIN = 4096;
+
+// The element frame puts its pole on SCENE_UP: (X, Y, Z) = (x, -z, y).
+struct FrameVector {
+  double x, y, z;
+};
+
+inline FrameVector toElementFrame(double x, double y, double z) { return {x, -z, y}; }
+inline glm::dvec3 fromElementFrame(const FrameVector &v) { return {v.x, v.z, -v.y}; }
+
+struct Classical {
+  double a, e, inc, raan, argp, nu;
+  double p; // semi-latus rectum, well defined for parabolic orbits too
+};
+
+inline Classical classicalFromState(const FrameVector &r, const FrameVector &v, double mu) {
+  const double rNorm = std::sqrt((r.x * r.x) + (r.y * r.y) + (r.z * r.z));
+  const double v2 = (v.x * v.x) + (v.y * v.y) + (v.z * v.z);
+  const double rv = (r.x * v.x) + (r.y * v.y) + (r.z * v.z);
+
+  const double hx = (r.y * v.z) - (r.z * v.y);
+  const double hy = (r.z * v.x) - (r.x * v.z);
+  const double hz = (r.x * v.y) - (r.y * v.x);
+  const double hNorm = std::sqrt((hx * hx) + (hy * hy) + (hz * hz));
+
+  const double radial = (v2 - (mu / rNorm)) / mu;
+  const double ex = (radial * r.x) - (rv * v.x / mu);
+  const double ey = (radial * r.y) - (rv * v.y / mu);
+  const double ez = (radial * r.z) - (rv * v.z / mu);
+  const double e = std::sqrt((ex * ex) + (ey * ey) + (ez * ez));
+
+  // Node direction, falling back to +X for equatorial orbits.
+  const double nNorm = std::sqrt((hx * hx) + (hy * hy));
+  const bool equatorial = nNorm <= 1.0e-12 * hNorm;
+  const double nx = equatorial ? 1.0 : -hy / nNorm;
+  const double ny = equatorial ? 0.0 : hx / nNorm;
+
+  // Periapsis direction, falling back to the node for circular orbits.
+  const bool circular = e <= 1.0e-10;
+  const double px = circular ? nx : ex / e;
+  const double py = circular ? ny : ey / e;
+  const double pz = circular ? 0.0 : ez / e;
+
+  const double hxu = hx / hNorm;
+  const double hyu = hy / hNorm;
+  const double hzu = hz / hNorm;
+
+  Classical c;
+  c.e = e;
+  c.p = hNorm * hNorm / mu;
+  c.a = c.p / (1.0 - (e * e));
+  c.inc = std::acos(std::clamp(hzu, -1.0, 1.0));
+  c.raan = std::atan2(ny, nx);
+  // Angles from the node to periapsis and from periapsis to the body, both about h.
+  c.argp = std::atan2((hxu * (ny * pz)) - (hyu * (nx * pz)) + (hzu * ((nx * py) - (ny * px))),
+                      (nx * px) + (ny * py));
+  c.nu = std::atan2((hxu * ((py * r.z) - (pz * r.y))) + (hyu * ((pz * r.x) - (px * r.z))) +
+                        (hzu * ((px * r.y) - (py * r.x))),
+                    (px * r.x) + (py * r.y) + (pz * r.z));
+  return c;
+}
+
+inline void storeState(BodyStorage &out, std::size_t i, const FrameVector &r,
+                       const FrameVector &v) {
+  out.x[i] = r.x;
+  out.y[i] = r.z;
+  out.z[i] = -r.y;
+  out.vx[i] = v.x;
+  out.vy[i] = v.z;
+  out.vz[i] = -v.y;
+}
+
+void prepareState(std::size_t count, BodyStorage &out) {
+  if (out.size() != count) {
+    out.resize(count);
+  }
+}
+
+} // namespace
+
+void KeplerianElements::resize(std::size_t count) {
+  for (auto *element : {&semiMajorAxis, &eccentricity, &inclination, &ascendingNode,
+                        &argumentOfPeriapsis, &trueAnomaly}) {
+    element->resize(count);
+  }
+}
+
+void EquinoctialElements::resize(std::size_t count) {
+  for (auto *element : {&semiLatusRectum, &f, &g, &h, &k, &trueLongitude}) {
+    element->resize(count);
+  }
+}
+
+void stateToKeplerian(const BodyStorage &state, double mu, std::size_t begin, std::size_t end,
+                      KeplerianElements &out) {
+  for (std::size_t i = begin; i < end; ++i) {
+    const Classical c =
+        classicalFromState(toElementFrame(state.x[i], state.y[i], state.z[i]),
+                           toElementFrame(state.vx[i], state.vy[i], state.vz[i]), mu);
+    out.semiMajorAxis[i] = c.a;
+    out.eccentricity[i] = c.e;
+    out.inclination[i] = c.inc;
+    out.ascendingNode[i] = c.raan;
+    out.argumentOfPeriapsis[i] = c.argp;
+    out.trueAnomaly[i] = c.nu;
+  }
+}
+
+OrbitState keplerianToState(double semiMajorAxis, double eccentricity, double inclination,
+                            double ascendingNode, double argumentOfPeriapsis, double trueAnomaly,
+                            double mu) {
+  const double e = eccentricity;
+  const double p = semiMajorAxis * (1.0 - (e * e));
+  const double cosNu = std::cos(trueAnomaly);
+  const double sinNu = std::sin(trueAnomaly);
+  const double radius = p / (1.0 + (e * cosNu));
+  const double speed = std::sqrt(mu / p);
+
+  // Perifocal position and velocity.
+  const double rp = radius * cosNu;
+  const double rq = radius * sinNu;
+  const double vp = -speed * sinNu;
+  const double vq = speed * (e + cosNu);
+
+  const double cO = std::cos(ascendingNode);
+  const double sO = std::sin(ascendingNode);
+  const double cw = std::cos(argumentOfPeriapsis);
+  const double sw = std::sin(argumentOfPeriapsis);
+  const double ci = std::cos(inclination);
+  const double si = std::sin(inclination);
+
+  const double r11 = (cO * cw) - (sO * sw * ci);
+  const double r12 = -(cO * sw) - (sO * cw * ci);
+  const double r21 = (sO * cw) + (cO * sw * ci);
+  const double r22 = -(sO * sw) + (cO * cw * ci);
+  const double r31 = sw * si;
+  const double r32 = cw * si;
+
+  return {fromElementFrame({(r11 * rp) + (r12 * rq), (r21 * rp) + (r22 * rq),
+                            (r31 * rp) + (r32 * rq)}),
+          fromElementFrame({(r11 * vp) + (r12 * vq), (r21 * vp) + (r22 * vq),
+                            (r31 * vp) + (r32 * vq)})};
+}
+
+void keplerianToState(const KeplerianElements &elements, double mu, std::size_t begin,
+                      std::size_t end, BodyStorage &out) {
+  for (std::size_t i = begin; i < end; ++i) {
+    const OrbitState state = keplerianToState(
+        elements.semiMajorAxis[i], elements.eccentricity[i], elements.inclination[i],
+        elements.ascendingNode[i], elements.argumentOfPeriapsis[i], elements.trueAnomaly[i], mu);
+    out.setPosition(i, state.position);
+    out.setVelocity(i, state.velocity);
+  }
+}
+
+void stateToEquinoctial(const BodyStorage &state, double mu, std::size_t begin,
+                        std::size_t end, EquinoctialElements &out) {
+  for (std::size_t i = begin; i < end; ++i) {
+    const Classical c =
+        classicalFromState(toElementFrame(state.x[i], state.y[i], state.z[i]),
+                           toElementFrame(state.vx[i], state.vy[i], state.vz[i]), mu);
+    const double periapsisLongitude = c.raan + c.argp;
+    const double tanHalfInc = std::tan(c.inc * 0.5);
+    out.semiLatusRectum[i] = c.p;
+    out.f[i] = c.e * std::cos(periapsisLongitude);
+    out.g[i] = c.e * std::sin(periapsisLongitude);
+    out.h[i] = tanHalfInc * std::cos(c.raan);
+    out.k[i] = tanHalfInc * std::sin(c.raan);
+    out.trueLongitude[i] = std::remainder(periapsisLongitude + c.nu, 2.0 * std::numbers::pi);
+  }
+}
+
+void equinoctialToState(const EquinoctialElements &elements, double mu, std::size_t begin,
+                        std::size_t end, BodyStorage &out) {
+  for (std::size_t i = begin; i < end; ++i) {
+    const double p = elements.semiLatusRectum[i];
+    const double f = elements.f[i];
+    const double g = elements.g[i];
+    const double h = elements.h[i];
+    const double k = elements.k[i];
+    const double cosL = std::cos(elements.trueLongitude[i]);
+    const double sinL = std::sin(elements.trueLongitude[i]);
+
+    const double alpha2 = (h * h) - (k * k);
+    const double s2 = 1.0 + (h * h) + (k * k);
+    const double w = 1.0 + (f * cosL) + (g * sinL);
+    const double rOverS2 = p / w / s2;
+    const double hk = 2.0 * h * k;
+    const double speed = std::sqrt(mu / p) / s2;
+
+    storeState(out, i,
+               {rOverS2 * (cosL + (alpha2 * cosL) + (hk * sinL)),
+                rOverS2 * (sinL - (alpha2 * sinL) + (hk * cosL)),
+                rOverS2 * 2.0 * ((h * sinL) - (k * cosL))},
+               {-speed * (sinL + (alpha2 * sinL) - (hk * cosL) + g - (hk * f) + (alpha2 * g)),
+                -speed * (-cosL + (alpha2 * cosL) + (hk * sinL) - f + (hk * g) + (alpha2 * f)),
+                speed * 2.0 * ((h * cosL) + (k * sinL) + (f * h) + (g * k))});
+  }
+}
+
+void stateToKeplerian(const BodyStorage &state, double mu, KeplerianElements &out,
+                      ThreadPool &pool) {
+  out.resize(state.size());
+  pool.parallelFor(state.size(), GRAIN, [&](std::size_t begin, std::size_t end) {
+    stateToKeplerian(state, mu, begin, end, out);
+  });
+}
+
+void keplerianToState(const KeplerianElements &elements, double mu, BodyStorage &out,
+                      ThreadPool &pool) {
+  prepareState(elements.size(), out);
+  pool.parallelFor(elements.size(), GRAIN, [&](std::size_t begin, std::size_t end) {
+    keplerianToState(elements, mu, begin, end, out);
+  });
+}
+
+void stateToEquinoctial(const BodyStorage &state, double mu, EquinoctialElements &out,
+                        ThreadPool &pool) {
+  out.resize(state.size());
+  pool.parallelFor(state.size(), GRAIN, [&](std::size_t begin, std::size_t end) {
+    stateToEquinoctial(state, mu, begin, end, out);
+  });
+}
+
+void equinoctialToState(const EquinoctialElements &elements, double mu, BodyStorage &out,
+                        ThreadPool &pool) {
+  prepareState(elements.size(), out);
+  pool.parallelFor(elements.size(), GRAIN, [&](std::size_t begin, std::size_t end) {
+    equinoctialToState(elements, mu, begin, end, out);
+  });
+}
+
+} // namespace sim
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Simulation/BodyStorage.h"
+#include "Simulation/Kepler.h"
+
+class ThreadPool;
+
+namespace sim {
+
+// Classical elements, one array per element. Angles are in radians and measured in the scene's
+// reference frame: the pole is SCENE_UP and longitudes start at +X. Undefined angles are set
+// to zero (ascending node for equatorial orbits, argument of periapsis for circular ones) so
+// the remaining angles still sum to the true longitude.
+struct KeplerianElements {
+  std::vector<double> semiMajorAxis; // negative for hyperbolic orbits
+  std::vector<double> eccentricity;
+  std::vector<double> inclination;
+  std::vector<double> ascendingNode;
+  std::vector<double> argumentOfPeriapsis;
+  std::vector<double> trueAnomaly;
+
+  std::size_t size() const { return eccentricity.size(); }
+  void resize(std::size_t count);
+};
+
+// Modified equinoctial elements (Walker et al.), free of the circular and equatorial
+// singularities.
+struct EquinoctialElements {
+  std::vector<double> semiLatusRectum;
+  std::vector<double> f, g; // eccentricity vector
+  std::vector<double> h, k; // tan(i / 2) times the node direction
+  std::vector<double> trueLongitude;
+
+  std::size_t size() const { return f.size(); }
+  void resize(std::size_t count);
+};
+
+// Single-body conversion from classical elements, for generators that build orbits one at a time.
+OrbitState keplerianToState(double semiMajorAxis, double eccentricity, double inclination,
+                            double ascendingNode, double argumentOfPeriapsis, double trueAnomaly,
+                            double mu);
+
+// Single-range kernels. They are branch-free over [begin, end) so the compiler can vectorize
+// them; the batch versions below split the arrays across the pool.
+void stateToKeplerian(const BodyStorage &state, double mu, std::size_t begin, std::size_t end,
+                      KeplerianElements &out);
+void keplerianToState(const KeplerianElements &elements, double mu, std::size_t begin,
+                      std::size_t end, BodyStorage &out);
+void stateToEquinoctial(const BodyStorage &state, double mu, std::size_t begin,
+                        std::size_t end, EquinoctialElements &out);
+void equinoctialToState(const EquinoctialElements &elements, double mu, std::size_t begin,
+                        std::size_t end, BodyStorage &out);
+
+// Batch conversions over whole arrays. Outputs are resized to match; converting to state only
+// writes positions and velocities.
+void stateToKeplerian(const BodyStorage &state, double mu, KeplerianElements &out,
+                      ThreadPool &pool);
+void keplerianToState(const KeplerianElements &elements, double mu, BodyStorage &out,
+                      ThreadPool &pool);
+void stateToEquinoctial(const BodyStorage &state, double mu, EquinoctialElements &out,
+                        ThreadPool &pool);
+void equinoctialToState(const EquinoctialElements &elements, double mu, BodyStorage &out,
+                        ThreadPool &pool);
+
+} // namespace sim
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+
+namespace sim {
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel Random Numbers: As Easy as
+// 1, 2, 3"). Every output block is a pure function of (key, counter), so any thread can produce
+// any body's numbers without sharing state.
+inline std::array<std::uint32_t, 4> philox4x32(std::array<std::uint32_t, 4> counter,
+                                               std::array<std::uint32_t, 2> key) {
+  constexpr std::uint32_t MULTIPLIER_0 = 0xD2511F53U;
+  constexpr std::uint32_t MULTIPLIER_1 = 0xCD9E8D57U;
+  constexpr std::uint32_t WEYL_0 = 0x9E3779B9U;
+  constexpr std::uint32_t WEYL_1 = 0xBB67AE85U;
+
+  for (int round = 0; round < 10; ++round) {
+    const std::uint64_t product0 = static_cast<std::uint64_t>(MULTIPLIER_0) * counter[0];
+    const std::uint64_t product1 = static_cast<std::uint64_t>(MULTIPLIER_1) * counter[2];
+    counter = {static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+               static_cast<std::uint32_t>(product1),
+               static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+               static_cast<std::uint32_t>(product0)};
+    key[0] += WEYL_0;
+    key[1] += WEYL_1;
+  }
+  return counter;
+}
+
+// Random stream for one body. The counter holds (draw, stream, body), so the numbers a body
+// receives depend only on the seed and its index, never on how the work was split.
+class PhiloxStream {
+public:
+  PhiloxStream(std::uint64_t seed, std::uint64_t body, std::uint32_t stream = 0)
+      : key{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)},
+        counter{0U, stream, static_cast<std::uint32_t>(body),
+                static_cast<std::uint32_t>(body >> 32)} {}
+
+  std::uint32_t next() {
+    if (available == 0) {
+      block = philox4x32(counter, key);
+      ++counter[0];
+      available = 4;
+    }
+    return block[--available];
+  }
+
+  // Uniform double in the open interval (0, 1) with 53 random bits.
+  double uniform() {
+    const std::uint64_t high = next() >> 5;
+    const std::uint64_t low = next() >> 6;
+    return (static_cast<double>((high << 26) | low) + 0.5) * 0x1.0p-53;
+  }
+
+  double uniform(double low, double high) { return low + ((high - low) * uniform()); }
+
+  // Standard normal deviate (Box-Muller, always consuming two uniforms).
+  double normal() {
+    const double radius = std::sqrt(-2.0 * std::log(uniform()));
+    return radius * std::cos(2.0 * std::numbers::pi * uniform());
+  }
+
+private:
+  std::array<std::uint32_t, 2> key;
+  std::array<std::uint32_t, 4> counter;
+  std::array<std::uint32_t, 4> block{};
+  int available = 0;
+};
+
+} // namespace sim
@@ -0,0 +1,76 @@
+#include "Simulation/Porkchop.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "Simulation/Lambert.h"
+#include "core/thread_pool.h"
+
+namespace sim {
+
+namespace {
+double lerpStep(double start, double end, int steps, int step) {
+  return steps > 1 ? start + ((end - start) * step / (steps - 1)) : start;
+}
+} // namespace
+
+double porkchopDepartureTime(const PorkchopSpec &spec, int step) {
+  return lerpStep(spec.departureStart, spec.departureEnd, spec.departureSteps, step);
+}
+
+double porkchopFlightTime(const PorkchopSpec &spec, int step) {
+  return lerpStep(spec.flightTimeMin, spec.flightTimeMax, spec.flightTimeSteps, step);
+}
+
+PorkchopGrid computePorkchop(const OrbitState &origin, const OrbitState &target,
+                             const PorkchopSpec &spec, ThreadPool &pool) {
+  PorkchopGrid grid;
+  grid.departureSteps = std::max(spec.departureSteps, 1);
+  grid.flightTimeSteps = std::max(spec.flightTimeSteps, 1);
+  const auto cells = static_cast<std::size_t>(grid.departureSteps) * grid.flightTimeSteps;
+  grid.departureDeltaV.assign(cells, std::numeric_limits<float>::infinity());
+  grid.arrivalDeltaV.assign(cells, std::numeric_limits<float>::infinity());
+  grid.totalDeltaV.assign(cells, std::numeric_limits<float>::infinity());
+
+  // Ephemerides are shared by a whole column or row, so compute them once up front.
+  std::vector<OrbitState> departures(grid.departureSteps);
+  pool.parallelFor(departures.size(), 64, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t d = begin; d < end; ++d) {
+      departures[d] =
+          propagateKepler(origin, porkchopDepartureTime(spec, static_cast<int>(d)), spec.mu);
+    }
+  });
+
+  pool.parallelFor(grid.flightTimeSteps, 1, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t f = begin; f < end; ++f) {
+      const double flightTime = porkchopFlightTime(spec, static_cast<int>(f));
+      for (int d = 0; d < grid.departureSteps; ++d) {
+        const double arrivalTime = porkchopDepartureTime(spec, d) + flightTime;
+        const OrbitState arrival = propagateKepler(target, arrivalTime, spec.mu);
+        const LambertSolution transfer = solveLambert(departures[d].position, arrival.position,
+                                                      flightTime, spec.mu, spec.prograde);
+        if (!transfer.converged) {
+          continue;
+        }
+        const std::size_t cell = grid.index(d, static_cast<int>(f));
+        const auto launch =
+            static_cast<float>(glm::length(transfer.departureVelocity - departures[d].velocity));
+        const auto capture =
+            static_cast<float>(glm::length(arrival.velocity - transfer.arrivalVelocity));
+        grid.departureDeltaV[cell] = launch;
+        grid.arrivalDeltaV[cell] = capture;
+        grid.totalDeltaV[cell] = launch + capture;
+      }
+    }
+  });
+
+  const auto best = std::min_element(grid.totalDeltaV.begin(), grid.totalDeltaV.end());
+  if (std::isfinite(*best)) {
+    const auto cell = static_cast<int>(best - grid.totalDeltaV.begin());
+    grid.minTotalDeltaV = *best;
+    grid.bestDeparture = cell % grid.departureSteps;
+    grid.bestFlightTime = cell / grid.departureSteps;
+  }
+  return grid;
+}
+
+} // namespace sim
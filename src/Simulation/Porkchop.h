@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include "Simulation/Kepler.h"
+
+class ThreadPool;
+
+namespace sim {
+
+struct PorkchopSpec {
+  double mu = 1.0;
+  double departureStart = 0.0;
+  double departureEnd = 10.0;
+  int departureSteps = 200;
+  double flightTimeMin = 0.5;
+  double flightTimeMax = 10.0;
+  int flightTimeSteps = 200;
+  bool prograde = true;
+};
+
+// Delta-v over a departure-time x time-of-flight grid, stored row-major with one row per
+// time of flight. Cells whose Lambert solve failed hold +infinity.
+struct PorkchopGrid {
+  int departureSteps = 0;
+  int flightTimeSteps = 0;
+  std::vector<float> departureDeltaV;
+  std::vector<float> arrivalDeltaV;
+  std::vector<float> totalDeltaV;
+  float minTotalDeltaV = 0.0F;
+  int bestDeparture = -1;
+  int bestFlightTime = -1;
+
+  std::size_t index(int departure, int flightTime) const {
+    return (static_cast<std::size_t>(flightTime) * departureSteps) + departure;
+  }
+};
+
+double porkchopDepartureTime(const PorkchopSpec &spec, int step);
+double porkchopFlightTime(const PorkchopSpec &spec, int step);
+
+// Solves one Lambert problem per grid cell for a transfer from `origin` to `target`, both given
+// at t = 0 and propagated on two-body orbits about the central mass. Rows are split across the
+// pool.
+PorkchopGrid computePorkchop(const OrbitState &origin, const OrbitState &target,
+                             const PorkchopSpec &spec, ThreadPool &pool);
+
+} // namespace sim
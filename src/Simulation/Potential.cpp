@@ -0,0 +1,159 @@
+#include "Simulation/Potential.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include "core/thread_pool.h"
+
+namespace sim {
+
+namespace {
+
+constexpr std::size_t LEAF_BODIES = 8;
+constexpr int MAX_DEPTH = 32;
+
+struct Cell {
+  glm::dvec3 centerOfMass{0.0};
+  double mass = 0.0;
+  double size = 0.0;          // edge length
+  std::uint32_t first = 0;    // children, or bodies when a leaf
+  std::uint32_t count = 0;    // bodies in a leaf; 0 for inner cells
+  std::uint32_t children = 0; // number of children of an inner cell
+};
+
+// Point masses sorted so every cell's bodies are contiguous. Cells are stored breadth first, so
+// each inner cell's children are contiguous and always follow their parent.
+struct Octree {
+  std::vector<glm::dvec4> bodies; // position, mass
+  std::vector<Cell> cells;
+
+  void build(const glm::dvec3 &center, double half);
+};
+
+void Octree::build(const glm::dvec3 &center, double half) {
+  struct Pending {
+    std::uint32_t cell;
+    std::size_t begin, end;
+    glm::dvec3 center;
+    double half;
+    int depth;
+  };
+
+  cells.assign(1, Cell{});
+  std::vector<Pending> pending{{0, 0, bodies.size(), center, half, 0}};
+  for (std::size_t next = 0; next < pending.size(); ++next) {
+    const Pending task = pending[next];
+    cells[task.cell].size = 2.0 * task.half;
+    if (task.end - task.begin <= LEAF_BODIES || task.depth == MAX_DEPTH) {
+      cells[task.cell].first = static_cast<std::uint32_t>(task.begin);
+      cells[task.cell].count = static_cast<std::uint32_t>(task.end - task.begin);
+      continue;
+    }
+
+    // Split into octants by x, then y, then z; octant bit k is set above the center on axis k.
+    std::size_t bounds[9] = {task.begin};
+    bounds[8] = task.end;
+    for (int axis = 0, step = 8; axis < 3; ++axis, step /= 2) {
+      for (int octant = 0; octant < 8; octant += step) {
+        const auto first = bodies.begin() + static_cast<std::ptrdiff_t>(bounds[octant]);
+        const auto last = bodies.begin() + static_cast<std::ptrdiff_t>(bounds[octant + step]);
+        const auto split = std::partition(
+            first, last, [&](const glm::dvec4 &b) { return b[axis] < task.center[axis]; });
+        bounds[octant + (step / 2)] = static_cast<std::size_t>(split - bodies.begin());
+      }
+    }
+
+    const double quarter = 0.5 * task.half;
+    cells[task.cell].first = static_cast<std::uint32_t>(cells.size());
+    for (int octant = 0; octant < 8; ++octant) {
+      if (bounds[octant + 1] > bounds[octant]) {
+        const glm::dvec3 offset((octant & 4) != 0 ? quarter : -quarter,
+                                (octant & 2) != 0 ? quarter : -quarter,
+                                (octant & 1) != 0 ? quarter : -quarter);
+        pending.push_back({static_cast<std::uint32_t>(cells.size()), bounds[octant],
+                           bounds[octant + 1], task.center + offset, quarter, task.depth + 1});
+        cells.emplace_back();
+        ++cells[task.cell].children;
+      }
+    }
+  }
+
+  // Children follow their parents, so a reverse sweep sees every child before its parent.
+  for (auto cell = cells.rbegin(); cell != cells.rend(); ++cell) {
+    if (cell->children == 0) {
+      for (std::uint32_t i = cell->first; i < cell->first + cell->count; ++i) {
+        cell->mass += bodies[i].w;
+        cell->centerOfMass += glm::dvec3(bodies[i]) * bodies[i].w;
+      }
+    } else {
+      for (std::uint32_t c = cell->first; c < cell->first + cell->children; ++c) {
+        cell->mass += cells[c].mass;
+        cell->centerOfMass += cells[c].centerOfMass * cells[c].mass;
+      }
+    }
+    cell->centerOfMass /= cell->mass;
+  }
+}
+
+} // namespace
+
+void samplePotential(const BodyStorage &bodies, const PotentialGrid &grid,
+                     std::vector<float> &out, ThreadPool &pool) {
+  const auto resolution = static_cast<std::size_t>(std::max(grid.resolution, 2));
+  out.assign(resolution * resolution, 0.0F);
+
+  Octree tree;
+  glm::dvec3 low(std::numeric_limits<double>::infinity());
+  glm::dvec3 high(-std::numeric_limits<double>::infinity());
+  for (std::size_t i = 0; i < bodies.size(); ++i) {
+    if (bodies.mass[i] > 0.0) {
+      tree.bodies.emplace_back(bodies.x[i], bodies.y[i], bodies.z[i], bodies.mass[i]);
+      low = glm::min(low, bodies.position(i));
+      high = glm::max(high, bodies.position(i));
+    }
+  }
+  if (tree.bodies.empty()) {
+    return;
+  }
+  const glm::dvec3 extent = high - low;
+  const double half = std::max(0.5 * std::max({extent.x, extent.y, extent.z}), 1e-9) * 1.0001;
+  tree.build(0.5 * (low + high), half);
+
+  const double theta2 = grid.openingAngle * grid.openingAngle;
+  const double epsilon2 = grid.softening * grid.softening;
+  const double spacing = 2.0 * grid.halfExtent / static_cast<double>(resolution - 1);
+  const glm::dvec2 origin = grid.center - glm::dvec2(grid.halfExtent);
+
+  pool.parallelFor(resolution, 4, [&](std::size_t rowBegin, std::size_t rowEnd) {
+    std::vector<std::uint32_t> stack;
+    for (std::size_t row = rowBegin; row < rowEnd; ++row) {
+      for (std::size_t column = 0; column < resolution; ++column) {
+        const glm::dvec3 point(origin.x + (spacing * static_cast<double>(column)), 0.0,
+                               origin.y + (spacing * static_cast<double>(row)));
+        double potential = 0.0;
+        stack.assign(1, 0);
+        while (!stack.empty()) {
+          const Cell &cell = tree.cells[stack.back()];
+          stack.pop_back();
+          const glm::dvec3 offset = cell.centerOfMass - point;
+          const double distance2 = glm::dot(offset, offset);
+          if (cell.children > 0 && cell.size * cell.size < theta2 * distance2) {
+            potential -= cell.mass / std::sqrt(distance2 + epsilon2);
+          } else if (cell.children > 0) {
+            for (std::uint32_t c = 0; c < cell.children; ++c) {
+              stack.push_back(cell.first + c);
+            }
+          } else {
+            for (std::uint32_t i = cell.first; i < cell.first + cell.count; ++i) {
+              const glm::dvec3 d = glm::dvec3(tree.bodies[i]) - point;
+              potential -= tree.bodies[i].w / std::sqrt(glm::dot(d, d) + epsilon2);
+            }
+          }
+        }
+        out[(row * resolution) + column] = static_cast<float>(potential);
+      }
+    }
+  });
+}
+
+} // namespace sim
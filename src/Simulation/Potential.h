@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <vector>
+#include "Simulation/BodyStorage.h"
+
+class ThreadPool;
+
+namespace sim {
+
+// Square grid of sample points on the plane y = 0.
+struct PotentialGrid {
+  glm::dvec2 center{0.0}; // x and z of the grid's middle
+  double halfExtent = 50.0;
+  int resolution = 128;
+  double softening = 0.05;
+  // Barnes-Hut opening angle: a cell narrower than this fraction of its distance to the
+  // sample point is replaced by its monopole. Zero sums every body exactly.
+  double openingAngle = 0.5;
+};
+
+// Gravitational potential -sum(m / sqrt(r^2 + softening^2)) of `bodies` (G = 1) at every grid
+// point, written row-major with z as the row and x as the column. Points are spaced so the
+// first and last rows and columns lie on the grid's edges. Bodies are grouped in a Barnes-Hut
+// octree and the rows are evaluated in parallel. Massless bodies are ignored.
+void samplePotential(const BodyStorage &bodies, const PotentialGrid &grid,
+                     std::vector<float> &out, ThreadPool &pool);
+
+} // namespace sim
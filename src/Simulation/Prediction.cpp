@@ -0,0 +1,134 @@
+#include "Simulation/Prediction.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <utility>
+#include "Simulation/Kepler.h"
+#include "core/thread_pool.h"
+
+namespace sim {
+
+namespace {
+
+// Bodies per chunk. Small enough that a superseded run, or a frame sharing the pool, never
+// waits long on one.
+constexpr std::size_t PREDICTION_GRAIN = 64;
+
+double predictionHorizon(const OrbitState &state, double mu, double maxHorizon) {
+  const double alpha = (2.0 / glm::length(state.position)) -
+                       (glm::dot(state.velocity, state.velocity) / mu);
+  if (alpha <= 0.0) {
+    return maxHorizon;
+  }
+  const double period = 2.0 * std::numbers::pi * std::sqrt(1.0 / (alpha * alpha * alpha * mu));
+  return std::min(period, maxHorizon);
+}
+
+bool isReady(const std::future<void> &future) {
+  return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+} // namespace
+
+TrajectoryPredictor::~TrajectoryPredictor() {
+  // Stop every run early and wait for them here, while the publish state is still alive.
+  ++generation;
+  for (auto &future : retired) {
+    future.wait();
+  }
+  if (pending.valid()) {
+    pending.wait();
+  }
+}
+
+void TrajectoryPredictor::request(BodyStorage bodies, double mu,
+                                  const PredictionSettings &settings) {
+  const std::uint64_t current = ++generation;
+  if (pending.valid()) {
+    retired.push_back(std::move(pending));
+  }
+  pending = std::async(std::launch::async, [this, bodies = std::move(bodies), mu, settings,
+                                            current] { run(bodies, mu, settings, current); });
+}
+
+void TrajectoryPredictor::cancel() {
+  const std::uint64_t current = ++generation;
+  if (pending.valid()) {
+    retired.push_back(std::move(pending));
+  }
+  publish({current, 0, {}});
+}
+
+bool TrajectoryPredictor::takeLatest(PredictedPaths &out) {
+  std::erase_if(retired, [](const std::future<void> &future) { return isReady(future); });
+  if (pending.valid() && isReady(pending)) {
+    pending.get();
+  }
+
+  std::lock_guard lock(publishMutex);
+  if (!hasLatest) {
+    return false;
+  }
+  out = std::move(latest);
+  hasLatest = false;
+  return true;
+}
+
+bool TrajectoryPredictor::isBusy() const {
+  // The run publishes its last pass before it returns, so a finished run may still have one
+  std::lock_guard lock(publishMutex);
+  return (pending.valid() && !isReady(pending)) || hasLatest;
+}
+
+void TrajectoryPredictor::publish(PredictedPaths paths) {
+  std::lock_guard lock(publishMutex);
+  // A newer request may have started while this pass was being computed.
+  if (paths.generation != generation.load()) {
+    return;
+  }
+  latest = std::move(paths);
+  hasLatest = true;
+}
+
+void TrajectoryPredictor::run(const BodyStorage &bodies, double mu,
+                              const PredictionSettings &settings, std::uint64_t current) {
+  const std::size_t count = bodies.size();
+  const std::size_t fine = std::max<std::size_t>(settings.fineSamples, 2);
+  std::size_t samples = std::clamp<std::size_t>(settings.coarseSamples, 2, fine);
+
+  std::vector<double> horizons(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    horizons[i] =
+        predictionHorizon({bodies.position(i), bodies.velocity(i)}, mu, settings.maxHorizon);
+  }
+
+  while (true) {
+    PredictedPaths paths{current, samples, std::vector<glm::vec3>(count * samples)};
+    getThreadPool().parallelFor(count, PREDICTION_GRAIN, [&](std::size_t begin, std::size_t end) {
+      if (generation.load(std::memory_order_relaxed) != current) {
+        return;
+      }
+      for (std::size_t i = begin; i < end; ++i) {
+        const OrbitState initial{bodies.position(i), bodies.velocity(i)};
+        const double step = horizons[i] / static_cast<double>(samples - 1);
+        glm::vec3 *path = &paths.points[i * samples];
+        path[0] = initial.position;
+        for (std::size_t k = 1; k < samples; ++k) {
+          path[k] = propagateKepler(initial, step * static_cast<double>(k), mu).position;
+        }
+      }
+    });
+    if (generation.load() != current) {
+      return;
+    }
+    publish(std::move(paths));
+
+    if (samples == fine) {
+      return;
+    }
+    samples = std::min(samples * 4, fine);
+  }
+}
+
+} // namespace sim
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <glm/glm.hpp>
+#include <mutex>
+#include <vector>
+#include "Simulation/BodyStorage.h"
+
+namespace sim {
+
+struct PredictionSettings {
+  // Bound orbits are predicted for one period, capped at this; unbound ones for exactly this.
+  double maxHorizon = 20.0;
+  // Samples per body of the first published pass. Each later pass has four times as many,
+  // up to fineSamples.
+  std::size_t coarseSamples = 16;
+  std::size_t fineSamples = 256;
+
+  bool operator==(const PredictionSettings &) const = default;
+};
+
+// Future positions of a snapshot of bodies, body-major: body i owns points
+// [i * samplesPerBody, (i + 1) * samplesPerBody), evenly spaced in time from its current state.
+struct PredictedPaths {
+  std::uint64_t generation = 0;
+  std::size_t samplesPerBody = 0;
+  std::vector<glm::vec3> points;
+
+  std::size_t getBodyCount() const {
+    return samplesPerBody == 0 ? 0 : points.size() / samplesPerBody;
+  }
+};
+
+// Propagates a private copy of the bodies on a background thread and publishes the paths
+// pass by pass, coarse first. A new request abandons the one in flight at its next chunk
+// without waiting for it, so neither requesting nor polling ever blocks the caller.
+class TrajectoryPredictor {
+public:
+  TrajectoryPredictor() = default;
+  ~TrajectoryPredictor();
+
+  TrajectoryPredictor(const TrajectoryPredictor &) = delete;
+  TrajectoryPredictor &operator=(const TrajectoryPredictor &) = delete;
+
+  // Starts predicting `bodies` about a central mass `mu`, superseding any earlier request.
+  void request(BodyStorage bodies, double mu, const PredictionSettings &settings);
+  // Drops the current prediction; takeLatest() then reports empty paths.
+  void cancel();
+
+  // Moves the newest pass published since the last call into `out`; false if there is none.
+  bool takeLatest(PredictedPaths &out);
+  // True until takeLatest() has returned the last pass of the current request
+  bool isBusy() const;
+
+private:
+  void run(const BodyStorage &bodies, double mu, const PredictionSettings &settings,
+           std::uint64_t generation);
+  void publish(PredictedPaths paths);
+
+  std::atomic<std::uint64_t> generation{0};
+  std::future<void> pending;
+  // Superseded runs, kept until they notice and return so their futures never block.
+  std::vector<std::future<void>> retired;
+
+  mutable std::mutex publishMutex;
+  PredictedPaths latest;
+  bool hasLatest = false;
+};
+
+} // namespace sim
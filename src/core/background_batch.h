@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <vector>
+#include "thread_pool.h"
+
+// Streams work off the render thread in bounded batches. Each frame the streamer requests what
+// it found missing, collects the batch that finished since the last frame and dispatches the
+// next one, which runs on the thread pool. Neither call ever waits. Items and results belong
+// to the batch while it runs, so the batch finishes before they are destroyed.
+template <typename Item, typename Result> class BackgroundBatch {
+public:
+  BackgroundBatch() = default;
+  ~BackgroundBatch() { wait(); }
+
+  BackgroundBatch(const BackgroundBatch &) = delete;
+  BackgroundBatch &operator=(const BackgroundBatch &) = delete;
+
+  // Requests are made afresh each frame, so the ones not dispatched are dropped here.
+  void clearRequests() { requests.clear(); }
+
+  // Queues `item` unless same(other) holds for an item already queued or in the running batch.
+  template <typename Same> void request(const Item &item, Same same) {
+    if (std::any_of(requests.begin(), requests.end(), same) ||
+        std::any_of(working.begin(), working.end(), same)) {
+      return;
+    }
+    requests.push_back(item);
+  }
+
+  // Calls take(item, result) for each item of a finished batch. False if none has finished.
+  template <typename Take> bool collect(Take take) {
+    if (!pending.valid() ||
+        pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      return false;
+    }
+    pending.get();
+    for (std::size_t k = 0; k < working.size(); ++k) {
+      take(working[k], results[k]);
+    }
+    working.clear();
+    return true;
+  }
+
+  // Unless a batch is running, starts one on the requests with the lowest priority(item), in
+  // the order requested otherwise, until the cost(item) of the batch reaches `budget`. At
+  // least one item goes however costly. work(item, result) runs for each on the thread pool.
+  template <typename Priority, typename Cost, typename Work>
+  void dispatch(Priority priority, Cost cost, std::size_t budget, Work work) {
+    if (pending.valid() || requests.empty()) {
+      return;
+    }
+
+    std::stable_sort(requests.begin(), requests.end(), [&](const Item &a, const Item &b) {
+      return priority(a) < priority(b);
+    });
+    std::size_t spent = 0;
+    std::size_t count = 0;
+    while (count < requests.size() && (count == 0 || spent < budget)) {
+      spent += cost(requests[count]);
+      ++count;
+    }
+    working.assign(requests.begin(), requests.begin() + static_cast<std::ptrdiff_t>(count));
+    requests.erase(requests.begin(), requests.begin() + static_cast<std::ptrdiff_t>(count));
+    results.resize(count);
+
+    pending = std::async(std::launch::async, [this, work] {
+      getThreadPool().parallelFor(working.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t k = begin; k < end; ++k) {
+          work(working[k], results[k]);
+        }
+      });
+    });
+  }
+
+  // Waits for the running batch and drops it along with every request.
+  void reset() {
+    wait();
+    pending = {};
+    working.clear();
+    requests.clear();
+  }
+
+  std::size_t getPendingCount() const { return requests.size() + working.size(); }
+
+private:
+  void wait() {
+    if (pending.valid()) {
+      pending.wait();
+    }
+  }
+
+  std::vector<Item> requests;
+  std::vector<Item> working;
+  std::vector<Result> results;
+  std::future<void> pending;
+};
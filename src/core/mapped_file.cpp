@@ -0,0 +1,52 @@
+#include "mapped_file.h"
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string &path) {
+  const int descriptor = open(path.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    throw std::runtime_error("Cannot open " + path);
+  }
+  struct stat info {};
+  if (fstat(descriptor, &info) != 0 || info.st_size <= 0) {
+    close(descriptor);
+    throw std::runtime_error("Cannot read " + path);
+  }
+
+  length = static_cast<std::size_t>(info.st_size);
+  void *mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+  // The mapping holds its own reference to the file
+  close(descriptor);
+  if (mapped == MAP_FAILED) {
+    throw std::runtime_error("Cannot map " + path);
+  }
+  bytes = static_cast<const std::uint8_t *>(mapped);
+}
+
+MappedFile::~MappedFile() { munmap(const_cast<std::uint8_t *>(bytes), length); }
+
+void writeFileReplacing(const std::string &path,
+                        const std::function<void(std::ofstream &out)> &writer) {
+  const std::string temporary = path + ".tmp";
+  try {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      throw std::runtime_error("Cannot write " + path);
+    }
+    writer(out);
+    out.close();
+    if (!out) {
+      throw std::runtime_error("Failed writing " + path);
+    }
+    std::filesystem::rename(temporary, path);
+  } catch (...) {
+    std::error_code ignored;
+    std::filesystem::remove(temporary, ignored);
+    throw;
+  }
+}
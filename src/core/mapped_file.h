@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+
+// Read-only memory mapping of a whole file. Pages are read from disk the first time they are
+// touched, so opening a large file costs nothing up front.
+class MappedFile {
+public:
+  // Throws std::runtime_error if the file cannot be opened or mapped.
+  explicit MappedFile(const std::string &path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const std::uint8_t *data() const { return bytes; }
+  std::size_t size() const { return length; }
+
+private:
+  const std::uint8_t *bytes = nullptr;
+  std::size_t length = 0;
+};
+
+// Writes `path` through writer(out) into a temporary file beside it, which is renamed over it
+// once complete. A MappedFile of the old file keeps reading that rather than a file truncated
+// under it, and if anything throws the old file is left untouched. Throws std::runtime_error if
+// the file cannot be written.
+void writeFileReplacing(const std::string &path,
+                        const std::function<void(std::ofstream &out)> &writer);
@@ -0,0 +1,49 @@
+#include "page_pool.h"
+#include <functional>
+
+std::size_t PageKeyHash::operator()(const PageKey &key) const {
+  const std::uint64_t source = static_cast<std::uint64_t>(key.source) * 0x9E3779B97F4A7C15ULL;
+  return std::hash<std::uint64_t>{}(key.item ^ source);
+}
+
+PagePool::PagePool(int pageCount) : pages(static_cast<std::size_t>(pageCount)) {
+  for (int page = pageCount - 1; page >= 0; --page) {
+    freePages.push_back(page);
+  }
+}
+
+int PagePool::find(const PageKey &key) {
+  const auto it = resident.find(key);
+  if (it == resident.end()) {
+    return -1;
+  }
+  pages[static_cast<std::size_t>(it->second)].lastUsed = frame;
+  return it->second;
+}
+
+int PagePool::acquire(const PageKey &key, bool pinned) {
+  int index = -1;
+  if (!freePages.empty()) {
+    index = freePages.back();
+    freePages.pop_back();
+  } else {
+    const auto before = [](const Page &a, const Page &b) {
+      return a.pinned != b.pinned ? b.pinned : a.lastUsed < b.lastUsed;
+    };
+    for (int i = 0; i < static_cast<int>(pages.size()); ++i) {
+      const Page &page = pages[static_cast<std::size_t>(i)];
+      if (page.lastUsed < frame &&
+          (index < 0 || before(page, pages[static_cast<std::size_t>(index)]))) {
+        index = i;
+      }
+    }
+    if (index < 0) {
+      return -1;
+    }
+    resident.erase(pages[static_cast<std::size_t>(index)].key);
+  }
+
+  pages[static_cast<std::size_t>(index)] = {key, frame, pinned};
+  resident.emplace(key, index);
+  return index;
+}
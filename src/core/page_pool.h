@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Identifies what a page holds: an item of one source, such as a chunk of one body's terrain
+struct PageKey {
+  std::uint32_t source = 0;
+  std::uint64_t item = 0;
+
+  bool operator==(const PageKey &) const = default;
+};
+
+struct PageKeyHash {
+  std::size_t operator()(const PageKey &key) const;
+};
+
+// Bookkeeping for a fixed number of pages of GPU memory, such as slots of a vertex buffer or
+// cells of an atlas. Pages are recycled least recently used first, and never once used in the
+// current frame. Pinned pages go only when no other page can.
+class PagePool {
+public:
+  explicit PagePool(int pageCount);
+
+  PagePool(const PagePool &) = delete;
+  PagePool &operator=(const PagePool &) = delete;
+
+  // Starts a frame; pages used from here on are kept through it.
+  void beginFrame() { ++frame; }
+
+  // The page holding `key`, marked as used this frame, or -1 if it is not resident.
+  int find(const PageKey &key);
+  bool contains(const PageKey &key) const { return resident.contains(key); }
+
+  // A page for `key`, which must not be resident: a free one, or else the least recently used,
+  // whose key is evicted. -1 when every page has been used this frame.
+  int acquire(const PageKey &key, bool pinned = false);
+
+  std::size_t getResidentCount() const { return resident.size(); }
+
+private:
+  struct Page {
+    PageKey key;
+    std::uint64_t lastUsed = 0;
+    bool pinned = false;
+  };
+
+  std::vector<Page> pages;
+  std::vector<int> freePages;
+  std::unordered_map<PageKey, int, PageKeyHash> resident;
+  std::uint64_t frame = 0;
+};
@@ -0,0 +1,96 @@
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(unsigned int threadCount) {
+  threadCount = std::max(threadCount, 1U);
+  workers.reserve(threadCount);
+  for (unsigned int i = 0; i < threadCount; ++i) {
+    workers.emplace_back([this] { workerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard lock(mutex);
+    stopping = true;
+  }
+  condition.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+  {
+    std::lock_guard lock(mutex);
+    tasks.push_back(std::move(task));
+  }
+  condition.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock lock(mutex);
+      condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+      if (stopping && tasks.empty()) {
+        return;
+      }
+      task = std::move(tasks.front());
+      tasks.pop_front();
+    }
+    task();
+  }
+}
+
+void ThreadPool::parallelFor(std::size_t count, std::size_t grain,
+                             const std::function<void(std::size_t, std::size_t)> &fn) {
+  if (count == 0) {
+    return;
+  }
+  grain = std::max<std::size_t>(grain, 1);
+  const std::size_t chunkCount = (count + grain - 1) / grain;
+  if (chunkCount == 1) {
+    fn(0, count);
+    return;
+  }
+
+  // Chunks are claimed through a shared counter. Helpers that start after every chunk has been
+  // claimed only touch the shared state, which is why it outlives this call.
+  struct Job {
+    std::atomic<std::size_t> nextChunk{0};
+    std::atomic<std::size_t> finishedChunks{0};
+    std::mutex doneMutex;
+    std::condition_variable done;
+  };
+  const auto job = std::make_shared<Job>();
+
+  const auto runChunks = [job, chunkCount, count, grain, &fn] {
+    std::size_t chunk;
+    while ((chunk = job->nextChunk.fetch_add(1)) < chunkCount) {
+      const std::size_t begin = chunk * grain;
+      fn(begin, std::min(begin + grain, count));
+      if (job->finishedChunks.fetch_add(1) + 1 == chunkCount) {
+        std::lock_guard lock(job->doneMutex);
+        job->done.notify_all();
+      }
+    }
+  };
+
+  const std::size_t helpers = std::min<std::size_t>(workers.size(), chunkCount - 1);
+  for (std::size_t i = 0; i < helpers; ++i) {
+    enqueue(runChunks);
+  }
+  runChunks();
+
+  std::unique_lock lock(job->doneMutex);
+  job->done.wait(lock, [&job, chunkCount] { return job->finishedChunks.load() == chunkCount; });
+}
+
+ThreadPool &getThreadPool() {
+  static ThreadPool pool;
+  return pool;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size worker pool shared by the simulation and analysis passes.
+class ThreadPool {
+public:
+  explicit ThreadPool(unsigned int threadCount = std::thread::hardware_concurrency());
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool(ThreadPool &&) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  ThreadPool &operator=(ThreadPool &&) = delete;
+
+  // Queues a fire-and-forget task.
+  void enqueue(std::function<void()> task);
+
+  // Splits [0, count) into chunks of at least `grain` items and runs fn(begin, end) on each.
+  // The calling thread takes part in the work and the call returns once every chunk is done,
+  // so it is safe to call from inside a pool task.
+  void parallelFor(std::size_t count, std::size_t grain,
+                   const std::function<void(std::size_t, std::size_t)> &fn);
+
+  unsigned int getThreadCount() const { return static_cast<unsigned int>(workers.size()); }
+
+private:
+  void workerLoop();
+
+  std::vector<std::thread> workers;
+  std::deque<std::function<void()>> tasks;
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool stopping = false;
+};
+
+// Process-wide pool, created on first use.
+ThreadPool &getThreadPool();
@@ -44,12 +44,21 @@ void Window::pollEvents() {
   SDL_Event event;
   while (SDL_PollEvent(&event)) {
     ImGui_ImplSDL3_ProcessEvent(&event);
+    handleEvent(event);
     if (event.type == SDL_EVENT_QUIT) {
       setState(false);
     }
   }
 }
 
+void Window::handleEvent(const SDL_Event &event) {
+  // In window coordinates, like the size the window was created with
+  if (event.type == SDL_EVENT_WINDOW_RESIZED && event.window.windowID == SDL_GetWindowID(window)) {
+    width = event.window.data1;
+    height = event.window.data2;
+  }
+}
+
 SDL_Window *Window::getSDLWindow() const { return window; }
 
 SDL_GLContext Window::getGLContext() const { return glContext; }
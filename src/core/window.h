@@ -15,6 +15,8 @@ public:
   bool shouldClose() const;
 
   void pollEvents();
+  // Keeps the size current; call with every event the application polls itself
+  void handleEvent(const SDL_Event &event);
   SDL_Window *getSDLWindow() const;
   SDL_GLContext getGLContext() const;
 
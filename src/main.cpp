@@ -1,4 +1,5 @@
 #include <glad/glad.h>
+#include <algorithm>
 #include <backends/imgui_impl_opengl3.h>
 #include <backends/imgui_impl_sdl3.h>
 #include <glm/glm.hpp>
@@ -60,20 +61,40 @@ int main() {
                  1.0F);
     glEnable(GL_DEPTH_TEST);
 
-    renderer.init();
     FpsCounter fpsCounter;
 
+    // Frames drawn after the last input, so ImGui can settle hover and focus changes, and how
+    // often an idle loop wakes anyway for anything that changes without an event
+    constexpr int INPUT_SETTLE_FRAMES = 3;
+    constexpr Sint32 IDLE_WAKE_MS = 1000;
+    int inputFrames = INPUT_SETTLE_FRAMES;
+    bool redrawRequested = false;
+
+    const auto handleEvent = [&](const SDL_Event &event) {
+      ImGui_ImplSDL3_ProcessEvent(&event);
+      window.handleEvent(event);
+      if (event.type == SDL_EVENT_QUIT) {
+        window.close();
+      }
+      if (event.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED) {
+        window.close();
+      }
+      inputFrames = INPUT_SETTLE_FRAMES;
+    };
+
     window.setStateRunning();
     while (window.getState()) {
+      gui::Scene &scene = gui::getScene();
+
+      // With nothing to draw, sleep until an event arrives instead of spinning on vsync
       SDL_Event event;
+      const bool idle = settings.renderOnDemand && inputFrames == 0 && !redrawRequested &&
+                        !renderer.needsRender(scene);
+      if (idle && SDL_WaitEventTimeout(&event, IDLE_WAKE_MS)) {
+        handleEvent(event);
+      }
       while (SDL_PollEvent(&event)) {
-        ImGui_ImplSDL3_ProcessEvent(&event);
-        if (event.type == SDL_EVENT_QUIT) {
-          window.close();
-        }
-        if (event.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED) {
-          window.close();
-        }
+        handleEvent(event);
       }
 
       ImGui_ImplOpenGL3_NewFrame();
@@ -85,20 +106,29 @@ int main() {
 
       // Render GUI
       gui::RenderGui(fpsCounter, sphere, cubeSphere, renderer);
+      redrawRequested = gui::TakeRedrawRequest();
 
       // Render scene
       glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-      // Render main scene objects
-      const gui::Scene &scene = gui::getScene();
-      renderer.render(scene);
+      // Propagate reference frames, then render main scene objects. Input can edit objects in
+      // ways only drawing shows, so frames with input always draw; the rest reuse the last
+      // scene when nothing in it changed.
+      scene.updateFrames();
+      if (!settings.renderOnDemand || inputFrames > 0 || renderer.needsRender(scene)) {
+        renderer.render(scene);
+      } else {
+        renderer.present();
+      }
 
       ImGui::Render();
       ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
       window.swapBuffers();
+      inputFrames = std::max(inputFrames - 1, 0);
     }
 
+    gui::Shutdown();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL3_Shutdown();
     ImGui::DestroyContext();
@@ -106,6 +136,7 @@ int main() {
     return 0;
   } catch (const std::exception &e) {
     std::cerr << "Error: " << e.what() << std::endl;
+    gui::Shutdown();
     return -1;
   }
 }